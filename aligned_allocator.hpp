@@ -0,0 +1,98 @@
+#ifndef OMEGA_ALIGNED_ALLOCATOR_HPP
+#define OMEGA_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace omega
+{
+    // Allocator whose blocks start on an Align boundary (at least alignof(T)),
+    // for example 64 for AVX-512 loads or to keep a buffer off its
+    // neighbours' cache lines. omega::vector picks the alignment up through
+    // allocator_alignment and passes it on to the compiler in data().
+    template<typename T, size_t Align = 64>
+    class aligned_allocator
+    {
+        static_assert(Align && (Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+        template<typename U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Align>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template<typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            // posix_memalign wants a multiple of sizeof(void*)
+            const size_t align = alignment < sizeof(void*) ? sizeof(void*) : alignment;
+#if defined(_WIN32)
+            void* memory = _aligned_malloc(count * sizeof(T), align);
+            if (!memory)
+            {
+                throw std::bad_alloc{};
+            }
+#else
+            void* memory = nullptr;
+            if (posix_memalign(&memory, align, count * sizeof(T)) != 0)
+            {
+                throw std::bad_alloc{};
+            }
+#endif
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* p, size_type) noexcept
+        {
+#if defined(_WIN32)
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+    };
+
+    template<typename T, size_t Align>
+    constexpr size_t aligned_allocator<T, Align>::alignment;
+
+    template<typename T, typename U, size_t Align>
+    bool operator == (const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Align>
+    bool operator != (const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //OMEGA_ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,242 @@
+#ifndef OMEGA_ARENA_ALLOCATOR_HPP
+#define OMEGA_ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace omega
+{
+    // Monotonic memory for request-scoped work. Blocks are cut from the top
+    // of the current chunk and are only given back all at once by reset()
+    // or the destructor. When a chunk is full the next one is twice as big,
+    // up to MAX_CHUNK, so a request makes few calls to operator new.
+    //
+    // The block at the top of the current chunk can grow in place with
+    // try_expand, which is how a vector that is the last thing allocated
+    // grows without copying. Not thread safe; use one arena per thread or
+    // per request.
+    class monotonic_arena
+    {
+        struct chunk
+        {
+            chunk* next;
+            size_t size;
+        };
+
+        static constexpr size_t HEADER = (sizeof(chunk) + alignof(std::max_align_t) - 1)
+                                         & ~(alignof(std::max_align_t) - 1);
+
+    public:
+        static constexpr size_t DEFAULT_CHUNK = size_t{ 1 } << 16;
+        static constexpr size_t MAX_CHUNK = size_t{ 1 } << 26;
+
+        explicit monotonic_arena(size_t first_chunk = DEFAULT_CHUNK) noexcept
+            : m_next_size{ first_chunk > HEADER ? first_chunk : DEFAULT_CHUNK }
+        {
+        }
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator = (const monotonic_arena&) = delete;
+
+        ~monotonic_arena()
+        {
+            release(nullptr);
+        }
+
+        // align must be a power of two
+        void* allocate(size_t bytes, size_t align)
+        {
+            auto first = align_up(m_top, align);
+            if (!first || first > m_end || bytes > static_cast<size_t>(m_end - first))
+            {
+                add_chunk(bytes, align);
+                first = align_up(m_top, align);
+            }
+
+            m_top = first + bytes;
+            m_used += bytes;
+            return first;
+        }
+
+        // Grows the block [p, p + old_bytes) to new_bytes when it is the last
+        // block handed out and the chunk has room
+        bool try_expand(void* p, size_t old_bytes, size_t new_bytes) noexcept
+        {
+            const auto first = static_cast<char*>(p);
+            if (!first || first + old_bytes != m_top || new_bytes < old_bytes
+                || new_bytes - old_bytes > static_cast<size_t>(m_end - m_top))
+            {
+                return false;
+            }
+
+            m_top = first + new_bytes;
+            m_used += new_bytes - old_bytes;
+            return true;
+        }
+
+        // Invalidates every block. The largest chunk is kept for the next
+        // request and the others are freed.
+        void reset() noexcept
+        {
+            auto largest = m_chunks;
+            for (auto c = m_chunks; c; c = c->next)
+            {
+                largest = c->size > largest->size ? c : largest;
+            }
+
+            release(largest);
+            if (largest)
+            {
+                largest->next = nullptr;
+                m_chunks = largest;
+                m_top = reinterpret_cast<char*>(largest) + HEADER;
+                m_end = reinterpret_cast<char*>(largest) + largest->size;
+                m_reserved = largest->size;
+            }
+            m_used = 0;
+        }
+
+        // Bytes handed out since the last reset
+        size_t bytes_used() const noexcept
+        {
+            return m_used;
+        }
+
+        // Bytes held in chunks, headers included
+        size_t bytes_reserved() const noexcept
+        {
+            return m_reserved;
+        }
+
+    private:
+        static char* align_up(char* p, size_t align) noexcept
+        {
+            const auto address = reinterpret_cast<uintptr_t>(p);
+            return reinterpret_cast<char*>((address + align - 1) & ~(uintptr_t(align) - 1));
+        }
+
+        void add_chunk(size_t bytes, size_t align)
+        {
+            const auto limit = std::numeric_limits<size_t>::max() / 2;
+            if (bytes > limit - HEADER - align)
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto needed = HEADER + bytes + align;
+            const auto size = needed > m_next_size ? needed : m_next_size;
+            const auto c = static_cast<chunk*>(::operator new(size));
+            c->next = m_chunks;
+            c->size = size;
+            m_chunks = c;
+            m_top = reinterpret_cast<char*>(c) + HEADER;
+            m_end = reinterpret_cast<char*>(c) + size;
+            m_reserved += size;
+            m_next_size = m_next_size * 2 <= MAX_CHUNK ? m_next_size * 2 : MAX_CHUNK;
+        }
+
+        // Frees every chunk except keep
+        void release(chunk* keep) noexcept
+        {
+            auto c = m_chunks;
+            while (c)
+            {
+                const auto next = c->next;
+                if (c != keep)
+                {
+                    ::operator delete(c);
+                }
+                c = next;
+            }
+
+            m_chunks = nullptr;
+            m_top = nullptr;
+            m_end = nullptr;
+            m_reserved = 0;
+        }
+
+        chunk* m_chunks = nullptr;
+        char* m_top = nullptr;
+        char* m_end = nullptr;
+        size_t m_next_size;
+        size_t m_used = 0;
+        size_t m_reserved = 0;
+    };
+
+    // Allocator over a monotonic_arena. deallocate does nothing; memory
+    // comes back when the arena is reset or destroyed, which must not happen
+    // while a container still uses it. Allocators compare equal when they
+    // share an arena. They do not propagate, so a vector keeps its arena and
+    // moving between vectors of different arenas copies the elements.
+    template<typename T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        explicit arena_allocator(monotonic_arena& arena) noexcept
+            : m_arena{ &arena }
+        {
+        }
+
+        template<typename U>
+        arena_allocator(const arena_allocator<U>& rhs) noexcept
+            : m_arena{ &rhs.arena() }
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            if (count > std::numeric_limits<size_type>::max() / 2 / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_type) noexcept
+        {
+        }
+
+        // Hook for vector growth, see allocator_expand
+        bool try_expand(T* p, size_type old_count, size_type new_count) noexcept
+        {
+            return new_count <= std::numeric_limits<size_type>::max() / 2 / sizeof(T)
+                   && m_arena->try_expand(p, old_count * sizeof(T), new_count * sizeof(T));
+        }
+
+        monotonic_arena& arena() const noexcept
+        {
+            return *m_arena;
+        }
+
+    private:
+        monotonic_arena* m_arena;
+    };
+
+    template<typename T, typename U>
+    bool operator == (const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+    template<typename T, typename U>
+    bool operator != (const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif //OMEGA_ARENA_ALLOCATOR_HPP
@@ -0,0 +1,96 @@
+#include "../arena_allocator.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Same pseudo random request shapes for every allocator
+    uint32_t next_random(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // One request: a few token lists are built by push_back, then a result
+    // that keeps growing while the temporaries it reads are made
+    template<typename Allocator>
+    uint64_t handle_request(const Allocator& alloc, uint32_t& state, unsigned lists)
+    {
+        using vector_type = omega::vector<uint64_t, Allocator>;
+        uint64_t checksum = 0;
+        vector_type result(alloc);
+        for (unsigned list = 0; list < lists; ++list)
+        {
+            vector_type tokens(alloc);
+            const auto count = 4 + next_random(state) % 64;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                tokens.push_back(i * 2654435761u);
+            }
+            for (const auto token : tokens)
+            {
+                checksum += token;
+            }
+            result.push_back(tokens.back());
+        }
+
+        vector_type tail(alloc);
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            tail.push_back(checksum + i);
+        }
+        return checksum + result.size() + tail.back();
+    }
+
+    template<typename Run>
+    double per_request_ns(unsigned requests, Run run)
+    {
+        const auto start = clock_type::now();
+        uint64_t checksum = 0;
+        for (unsigned i = 0; i < requests; ++i)
+        {
+            checksum += run();
+        }
+        const auto ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / requests;
+        if (checksum == 42)
+        {
+            std::cout << "unlikely checksum" << std::endl;
+        }
+        return ns;
+    }
+}
+
+// Usage: arena_allocator [requests], 20000 by default
+int main(int argc, char* argv[])
+{
+    const unsigned requests = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 20000;
+
+    std::cout << "vectors per request, std::allocator ns per request, arena_allocator ns per request"
+              << ", arena bytes reserved" << std::endl;
+    for (unsigned lists = 4; lists <= 256; lists *= 4)
+    {
+        uint32_t state = 2463534242u;
+        const auto heap_ns = per_request_ns(requests, [&] {
+            return handle_request(std::allocator<uint64_t>{}, state, lists);
+        });
+
+        state = 2463534242u;
+        omega::monotonic_arena arena;
+        const auto arena_ns = per_request_ns(requests, [&] {
+            const auto checksum = handle_request(omega::arena_allocator<uint64_t>{ arena }, state, lists);
+            arena.reset();
+            return checksum;
+        });
+
+        std::cout << lists + 2 << ", " << heap_ns << ", " << arena_ns << ", " << arena.bytes_reserved() << std::endl;
+    }
+}
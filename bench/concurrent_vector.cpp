@@ -0,0 +1,86 @@
+#include "../concurrent_vector.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_ms(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+
+    template<typename Push>
+    double run(unsigned threads, size_t per_thread, Push push)
+    {
+        std::vector<std::thread> workers;
+        const auto start = clock_type::now();
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&push, per_thread, t] {
+                for (size_t i = 0; i < per_thread; ++i)
+                {
+                    push(t * per_thread + i);
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        return elapsed_ms(start);
+    }
+}
+
+// Usage: concurrent_vector [max threads], defaults to the hardware concurrency
+int main(int argc, char* argv[])
+{
+    const size_t total = size_t{ 1 } << 24;
+    const size_t batch = 64;
+    const auto hardware = std::thread::hardware_concurrency();
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : (hardware ? hardware : 4);
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "threads, mutex + vector ms, concurrent push_back ms, concurrent grow_by(" << batch << ") ms" << std::endl;
+    for (const auto threads : thread_counts)
+    {
+        const auto per_thread = total / threads;
+
+        std::mutex mutex;
+        omega::vector<size_t> locked;
+        const auto locked_ms = run(threads, per_thread, [&mutex, &locked](size_t value) {
+            std::lock_guard<std::mutex> lock{ mutex };
+            locked.push_back(value);
+        });
+
+        omega::concurrent_vector<size_t> pushed;
+        const auto pushed_ms = run(threads, per_thread, [&pushed](size_t value) {
+            pushed.push_back(value);
+        });
+
+        omega::concurrent_vector<size_t> grown;
+        const auto grown_ms = run(threads, per_thread / batch, [&grown](size_t value) {
+            grown.grow_by(batch, value);
+        });
+
+        std::cout << threads << ", " << locked_ms << ", " << pushed_ms << ", " << grown_ms << std::endl;
+        if (locked.size() != pushed.size() || pushed.size() != grown.size())
+        {
+            std::cout << "size mismatch" << std::endl;
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include "../hugepage_allocator.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Counts data TLB load misses of this thread; reports -1 where perf
+    // events are not available
+    class tlb_counter
+    {
+    public:
+        tlb_counter()
+        {
+#if defined(__linux__)
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~tlb_counter()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0)
+            {
+                close(m_fd);
+            }
+#endif
+        }
+
+        void start()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0)
+            {
+                ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        long long stop()
+        {
+#if defined(__linux__)
+            long long misses = 0;
+            if (m_fd >= 0 && ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0) == 0
+                && read(m_fd, &misses, sizeof(misses)) == sizeof(misses))
+            {
+                return misses;
+            }
+#endif
+            return -1;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    // AnonHugePages of the whole process in kB, -1 when unknown
+    long long anon_huge_kb()
+    {
+        std::ifstream rollup{ "/proc/self/smaps_rollup" };
+        std::string key;
+        long long value = 0;
+        while (rollup >> key >> value)
+        {
+            if (key == "AnonHugePages:")
+            {
+                return value;
+            }
+            rollup.ignore(64, '\n');
+        }
+        return -1;
+    }
+
+    template<typename Vector>
+    void run(const char* name, size_t count, size_t lookups)
+    {
+        Vector table;
+        table.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            table[i] = i * 0x9e3779b97f4a7c15ull;
+        }
+
+        tlb_counter counter;
+        uint64_t state = 88172645463325252ull;
+        uint64_t sum = 0;
+        const auto start = clock_type::now();
+        counter.start();
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += table[state % count];
+        }
+        const auto misses = counter.stop();
+        const auto ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+
+        std::cout << name << ", " << ms << ", " << misses << ", " << anon_huge_kb() << ", " << (sum & 1) << std::endl;
+    }
+}
+
+// Usage: hugepage_allocator [table MB], 1024 by default
+int main(int argc, char* argv[])
+{
+    const size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1024;
+    const size_t count = (megabytes << 20) / sizeof(uint64_t);
+    const size_t lookups = size_t{ 1 } << 25;
+
+    std::cout << megabytes << " MB table, " << lookups << " random lookups" << std::endl;
+    std::cout << "allocator, ms, dTLB load misses (-1: no perf events), AnonHugePages kB, checksum bit" << std::endl;
+    run<omega::vector<uint64_t>>("std::allocator", count, lookups);
+    run<omega::vector<uint64_t, omega::hugepage_allocator<uint64_t>>>("hugepage_allocator", count, lookups);
+}
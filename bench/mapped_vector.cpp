@@ -0,0 +1,71 @@
+#include "../mapped_vector.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct record
+    {
+        uint64_t key;
+        uint64_t value;
+    };
+
+    double elapsed_ms(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+}
+
+// Usage: mapped_vector [records], 2^24 (256 MB) by default
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : size_t{ 1 } << 24;
+    const std::string mapped_path = "/tmp/omega_bench_mapped_vector";
+    const std::string stream_path = "/tmp/omega_bench_mapped_vector.raw";
+    std::remove(mapped_path.c_str());
+
+    {
+        omega::mapped_vector<record> records(mapped_path);
+        records.reserve(count);
+        omega::vector<record> plain;
+        plain.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            records.push_back(record{ i, i * 3 });
+            plain.push_back(record{ i, i * 3 });
+        }
+        std::ofstream out{ stream_path, std::ios::binary };
+        out.write(reinterpret_cast<const char*>(plain.data()), static_cast<std::streamsize>(count * sizeof(record)));
+    }
+
+    std::cout << "records, load from stream ms, open mapped_vector ms, open + one random lookup ms" << std::endl;
+
+    auto start = clock_type::now();
+    omega::vector<record> loaded;
+    {
+        std::ifstream in{ stream_path, std::ios::binary };
+        loaded.resize(count);
+        in.read(reinterpret_cast<char*>(loaded.data()), static_cast<std::streamsize>(count * sizeof(record)));
+    }
+    const auto stream_ms = elapsed_ms(start);
+
+    start = clock_type::now();
+    const omega::mapped_vector<record> opened(mapped_path, omega::mapped_mode::read_only);
+    const auto open_ms = elapsed_ms(start);
+    const auto key = opened[count / 3].key;
+    const auto lookup_ms = elapsed_ms(start);
+
+    std::cout << count << ", " << stream_ms << ", " << open_ms << ", " << lookup_ms << std::endl;
+    std::remove(mapped_path.c_str());
+    std::remove(stream_path.c_str());
+    return key == loaded[count / 3].key ? 0 : 1;
+}
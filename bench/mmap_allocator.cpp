@@ -0,0 +1,48 @@
+#include "../mmap_allocator.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Time of the one push_back that grows a full vector of count elements
+    template<typename Vector>
+    double grow_ms(size_t count)
+    {
+        Vector values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values.push_back(i);
+        }
+
+        const auto start = clock_type::now();
+        values.push_back(count);
+        const auto ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        if (values[count / 2] != count / 2)
+        {
+            std::cout << "wrong contents" << std::endl;
+            std::exit(1);
+        }
+        return ms;
+    }
+}
+
+// Usage: mmap_allocator [log2 of the largest size], 26 by default
+int main(int argc, char* argv[])
+{
+    const unsigned max_bits = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 26;
+
+    std::cout << "uint64_t elements, std::allocator grow ms, mmap_allocator grow ms" << std::endl;
+    for (unsigned bits = 16; bits <= max_bits; bits += 2)
+    {
+        const auto count = size_t{ 1 } << bits;
+        std::cout << count << ", " << grow_ms<omega::vector<uint64_t>>(count) << ", "
+                  << grow_ms<omega::vector<uint64_t, omega::mmap_allocator<uint64_t>>>(count) << std::endl;
+    }
+}
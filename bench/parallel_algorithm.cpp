@@ -0,0 +1,102 @@
+#include "../parallel_algorithm.hpp"
+#include "../vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_ms(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+
+    template<typename Work>
+    double time(Work work)
+    {
+        const auto start = clock_type::now();
+        work();
+        return elapsed_ms(start);
+    }
+
+    omega::vector<double> random_values(size_t count)
+    {
+        omega::vector<double> values;
+        values.reserve(count);
+        unsigned long long state = 88172645463325252ULL;
+        for (size_t i = 0; i < count; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            values.push_back(static_cast<double>(state % 1000000) / 1000.0);
+        }
+        return values;
+    }
+}
+
+// Usage: parallel_algorithm [max threads], defaults to the hardware concurrency.
+// Prints milliseconds per algorithm and the speedup over one thread.
+int main(int argc, char* argv[])
+{
+    const size_t count = size_t{ 1 } << 24;
+    const auto hardware = std::thread::hardware_concurrency();
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : (hardware ? hardware : 4);
+    const auto input = random_values(count);
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << count << " doubles" << std::endl;
+    std::cout << "threads, sort ms, transform ms, reduce ms, inclusive_scan ms, for_each ms, speedup over 1 thread"
+              << std::endl;
+    double baseline = 0;
+    for (const auto threads : thread_counts)
+    {
+        omega::thread_pool pool{ threads };
+        auto values = input;
+        omega::vector<double> out;
+        out.resize(count);
+        double checksum = 0;
+
+        const auto sort_ms = time([&] {
+            omega::par::sort(pool, values.begin(), values.end(), std::less<double>{});
+        });
+        const auto transform_ms = time([&] {
+            omega::par::transform(pool, input.begin(), input.end(), out.begin()
+                                  , [](double v) { return std::sqrt(v) * 1.5 + 2.0; });
+        });
+        const auto reduce_ms = time([&] {
+            checksum += omega::par::reduce(pool, input.begin(), input.end(), 0.0, std::plus<double>{});
+        });
+        const auto scan_ms = time([&] {
+            omega::par::inclusive_scan(pool, input.begin(), input.end(), out.begin(), std::plus<double>{});
+        });
+        const auto for_each_ms = time([&] {
+            omega::par::for_each(pool, values.begin(), values.end(), [](double& v) { v = std::sin(v); });
+        });
+
+        const auto total = sort_ms + transform_ms + reduce_ms + scan_ms + for_each_ms;
+        baseline = baseline ? baseline : total;
+        std::cout << threads << ", " << sort_ms << ", " << transform_ms << ", " << reduce_ms << ", " << scan_ms
+                  << ", " << for_each_ms << ", " << baseline / total << std::endl;
+        if (!std::isfinite(checksum + out[count - 1] + values[0]))
+        {
+            std::cout << "bad result" << std::endl;
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_ms(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+
+    template<typename Build>
+    double time(Build build)
+    {
+        const auto start = clock_type::now();
+        build();
+        return elapsed_ms(start);
+    }
+}
+
+// Usage: parallel_construct [max threads], defaults to the hardware concurrency
+int main(int argc, char* argv[])
+{
+    const size_t count = size_t{ 1 } << 26;
+    const auto hardware = std::thread::hardware_concurrency();
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : (hardware ? hardware : 4);
+
+    omega::vector<double> source;
+    source.assign(omega::parallel_policy{ max_threads }, count, 1.5);
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << count << " doubles" << std::endl;
+    std::cout << "threads, copy ms, assign(count, value) ms, resize(count, value) ms" << std::endl;
+    std::cout << "serial, " << time([&source] { omega::vector<double> copy{ source }; })
+              << ", " << time([count] { omega::vector<double> filled; filled.assign(count, 2.5); })
+              << ", " << time([count] { omega::vector<double> grown; grown.resize(count, 2.5); }) << std::endl;
+    for (const auto threads : thread_counts)
+    {
+        const omega::parallel_policy policy{ threads };
+        std::cout << threads << ", " << time([&source, policy] { omega::vector<double> copy(policy, source); })
+                  << ", " << time([count, policy] { omega::vector<double> filled; filled.assign(policy, count, 2.5); })
+                  << ", " << time([count, policy] { omega::vector<double> grown; grown.resize(policy, count, 2.5); })
+                  << std::endl;
+    }
+}
@@ -0,0 +1,100 @@
+#include "../pool_allocator.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    uint32_t next_random(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Resident set of this process in MB
+    double resident_mb()
+    {
+        std::ifstream statm{ "/proc/self/statm" };
+        size_t total = 0;
+        size_t resident = 0;
+        statm >> total >> resident;
+        return static_cast<double>(resident * static_cast<size_t>(sysconf(_SC_PAGESIZE))) / (1 << 20);
+    }
+
+    // Keeps slots live vectors and replaces a random one per step with a new
+    // vector of a random, mostly small size, built by push_back
+    template<typename Allocator>
+    void churn(const char* name, size_t slots, size_t steps)
+    {
+        using vector_type = omega::vector<uint32_t, Allocator>;
+        std::unique_ptr<vector_type[]> live{ new vector_type[slots] };
+        uint32_t state = 2463534242u;
+        uint64_t checksum = 0;
+
+        const auto start = clock_type::now();
+        for (size_t step = 0; step < steps; ++step)
+        {
+            auto& values = live[next_random(state) % slots];
+            vector_type fresh;
+            const auto bits = next_random(state) % 8;
+            const auto count = 1 + next_random(state) % (2u << bits);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                fresh.push_back(i);
+            }
+            checksum += fresh.back();
+            values = std::move(fresh);
+        }
+        const auto ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / steps;
+
+        size_t live_bytes = 0;
+        for (size_t i = 0; i < slots; ++i)
+        {
+            live_bytes += live[i].capacity() * sizeof(uint32_t);
+        }
+        const auto live_mb = static_cast<double>(live_bytes) / (1 << 20);
+        const auto rss = resident_mb();
+        std::cout << name << ", " << ns << ", " << live_mb << ", " << rss << ", " << rss / live_mb
+                  << (checksum == 42 ? " unlikely checksum" : "") << std::endl;
+    }
+
+    // Runs one allocator in a child process, so each starts from a clean heap
+    template<typename Allocator>
+    void run_isolated(const char* name, size_t slots, size_t steps)
+    {
+        std::cout.flush();
+        const auto child = fork();
+        if (child == 0)
+        {
+            churn<Allocator>(name, slots, steps);
+            std::cout.flush();
+            _exit(0);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+    }
+}
+
+// Usage: pool_allocator [live vectors] [replacements], 20000 and 2000000 by default
+int main(int argc, char* argv[])
+{
+    const size_t slots = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 20000;
+    const size_t steps = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 2000000;
+
+    std::cout << "allocator, ns per vector, live MB, resident MB, resident / live" << std::endl;
+    run_isolated<std::allocator<uint32_t>>("std::allocator", slots, steps);
+    run_isolated<omega::pool_allocator<uint32_t>>("pool_allocator", slots, steps);
+}
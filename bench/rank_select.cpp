@@ -0,0 +1,87 @@
+#include "../rank_select.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_ns(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    }
+
+    size_t naive_rank(const omega::bit_vector<>& bits, size_t pos)
+    {
+        const auto words = bits.words();
+        size_t result = omega::bit_ops::popcount(words.data(), pos / 64);
+        if (pos % 64)
+        {
+            result += omega::bit_ops::popcount(words[pos / 64] & omega::bit_ops::low_mask(pos % 64));
+        }
+        return result;
+    }
+}
+
+int main(int, char* [])
+{
+    const size_t bit_count = size_t{ 1 } << 28;
+    const size_t queries = 1000000;
+    const size_t naive_queries = 200;
+
+    std::mt19937_64 generator{ 1 };
+    omega::bit_vector<> bits;
+    bits.reserve(bit_count);
+    for (size_t i = 0; i < bit_count; ++i)
+    {
+        bits.push_back(generator() & 1);
+    }
+
+    auto start = clock_type::now();
+    omega::rank_select<> index(bits);
+    std::cout << "build: " << elapsed_ns(start) / 1e6 << " ms, overhead "
+              << 100.0 * index.size_in_bytes() * 8 / bit_count << "%" << std::endl;
+
+    std::uniform_int_distribution<size_t> positions{ 0, bit_count };
+    size_t checksum = 0;
+
+    start = clock_type::now();
+    for (size_t i = 0; i < queries; ++i)
+    {
+        checksum += index.rank1(positions(generator));
+    }
+    std::cout << "rank1 (index): " << elapsed_ns(start) / queries << " ns/query" << std::endl;
+
+    start = clock_type::now();
+    for (size_t i = 0; i < naive_queries; ++i)
+    {
+        checksum += naive_rank(bits, positions(generator));
+    }
+    std::cout << "rank1 (popcount scan): " << elapsed_ns(start) / naive_queries << " ns/query" << std::endl;
+
+    std::uniform_int_distribution<size_t> ranks{ 0, index.count() - 1 };
+    start = clock_type::now();
+    for (size_t i = 0; i < queries; ++i)
+    {
+        checksum += index.select1(ranks(generator));
+    }
+    std::cout << "select1 (index): " << elapsed_ns(start) / queries << " ns/query" << std::endl;
+
+    for (size_t i = 0; i < bit_count / 64; ++i)
+    {
+        bits.push_back(generator() & 1);
+    }
+
+    start = clock_type::now();
+    index.update();
+    std::cout << "update after appending " << bit_count / 64 << " bits: " << elapsed_ns(start) / 1e6 << " ms" << std::endl;
+
+    start = clock_type::now();
+    index.build();
+    std::cout << "full rebuild: " << elapsed_ns(start) / 1e6 << " ms" << std::endl;
+
+    std::cout << "checksum " << checksum << std::endl;
+}
@@ -0,0 +1,108 @@
+#include "../sharded_vector.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_ms(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+
+    template<typename Work>
+    double run(unsigned threads, Work work)
+    {
+        std::vector<std::thread> workers;
+        const auto start = clock_type::now();
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&work, t] { work(t); });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        return elapsed_ms(start);
+    }
+}
+
+// Usage: sharded_vector [max threads], defaults to the hardware concurrency
+int main(int argc, char* argv[])
+{
+    const size_t total = size_t{ 1 } << 24;
+    const size_t flush = 4096;
+    const auto hardware = std::thread::hardware_concurrency();
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : (hardware ? hardware : 4);
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "threads, mutex + vector ms, local buffers flushed every " << flush
+              << " ms, sharded push_back ms, sharded merge ms" << std::endl;
+    for (const auto threads : thread_counts)
+    {
+        const auto per_thread = total / threads;
+
+        std::mutex mutex;
+        omega::vector<size_t> locked;
+        const auto locked_ms = run(threads, [&mutex, &locked, per_thread](unsigned t) {
+            for (size_t i = 0; i < per_thread; ++i)
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                locked.push_back(t * per_thread + i);
+            }
+        });
+
+        std::mutex flush_mutex;
+        omega::vector<size_t> flushed;
+        const auto flushed_ms = run(threads, [&flush_mutex, &flushed, per_thread, flush](unsigned t) {
+            omega::vector<size_t> buffer;
+            buffer.reserve(flush);
+            for (size_t i = 0; i < per_thread; ++i)
+            {
+                buffer.push_back(t * per_thread + i);
+                if (buffer.size() == flush || i + 1 == per_thread)
+                {
+                    std::lock_guard<std::mutex> lock{ flush_mutex };
+                    for (const auto value : buffer)
+                    {
+                        flushed.push_back(value);
+                    }
+                    buffer.clear();
+                }
+            }
+        });
+
+        omega::sharded_vector<size_t> sharded{ threads };
+        const auto sharded_ms = run(threads, [&sharded, per_thread](unsigned t) {
+            auto writer = sharded.make_writer();
+            for (size_t i = 0; i < per_thread; ++i)
+            {
+                writer.push_back(t * per_thread + i);
+            }
+        });
+        const auto merge_start = clock_type::now();
+        const auto merged = sharded.merge();
+        const auto merge_ms = elapsed_ms(merge_start);
+
+        std::cout << threads << ", " << locked_ms << ", " << flushed_ms << ", " << sharded_ms << ", " << merge_ms
+                  << std::endl;
+        if (locked.size() != merged.size() || flushed.size() != merged.size())
+        {
+            std::cout << "size mismatch" << std::endl;
+            return 1;
+        }
+    }
+}
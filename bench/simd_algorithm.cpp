@@ -0,0 +1,90 @@
+#include "../simd_algorithm.hpp"
+#include "../vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+    using omega::simd::isa;
+
+    // Keeps results alive so the loops are not optimized away
+    volatile double sink = 0;
+
+    template<typename Work>
+    double time_ms(int repeats, Work work)
+    {
+        const auto start = clock_type::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            sink = sink + static_cast<double>(work());
+        }
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / repeats;
+    }
+
+    const char* name(isa level)
+    {
+        switch (level)
+        {
+        case isa::avx512: return "avx512";
+        case isa::avx2: return "avx2";
+        case isa::sse2: return "sse2";
+        default: return "scalar";
+        }
+    }
+
+    // The generic loop is the std algorithm over omega::vector iterators
+    template<typename T>
+    void run(const char* type, size_t count, int repeats)
+    {
+        omega::vector<T> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values.push_back(static_cast<T>(i % 1000));
+        }
+        const auto first = values.data();
+        const auto last = first + count;
+        const T missing = static_cast<T>(5000);
+
+        std::cout << type << ", generic"
+                  << ", " << time_ms(repeats, [&] { return std::find(values.cbegin(), values.cend(), missing) - values.cbegin(); })
+                  << ", " << time_ms(repeats, [&] { return std::count(values.cbegin(), values.cend(), T(7)); })
+                  << ", " << time_ms(repeats, [&] { return *std::min_element(values.cbegin(), values.cend()); })
+                  << ", " << time_ms(repeats, [&] { return std::accumulate(values.cbegin(), values.cend(), T(0)); })
+                  << std::endl;
+
+        for (const auto level : { isa::scalar, isa::sse2, isa::avx2, isa::avx512 })
+        {
+            if (level > omega::simd::detected_isa())
+            {
+                break;
+            }
+            std::cout << type << ", " << name(level)
+                      << ", " << time_ms(repeats, [&] { return omega::simd::find(first, last, missing, level) - first; })
+                      << ", " << time_ms(repeats, [&] { return omega::simd::count(first, last, T(7), level); })
+                      << ", " << time_ms(repeats, [&] { return omega::simd::min(first, last, level); })
+                      << ", " << time_ms(repeats, [&] { return omega::simd::sum(first, last, level); })
+                      << std::endl;
+        }
+    }
+}
+
+// Sizes fit in L2 so the kernels are not bound by memory bandwidth
+int main()
+{
+    const size_t count = size_t{ 1 } << 15;
+    const int repeats = 2000;
+
+    std::cout << count << " elements, ms per call" << std::endl;
+    std::cout << "type, kernel, find, count, min, sum" << std::endl;
+    run<int32_t>("int32", count, repeats);
+    run<uint64_t>("uint64", count, repeats);
+    run<float>("float", count, repeats);
+    run<double>("double", count, repeats);
+}
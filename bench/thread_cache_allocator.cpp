@@ -0,0 +1,94 @@
+#include "../pool_allocator.hpp"
+#include "../thread_cache_allocator.hpp"
+#include "../vector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    uint32_t next_random(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Each thread keeps a few vectors and keeps clearing their capacity and
+    // refilling them to a new small size, so every refill frees one buffer
+    // and allocates a similar one
+    template<typename Allocator>
+    uint64_t churn(unsigned seed, size_t rounds)
+    {
+        using vector_type = omega::vector<uint32_t, Allocator>;
+        vector_type live[8];
+        uint32_t state = 2463534242u + seed;
+        uint64_t checksum = 0;
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            auto& values = live[round % 8];
+            values = vector_type{};
+            const auto count = 1 + next_random(state) % 48;
+            values.reserve(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                values.push_back(i);
+            }
+            checksum += values[count - 1];
+        }
+        return checksum;
+    }
+
+    template<typename Allocator>
+    double ns_per_vector(unsigned threads, size_t rounds)
+    {
+        std::vector<std::thread> workers;
+        std::unique_ptr<uint64_t[]> checksums{ new uint64_t[threads] };
+        const auto start = clock_type::now();
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([t, rounds, &checksums] { checksums[t] = churn<Allocator>(t, rounds); });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        const auto ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+
+        uint64_t checksum = 0;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            checksum += checksums[t];
+        }
+        if (checksum == 42)
+        {
+            std::cout << "unlikely checksum" << std::endl;
+        }
+        return ns / (static_cast<double>(rounds) * threads);
+    }
+}
+
+// Usage: thread_cache_allocator [max threads] [vectors per thread], 8 and 2000000 by default
+int main(int argc, char* argv[])
+{
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 8;
+    const size_t rounds = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 2000000;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "threads, std::allocator ns per vector, pool_allocator ns per vector"
+              << ", thread_cache_allocator ns per vector" << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        std::cout << threads << ", " << ns_per_vector<std::allocator<uint32_t>>(threads, rounds) << ", "
+                  << ns_per_vector<omega::pool_allocator<uint32_t>>(threads, rounds) << ", "
+                  << ns_per_vector<omega::thread_cache_allocator<uint32_t>>(threads, rounds) << std::endl;
+    }
+}
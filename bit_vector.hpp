@@ -0,0 +1,430 @@
+#ifndef OMEGA_BIT_VECTOR_HPP
+#define OMEGA_BIT_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/bit_ops.hpp"
+#include "vector_helpers/span.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+
+namespace omega
+{
+    // Packed vector of bits stored in 64-bit words of an omega::vector.
+    // Bits past size() in the last word are always zero, which lets the
+    // word-level operations work on whole words without masking.
+    template<typename Allocator = std::allocator<uint64_t>>
+    class bit_vector
+    {
+    public:
+        using word_type = uint64_t;
+        using value_type = bool;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using const_reference = bool;
+        using storage_type = vector<word_type, allocator_type>;
+
+        static constexpr size_type BITS_PER_WORD = 64;
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        class reference
+        {
+            friend class bit_vector;
+        public:
+            operator bool() const noexcept
+            {
+                return (*m_word & m_mask) != 0;
+            }
+
+            bool operator ~ () const noexcept
+            {
+                return !static_cast<bool>(*this);
+            }
+
+            reference& operator = (bool value) noexcept
+            {
+                if (value)
+                {
+                    *m_word |= m_mask;
+                }
+                else
+                {
+                    *m_word &= ~m_mask;
+                }
+                return *this;
+            }
+
+            reference& operator = (const reference& rhs) noexcept
+            {
+                return *this = static_cast<bool>(rhs);
+            }
+
+            reference& flip() noexcept
+            {
+                *m_word ^= m_mask;
+                return *this;
+            }
+
+        private:
+            reference(word_type* word, word_type mask) noexcept
+                : m_word{ word }
+                , m_mask{ mask }
+            {
+            }
+
+            word_type* m_word;
+            word_type m_mask;
+        };
+
+        bit_vector() noexcept(noexcept(allocator_type())) = default;
+
+        explicit bit_vector(const allocator_type& alloc) noexcept
+            : m_words( alloc )
+        {
+        }
+
+        bit_vector(std::initializer_list<bool> list, const allocator_type& alloc = allocator_type{})
+            : m_words( alloc )
+        {
+            m_words.reserve(words_for(list.size()));
+            for (auto value : list)
+            {
+                push_back(value);
+            }
+        }
+
+        void push_back(bool value)
+        {
+            if (m_size % BITS_PER_WORD == 0)
+            {
+                m_words.push_back(0);
+            }
+
+            ++m_size;
+            set(m_size - 1, value);
+        }
+
+        void pop_back()
+        {
+            --m_size;
+            if (m_size % BITS_PER_WORD == 0)
+            {
+                m_words.pop_back();
+            }
+            else
+            {
+                clear_tail();
+            }
+        }
+
+        void resize(size_type count, bool value = false)
+        {
+            if (count > m_size && value)
+            {
+                // fill the unused part of the current last word before growing
+                const auto used = m_size % BITS_PER_WORD;
+                if (used)
+                {
+                    m_words.back() |= ~bit_ops::low_mask(used);
+                }
+            }
+
+            m_words.resize(words_for(count), value ? ~word_type{ 0 } : word_type{ 0 });
+            m_size = count;
+            clear_tail();
+        }
+
+        void reserve(size_type bits)
+        {
+            m_words.reserve(words_for(bits));
+        }
+
+        void shrink_to_fit()
+        {
+            m_words.shrink_to_fit();
+        }
+
+        void clear() noexcept
+        {
+            m_words.clear();
+            m_size = 0;
+        }
+
+        reference operator[](size_type index) noexcept
+        {
+            return reference{ &m_words[index / BITS_PER_WORD], bit(index) };
+        }
+
+        const_reference operator[](size_type index) const noexcept
+        {
+            return test(index);
+        }
+
+        reference at(size_type index)
+        {
+            check_index(index);
+            return (*this)[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            check_index(index);
+            return test(index);
+        }
+
+        reference front() noexcept
+        {
+            return (*this)[0];
+        }
+
+        const_reference front() const noexcept
+        {
+            return test(0);
+        }
+
+        reference back() noexcept
+        {
+            return (*this)[m_size - 1];
+        }
+
+        const_reference back() const noexcept
+        {
+            return test(m_size - 1);
+        }
+
+        bool test(size_type index) const noexcept
+        {
+            return (m_words[index / BITS_PER_WORD] & bit(index)) != 0;
+        }
+
+        void set(size_type index, bool value = true) noexcept
+        {
+            (*this)[index] = value;
+        }
+
+        void reset(size_type index) noexcept
+        {
+            set(index, false);
+        }
+
+        void flip(size_type index) noexcept
+        {
+            m_words[index / BITS_PER_WORD] ^= bit(index);
+        }
+
+        void flip() noexcept
+        {
+            for (auto& word : m_words)
+            {
+                word = ~word;
+            }
+            clear_tail();
+        }
+
+        // Sets bits [first, last) to value, a whole word at a time
+        void set_range(size_type first, size_type last, bool value = true)
+        {
+            if (first > last || last > m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            if (first == last)
+            {
+                return;
+            }
+
+            const auto first_word = first / BITS_PER_WORD;
+            const auto last_word = (last - 1) / BITS_PER_WORD;
+            const auto head_mask = ~bit_ops::low_mask(first % BITS_PER_WORD);
+            const auto tail_mask = bit_ops::low_mask((last - 1) % BITS_PER_WORD + 1);
+
+            if (first_word == last_word)
+            {
+                apply_mask(m_words[first_word], head_mask & tail_mask, value);
+                return;
+            }
+
+            apply_mask(m_words[first_word], head_mask, value);
+            const auto fill = value ? ~word_type{ 0 } : word_type{ 0 };
+            for (auto i = first_word + 1; i < last_word; ++i)
+            {
+                m_words[i] = fill;
+            }
+            apply_mask(m_words[last_word], tail_mask, value);
+        }
+
+        size_type count() const noexcept
+        {
+            return bit_ops::popcount(m_words.data(), m_words.size());
+        }
+
+        bool any() const noexcept
+        {
+            return find_first() != npos;
+        }
+
+        bool none() const noexcept
+        {
+            return !any();
+        }
+
+        size_type find_first() const noexcept
+        {
+            return find_from_word(0);
+        }
+
+        // Index of the first set bit after pos, npos if there is none
+        size_type find_next(size_type pos) const noexcept
+        {
+            const auto next = pos + 1;
+            if (next >= m_size)
+            {
+                return npos;
+            }
+
+            const auto word_index = next / BITS_PER_WORD;
+            const auto word = m_words[word_index] & ~bit_ops::low_mask(next % BITS_PER_WORD);
+            if (word)
+            {
+                return word_index * BITS_PER_WORD + bit_ops::count_trailing_zeros(word);
+            }
+
+            return find_from_word(word_index + 1);
+        }
+
+        bit_vector& operator &= (const bit_vector& rhs)
+        {
+            check_same_size(rhs);
+            bit_ops::and_words(m_words.data(), rhs.m_words.data(), m_words.size());
+            return *this;
+        }
+
+        bit_vector& operator |= (const bit_vector& rhs)
+        {
+            check_same_size(rhs);
+            bit_ops::or_words(m_words.data(), rhs.m_words.data(), m_words.size());
+            return *this;
+        }
+
+        bit_vector& operator ^= (const bit_vector& rhs)
+        {
+            check_same_size(rhs);
+            bit_ops::xor_words(m_words.data(), rhs.m_words.data(), m_words.size());
+            return *this;
+        }
+
+        span<const word_type> words() const noexcept
+        {
+            return span<const word_type>{ m_words.data(), m_words.size() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return m_words.capacity() * BITS_PER_WORD;
+        }
+
+        void swap(bit_vector& rhs) noexcept
+        {
+            m_words.swap(rhs.m_words);
+            std::swap(m_size, rhs.m_size);
+        }
+
+    private:
+        static size_type words_for(size_type bits) noexcept
+        {
+            return (bits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+        }
+
+        static word_type bit(size_type index) noexcept
+        {
+            return word_type{ 1 } << (index % BITS_PER_WORD);
+        }
+
+        static void apply_mask(word_type& word, word_type mask, bool value) noexcept
+        {
+            word = value ? (word | mask) : (word & ~mask);
+        }
+
+        void clear_tail() noexcept
+        {
+            const auto used = m_size % BITS_PER_WORD;
+            if (used)
+            {
+                m_words.back() &= bit_ops::low_mask(used);
+            }
+        }
+
+        size_type find_from_word(size_type word_index) const noexcept
+        {
+            for (; word_index < m_words.size(); ++word_index)
+            {
+                if (m_words[word_index])
+                {
+                    return word_index * BITS_PER_WORD + bit_ops::count_trailing_zeros(m_words[word_index]);
+                }
+            }
+            return npos;
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        void check_same_size(const bit_vector& rhs) const
+        {
+            if (m_size != rhs.m_size)
+            {
+                throw std::invalid_argument("bit vectors of different size");
+            }
+        }
+
+        storage_type m_words;
+        size_type m_size = 0;
+    };
+
+    template<typename Allocator>
+    constexpr typename bit_vector<Allocator>::size_type bit_vector<Allocator>::BITS_PER_WORD;
+
+    template<typename Allocator>
+    constexpr typename bit_vector<Allocator>::size_type bit_vector<Allocator>::npos;
+
+    template<typename Allocator>
+    bit_vector<Allocator> operator & (bit_vector<Allocator> lhs, const bit_vector<Allocator>& rhs)
+    {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    template<typename Allocator>
+    bit_vector<Allocator> operator | (bit_vector<Allocator> lhs, const bit_vector<Allocator>& rhs)
+    {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    template<typename Allocator>
+    bit_vector<Allocator> operator ^ (bit_vector<Allocator> lhs, const bit_vector<Allocator>& rhs)
+    {
+        lhs ^= rhs;
+        return lhs;
+    }
+}
+
+#endif //OMEGA_BIT_VECTOR_HPP
@@ -0,0 +1,347 @@
+#ifndef OMEGA_CONCURRENT_VECTOR_HPP
+#define OMEGA_CONCURRENT_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/bit_ops.hpp"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace omega
+{
+    // Append-only vector for many writers. push_back and grow_by reserve
+    // their indices with one fetch_add and never take a lock. Storage is a
+    // table of segments that double in size, so growing never moves an
+    // element and a reference stays valid until clear().
+    //
+    // Each element has a ready flag that is set with release once it is
+    // constructed; ready() and at() read it with acquire, so any thread may
+    // read an index it saw published. size() counts reserved indices,
+    // including ones still being constructed. An element whose constructor
+    // threw stays a hole that ready() reports as false. The allocator must be
+    // safe to call from several threads.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class concurrent_vector
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using flag_type = std::atomic<unsigned char>;
+        using flag_allocator = typename alloc_traits::template rebind_alloc<flag_type>;
+        using flag_traits = std::allocator_traits<flag_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = T*;
+        using const_pointer = const T*;
+
+        // Segment k holds FIRST_SEGMENT << k elements
+        static constexpr unsigned FIRST_SEGMENT_BITS = 5;
+        static constexpr size_type FIRST_SEGMENT = size_type{ 1 } << FIRST_SEGMENT_BITS;
+        static constexpr size_type SEGMENTS = 64 - FIRST_SEGMENT_BITS;
+
+        concurrent_vector() noexcept(noexcept(allocator_type())) = default;
+
+        explicit concurrent_vector(const allocator_type& alloc) noexcept
+            : m_allocator{ alloc }
+        {
+        }
+
+        concurrent_vector(const concurrent_vector&) = delete;
+        concurrent_vector& operator = (const concurrent_vector&) = delete;
+
+        ~concurrent_vector()
+        {
+            clear();
+        }
+
+        // Returns the index of the new element
+        size_type push_back(const_reference value)
+        {
+            return emplace_back(value);
+        }
+
+        size_type push_back(value_type&& value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        template<typename... Args>
+        size_type emplace_back(Args&&... args)
+        {
+            const auto index = m_size.fetch_add(1, std::memory_order_relaxed);
+            const auto segment = segment_of(index);
+            construct(segment_values(segment), segment_flags(segment), index - segment_base(segment)
+                      , std::forward<Args>(args)...);
+            return index;
+        }
+
+        // Reserves count consecutive indices with a single fetch_add and
+        // value-initializes them; returns the first one
+        size_type grow_by(size_type count)
+        {
+            return grow_by_internal(count);
+        }
+
+        size_type grow_by(size_type count, const_reference value)
+        {
+            return grow_by_internal(count, value);
+        }
+
+        bool ready(size_type index) const noexcept
+        {
+            if (index >= size())
+            {
+                return false;
+            }
+
+            const auto segment = segment_of(index);
+            const auto flags = m_flags[segment].load(std::memory_order_acquire);
+            return flags && flags[index - segment_base(segment)].load(std::memory_order_acquire);
+        }
+
+        // The index must be published to the calling thread
+        reference operator[](size_type index)
+        {
+            const auto segment = segment_of(index);
+            return m_values[segment].load(std::memory_order_acquire)[index - segment_base(segment)];
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            const auto segment = segment_of(index);
+            return m_values[segment].load(std::memory_order_acquire)[index - segment_base(segment)];
+        }
+
+        // Throws std::out_of_range unless the element is constructed
+        reference at(size_type index)
+        {
+            check_ready(index);
+            return (*this)[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            check_ready(index);
+            return (*this)[index];
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        // Copies the constructed elements in index order, segment by segment.
+        // Not safe while other threads append.
+        vector<T, Allocator> to_vector() const
+        {
+            vector<T, Allocator> result( m_allocator );
+            const auto count = size();
+            result.reserve(count);
+            for (size_type segment = 0; segment_base(segment) < count; ++segment)
+            {
+                const auto values = m_values[segment].load(std::memory_order_acquire);
+                const auto flags = m_flags[segment].load(std::memory_order_acquire);
+                const auto used = segment_used(segment, count);
+                for (size_type i = 0; values && flags && i < used; ++i)
+                {
+                    if (flags[i].load(std::memory_order_relaxed))
+                    {
+                        result.push_back(values[i]);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        // Destroys the elements and frees every segment. Not safe while other
+        // threads use the vector.
+        void clear() noexcept
+        {
+            const auto count = size();
+            for (size_type segment = 0; segment < SEGMENTS; ++segment)
+            {
+                const auto values = m_values[segment].load(std::memory_order_acquire);
+                const auto flags = m_flags[segment].load(std::memory_order_acquire);
+                const auto capacity = segment_size(segment);
+                if (values)
+                {
+                    const auto used = segment_used(segment, count);
+                    for (size_type i = 0; flags && i < used; ++i)
+                    {
+                        if (flags[i].load(std::memory_order_relaxed))
+                        {
+                            alloc_traits::destroy(m_allocator, values + i);
+                        }
+                    }
+                    alloc_traits::deallocate(m_allocator, values, capacity);
+                    m_values[segment].store(nullptr, std::memory_order_relaxed);
+                }
+
+                if (flags)
+                {
+                    destroy_flags(flags, capacity);
+                    m_flags[segment].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            m_size.store(0, std::memory_order_release);
+        }
+
+    private:
+        static size_type segment_of(size_type index) noexcept
+        {
+            return bit_ops::floor_log2(index + FIRST_SEGMENT) - FIRST_SEGMENT_BITS;
+        }
+
+        static size_type segment_base(size_type segment) noexcept
+        {
+            return (FIRST_SEGMENT << segment) - FIRST_SEGMENT;
+        }
+
+        static size_type segment_size(size_type segment) noexcept
+        {
+            return FIRST_SEGMENT << segment;
+        }
+
+        // Reserved slots of the segment when count indices are reserved in total
+        static size_type segment_used(size_type segment, size_type count) noexcept
+        {
+            const auto base = segment_base(segment);
+            if (count <= base)
+            {
+                return 0;
+            }
+
+            return count - base < segment_size(segment) ? count - base : segment_size(segment);
+        }
+
+        // The first thread to need a segment installs it with a CAS; a thread
+        // that loses the race frees its copy and uses the winner's
+        pointer segment_values(size_type segment)
+        {
+            auto values = m_values[segment].load(std::memory_order_acquire);
+            if (values)
+            {
+                return values;
+            }
+
+            const auto fresh = alloc_traits::allocate(m_allocator, segment_size(segment));
+            if (m_values[segment].compare_exchange_strong(values, fresh, std::memory_order_acq_rel
+                                                          , std::memory_order_acquire))
+            {
+                return fresh;
+            }
+
+            alloc_traits::deallocate(m_allocator, fresh, segment_size(segment));
+            return values;
+        }
+
+        flag_type* segment_flags(size_type segment)
+        {
+            auto flags = m_flags[segment].load(std::memory_order_acquire);
+            if (flags)
+            {
+                return flags;
+            }
+
+            const auto capacity = segment_size(segment);
+            flag_allocator alloc{ m_allocator };
+            const auto fresh = flag_traits::allocate(alloc, capacity);
+            for (size_type i = 0; i < capacity; ++i)
+            {
+                flag_traits::construct(alloc, fresh + i, static_cast<unsigned char>(0));
+            }
+
+            if (m_flags[segment].compare_exchange_strong(flags, fresh, std::memory_order_acq_rel
+                                                         , std::memory_order_acquire))
+            {
+                return fresh;
+            }
+
+            destroy_flags(fresh, capacity);
+            return flags;
+        }
+
+        void destroy_flags(flag_type* flags, size_type capacity) noexcept
+        {
+            flag_allocator alloc{ m_allocator };
+            for (size_type i = 0; i < capacity; ++i)
+            {
+                flag_traits::destroy(alloc, flags + i);
+            }
+            flag_traits::deallocate(alloc, flags, capacity);
+        }
+
+        template<typename... Args>
+        void construct(pointer values, flag_type* flags, size_type offset, Args&&... args)
+        {
+            alloc_traits::construct(m_allocator, values + offset, std::forward<Args>(args)...);
+            flags[offset].store(1, std::memory_order_release);
+        }
+
+        template<typename... Args>
+        size_type grow_by_internal(size_type count, Args&&... args)
+        {
+            const auto first = m_size.fetch_add(count, std::memory_order_relaxed);
+            const auto last = first + count;
+            auto index = first;
+            while (index < last)
+            {
+                const auto segment = segment_of(index);
+                const auto values = segment_values(segment);
+                const auto flags = segment_flags(segment);
+                const auto base = segment_base(segment);
+                const auto end = base + segment_size(segment) < last ? base + segment_size(segment) : last;
+                for (; index < end; ++index)
+                {
+                    construct(values, flags, index - base, args...);
+                }
+            }
+
+            return first;
+        }
+
+        void check_ready(size_type index) const
+        {
+            if (!ready(index))
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        static constexpr size_type CACHE_LINE = 64;
+
+        allocator_type m_allocator = allocator_type{};
+        std::atomic<pointer> m_values[SEGMENTS] = {};
+        std::atomic<flag_type*> m_flags[SEGMENTS] = {};
+        // keeps the contended counter off the lines of the segment table
+        unsigned char m_padding[CACHE_LINE] = {};
+        std::atomic<size_type> m_size{ 0 };
+        unsigned char m_tail_padding[CACHE_LINE - sizeof(std::atomic<size_type>)] = {};
+    };
+
+    template<typename T, typename Allocator>
+    constexpr unsigned concurrent_vector<T, Allocator>::FIRST_SEGMENT_BITS;
+
+    template<typename T, typename Allocator>
+    constexpr typename concurrent_vector<T, Allocator>::size_type concurrent_vector<T, Allocator>::FIRST_SEGMENT;
+
+    template<typename T, typename Allocator>
+    constexpr typename concurrent_vector<T, Allocator>::size_type concurrent_vector<T, Allocator>::SEGMENTS;
+
+    template<typename T, typename Allocator>
+    constexpr typename concurrent_vector<T, Allocator>::size_type concurrent_vector<T, Allocator>::CACHE_LINE;
+}
+
+#endif //OMEGA_CONCURRENT_VECTOR_HPP
@@ -0,0 +1,661 @@
+#ifndef OMEGA_COW_VECTOR_HPP
+#define OMEGA_COW_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/random_access_iterator.hpp"
+#include <atomic>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace omega
+{
+    // Copy-on-write vector. Copies share one buffer whose reference count,
+    // size and capacity live in a header at the front of the same allocation,
+    // so a copy is one atomic increment. The first mutation through a shared
+    // copy clones the buffer in a single pass.
+    //
+    // Non-const element access (operator[], at, data, begin, ...) detaches
+    // and also marks the buffer unshareable: later copies deep-copy it, so a
+    // reference handed out earlier can never write into a copy. Use cbegin()
+    // or a const reference for reads that should keep the buffer shared.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class cow_vector
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        struct header
+        {
+            explicit header(size_t block_capacity) noexcept
+                : capacity{ block_capacity }
+            {
+            }
+
+            std::atomic<size_t> refs{ 1 };
+            size_t size = 0;
+            size_t capacity;
+            bool shareable = true;
+        };
+
+        static constexpr size_t BLOCK_ALIGN = alignof(T) > alignof(header) ? alignof(T) : alignof(header);
+        static constexpr size_t DATA_OFFSET = (sizeof(header) + alignof(T) - 1) / alignof(T) * alignof(T);
+        using unit = typename std::aligned_storage<BLOCK_ALIGN, BLOCK_ALIGN>::type;
+        using unit_allocator = typename alloc_traits::template rebind_alloc<unit>;
+        using unit_traits = std::allocator_traits<unit_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using const_iterator = random_access_iterator<T>;
+        using iterator = random_access_iterator<T, false>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+        cow_vector() noexcept(noexcept(allocator_type())) = default;
+
+        explicit cow_vector(const allocator_type& alloc) noexcept
+            : m_allocator{ alloc }
+        {
+        }
+
+        template<typename It>
+        cow_vector(It first, It last, const allocator_type& alloc = allocator_type{})
+            : m_allocator{ alloc }
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            if (!count)
+            {
+                return;
+            }
+
+            auto block = allocate_block(count);
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    alloc_traits::construct(m_allocator, data_of(block) + block->size, *first);
+                    ++block->size;
+                }
+            }
+            catch (...)
+            {
+                destroy_block(block);
+                throw;
+            }
+            m_block = block;
+        }
+
+        cow_vector(std::initializer_list<T> list, const allocator_type& alloc = allocator_type{})
+            : cow_vector( list.begin(), list.end(), alloc )
+        {
+        }
+
+        explicit cow_vector(const vector<T, Allocator>& values)
+            : cow_vector( values.begin(), values.end() )
+        {
+        }
+
+        // Shares the buffer unless the allocators differ or it was made unshareable
+        cow_vector(const cow_vector& rhs)
+            : m_allocator{ alloc_traits::select_on_container_copy_construction(rhs.m_allocator) }
+            , m_block{ share_or_copy(rhs) }
+        {
+        }
+
+        cow_vector(const cow_vector& rhs, const allocator_type& alloc)
+            : m_allocator{ alloc }
+            , m_block{ share_or_copy(rhs) }
+        {
+        }
+
+        cow_vector(cow_vector&& rhs) noexcept
+            : m_allocator{ std::move(rhs.m_allocator) }
+            , m_block{ rhs.m_block }
+        {
+            rhs.m_block = nullptr;
+        }
+
+        cow_vector(cow_vector&& rhs, const allocator_type& alloc)
+            : m_allocator{ alloc }
+        {
+            if (m_allocator == rhs.m_allocator)
+            {
+                m_block = rhs.m_block;
+                rhs.m_block = nullptr;
+                return;
+            }
+
+            m_block = share_or_copy(rhs);
+        }
+
+        cow_vector& operator = (const cow_vector& rhs)
+        {
+            if (this == &rhs)
+            {
+                return *this;
+            }
+
+            if (alloc_traits::propagate_on_container_copy_assignment::value && m_allocator != rhs.m_allocator)
+            {
+                release();
+                m_allocator = rhs.m_allocator;
+            }
+
+            const auto block = share_or_copy(rhs);
+            release();
+            m_block = block;
+            return *this;
+        }
+
+        cow_vector& operator = (cow_vector&& rhs)
+        {
+            if (this == &rhs)
+            {
+                return *this;
+            }
+
+            if (alloc_traits::propagate_on_container_move_assignment::value || m_allocator == rhs.m_allocator)
+            {
+                release();
+                if (m_allocator != rhs.m_allocator)
+                {
+                    m_allocator = std::move(rhs.m_allocator);
+                }
+                m_block = rhs.m_block;
+                rhs.m_block = nullptr;
+                return *this;
+            }
+
+            const auto block = share_or_copy(rhs);
+            release();
+            m_block = block;
+            return *this;
+        }
+
+        ~cow_vector()
+        {
+            release();
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(value_type&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        // The new element is built before the old ones move, so value may
+        // refer into this vector
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            const auto count = size();
+            if (unique() && count < capacity())
+            {
+                alloc_traits::construct(m_allocator, data_of(m_block) + count, std::forward<Args>(args)...);
+                ++m_block->size;
+                return;
+            }
+
+            const auto new_capacity = count < capacity() ? capacity() : capacity() * 2 + 1;
+            auto block = allocate_block(new_capacity);
+            try
+            {
+                alloc_traits::construct(m_allocator, data_of(block) + count, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                destroy_block(block);
+                throw;
+            }
+
+            try
+            {
+                transfer(block, count);
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(m_allocator, data_of(block) + count);
+                destroy_block(block);
+                throw;
+            }
+
+            ++block->size;
+            release();
+            m_block = block;
+        }
+
+        void pop_back()
+        {
+            resize_down(size() - 1);
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity())
+            {
+                reallocate(new_capacity, size());
+            }
+        }
+
+        void resize(size_type count)
+        {
+            resize_internal(count);
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            resize_internal(count, value);
+        }
+
+        // A shared buffer is only let go of, never cloned
+        void clear() noexcept
+        {
+            if (!unique())
+            {
+                release();
+                return;
+            }
+
+            destroy_elements(m_block);
+        }
+
+        // Clones a shared buffer now instead of on the next mutation
+        void detach()
+        {
+            if (m_block && !unique())
+            {
+                reallocate(capacity(), size());
+            }
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return data()[index];
+        }
+
+        reference operator[](size_type index)
+        {
+            return data()[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            check_index(index);
+            return data()[index];
+        }
+
+        reference at(size_type index)
+        {
+            check_index(index);
+            return data()[index];
+        }
+
+        const_pointer data() const noexcept
+        {
+            return m_block ? data_of(m_block) : nullptr;
+        }
+
+        pointer data()
+        {
+            detach();
+            if (!m_block)
+            {
+                return nullptr;
+            }
+
+            m_block->shareable = false;
+            return data_of(m_block);
+        }
+
+        const_reference front() const
+        {
+            return data()[0];
+        }
+
+        reference front()
+        {
+            return data()[0];
+        }
+
+        const_reference back() const
+        {
+            return data()[size() - 1];
+        }
+
+        reference back()
+        {
+            return data()[size() - 1];
+        }
+
+        iterator begin()
+        {
+            return iterator{ data() };
+        }
+
+        iterator end()
+        {
+            const auto first = data();
+            return iterator{ first + size() };
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ data() };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ data() + size() };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin()
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend()
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_block ? m_block->size : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return m_block ? m_block->capacity : 0;
+        }
+
+        // Number of cow_vectors sharing the buffer, 0 without one
+        size_type use_count() const noexcept
+        {
+            return m_block ? m_block->refs.load(std::memory_order_acquire) : 0;
+        }
+
+        void swap(cow_vector& rhs) noexcept
+        {
+            using std::swap;
+            if (alloc_traits::propagate_on_container_swap::value && m_allocator != rhs.m_allocator)
+            {
+                swap(m_allocator, rhs.m_allocator);
+            }
+
+            std::swap(m_block, rhs.m_block);
+        }
+
+    private:
+        static pointer data_of(header* block) noexcept
+        {
+            return reinterpret_cast<pointer>(reinterpret_cast<unsigned char*>(block) + DATA_OFFSET);
+        }
+
+        static size_type units_for(size_type capacity) noexcept
+        {
+            return (DATA_OFFSET + capacity * sizeof(T) + BLOCK_ALIGN - 1) / BLOCK_ALIGN;
+        }
+
+        // The acquire pairs with the release in release(), so writes after a
+        // unique() check cannot overtake reads made through another copy
+        bool unique() const noexcept
+        {
+            return m_block && m_block->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        header* allocate_block(size_type capacity)
+        {
+            unit_allocator alloc{ m_allocator };
+            const auto memory = unit_traits::allocate(alloc, units_for(capacity));
+            return ::new (static_cast<void*>(memory)) header{ capacity };
+        }
+
+        // Frees a block that holds no elements
+        void destroy_block(header* block) noexcept
+        {
+            const auto units = units_for(block->capacity);
+            block->~header();
+            unit_allocator alloc{ m_allocator };
+            unit_traits::deallocate(alloc, reinterpret_cast<unit*>(block), units);
+        }
+
+        void destroy_elements(header* block) noexcept
+        {
+            const auto first = data_of(block);
+            for (size_type i = 0; i < block->size; ++i)
+            {
+                alloc_traits::destroy(m_allocator, first + i);
+            }
+            block->size = 0;
+        }
+
+        void release() noexcept
+        {
+            if (m_block && m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                destroy_elements(m_block);
+                destroy_block(m_block);
+            }
+            m_block = nullptr;
+        }
+
+        header* share_or_copy(const cow_vector& rhs)
+        {
+            if (!rhs.m_block)
+            {
+                return nullptr;
+            }
+
+            if (rhs.m_block->shareable && m_allocator == rhs.m_allocator)
+            {
+                rhs.m_block->refs.fetch_add(1, std::memory_order_relaxed);
+                return rhs.m_block;
+            }
+
+            auto block = allocate_block(rhs.m_block->size);
+            try
+            {
+                copy_elements(data_of(rhs.m_block), rhs.m_block->size, block);
+            }
+            catch (...)
+            {
+                destroy_block(block);
+                throw;
+            }
+            return block;
+        }
+
+        // Copies count elements into an empty block in one pass; on failure
+        // the block is left empty again
+        void copy_elements(const_pointer source, size_type count, header* block)
+        {
+            copy_elements(source, count, block, std::integral_constant<bool, std::is_trivially_copyable<T>::value>{});
+        }
+
+        void copy_elements(const_pointer source, size_type count, header* block, std::true_type) noexcept
+        {
+            if (count)
+            {
+                std::memcpy(static_cast<void*>(data_of(block)), source, count * sizeof(T));
+            }
+            block->size = count;
+        }
+
+        void copy_elements(const_pointer source, size_type count, header* block, std::false_type)
+        {
+            try
+            {
+                for (size_type i = 0; i < count; ++i)
+                {
+                    alloc_traits::construct(m_allocator, data_of(block) + i, source[i]);
+                    ++block->size;
+                }
+            }
+            catch (...)
+            {
+                destroy_elements(block);
+                throw;
+            }
+        }
+
+        // Moves the first count elements into block when the buffer is ours,
+        // copies them when it is shared
+        void transfer(header* block, size_type count)
+        {
+            if (!count)
+            {
+                return;
+            }
+
+            if (!unique() || std::is_trivially_copyable<T>::value)
+            {
+                copy_elements(data_of(m_block), count, block);
+                return;
+            }
+
+            const auto source = data_of(m_block);
+            try
+            {
+                for (size_type i = 0; i < count; ++i)
+                {
+                    alloc_traits::construct(m_allocator, data_of(block) + i, std::move_if_noexcept(source[i]));
+                    ++block->size;
+                }
+            }
+            catch (...)
+            {
+                destroy_elements(block);
+                throw;
+            }
+        }
+
+        void reallocate(size_type new_capacity, size_type count)
+        {
+            auto block = allocate_block(new_capacity);
+            try
+            {
+                transfer(block, count);
+            }
+            catch (...)
+            {
+                destroy_block(block);
+                throw;
+            }
+
+            release();
+            m_block = block;
+        }
+
+        void resize_down(size_type count)
+        {
+            if (!unique())
+            {
+                reallocate(capacity(), count);
+                return;
+            }
+
+            const auto first = data_of(m_block);
+            for (auto i = count; i < m_block->size; ++i)
+            {
+                alloc_traits::destroy(m_allocator, first + i);
+            }
+            m_block->size = count;
+        }
+
+        template<typename... Args>
+        void resize_internal(size_type count, Args&&... args)
+        {
+            if (count <= size())
+            {
+                if (count < size())
+                {
+                    resize_down(count);
+                }
+                return;
+            }
+
+            if (!unique() || capacity() < count)
+            {
+                reallocate(count > capacity() ? count : capacity(), size());
+            }
+
+            const auto first = data_of(m_block);
+            const auto old_size = m_block->size;
+            try
+            {
+                for (; m_block->size < count; ++m_block->size)
+                {
+                    alloc_traits::construct(m_allocator, first + m_block->size, std::forward<Args>(args)...);
+                }
+            }
+            catch (...)
+            {
+                for (auto i = old_size; i < m_block->size; ++i)
+                {
+                    alloc_traits::destroy(m_allocator, first + i);
+                }
+                m_block->size = old_size;
+                throw;
+            }
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        allocator_type m_allocator = allocator_type{};
+        header* m_block = nullptr;
+    };
+
+    template<typename T, typename Allocator>
+    constexpr size_t cow_vector<T, Allocator>::BLOCK_ALIGN;
+
+    template<typename T, typename Allocator>
+    constexpr size_t cow_vector<T, Allocator>::DATA_OFFSET;
+}
+
+#endif //OMEGA_COW_VECTOR_HPP
@@ -0,0 +1,497 @@
+#ifndef OMEGA_FLAT_MAP_HPP
+#define OMEGA_FLAT_MAP_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/flat_map_iterator.hpp"
+#include "vector_helpers/sorted_merge.hpp"
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace omega
+{
+    // Sorted map over two parallel omega::vectors, one for keys and one for
+    // values, so key lookups only touch the keys. Range inserts append, sort
+    // the new entries and merge them into place: building from n entries is
+    // O(n log n).
+    template<typename Key, typename T, typename Compare = std::less<Key>
+             , typename KeyAllocator = std::allocator<Key>, typename MappedAllocator = std::allocator<T>>
+    class flat_map
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using key_compare = Compare;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, T&>;
+        using const_reference = std::pair<const Key&, const T&>;
+        using key_container_type = vector<Key, KeyAllocator>;
+        using mapped_container_type = vector<T, MappedAllocator>;
+        using iterator = flat_map_iterator<Key, T, false>;
+        using const_iterator = flat_map_iterator<Key, T>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        struct containers
+        {
+            key_container_type keys;
+            mapped_container_type values;
+        };
+
+        flat_map() = default;
+
+        explicit flat_map(const key_compare& comp)
+            : m_compare{ comp }
+        {
+        }
+
+        // Takes over unsorted keys and their values
+        flat_map(key_container_type keys, mapped_container_type values, const key_compare& comp = key_compare{})
+            : m_keys( std::move(keys) )
+            , m_values( std::move(values) )
+            , m_compare{ comp }
+        {
+            check_sizes();
+            sort_and_merge(0);
+        }
+
+        template<typename InputIt>
+        flat_map(InputIt first, InputIt last, const key_compare& comp = key_compare{})
+            : flat_map{ comp }
+        {
+            insert(first, last);
+        }
+
+        flat_map(std::initializer_list<value_type> list, const key_compare& comp = key_compare{})
+            : flat_map{ comp }
+        {
+            insert(list.begin(), list.end());
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        // Appends the range, sorts it and merges it into the existing entries in
+        // place; for forward iterators each vector reallocates once at most
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            const auto old_size = size();
+            append(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+            sort_and_merge(old_size);
+        }
+
+        void insert(std::initializer_list<value_type> list)
+        {
+            insert(list.begin(), list.end());
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            return try_emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+        {
+            return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        mapped_type& operator[](const key_type& key)
+        {
+            return (*try_emplace(key).first).second;
+        }
+
+        mapped_type& operator[](key_type&& key)
+        {
+            return (*try_emplace(std::move(key)).first).second;
+        }
+
+        mapped_type& at(const key_type& key)
+        {
+            return m_values[checked_index(key)];
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            return m_values[checked_index(key)];
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            const auto index = pos.index();
+            m_keys.erase(m_keys.cbegin() + index);
+            m_values.erase(m_values.cbegin() + index);
+            return make_iterator(index);
+        }
+
+        size_type erase(const key_type& key)
+        {
+            const auto index = find_index(key);
+            if (index == size())
+            {
+                return 0;
+            }
+
+            erase(make_iterator(index));
+            return 1;
+        }
+
+        iterator find(const key_type& key)
+        {
+            return make_iterator(find_index(key));
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            return make_iterator(find_index(key));
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find_index(key) != size();
+        }
+
+        size_type count(const key_type& key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        iterator lower_bound(const key_type& key)
+        {
+            return make_iterator(lower_bound_index(key));
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return make_iterator(lower_bound_index(key));
+        }
+
+        iterator upper_bound(const key_type& key)
+        {
+            return make_iterator(upper_bound_index(key));
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            return make_iterator(upper_bound_index(key));
+        }
+
+        const key_container_type& keys() const noexcept
+        {
+            return m_keys;
+        }
+
+        const mapped_container_type& values() const noexcept
+        {
+            return m_values;
+        }
+
+        // Moves both vectors out, leaving the map empty
+        containers extract() &&
+        {
+            containers result{ std::move(m_keys), std::move(m_values) };
+            m_keys.clear();
+            m_values.clear();
+            return result;
+        }
+
+        // Takes over keys that are already sorted and unique, with their values
+        void replace(key_container_type&& keys, mapped_container_type&& values)
+        {
+            if (keys.size() != values.size())
+            {
+                throw std::invalid_argument("keys and values of different size");
+            }
+
+            m_keys = std::move(keys);
+            m_values = std::move(values);
+        }
+
+        iterator begin() noexcept
+        {
+            return make_iterator(0);
+        }
+
+        iterator end() noexcept
+        {
+            return make_iterator(size());
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return make_iterator(0);
+        }
+
+        const_iterator end() const noexcept
+        {
+            return make_iterator(size());
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_keys.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_keys.empty();
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            m_keys.reserve(new_capacity);
+            m_values.reserve(new_capacity);
+        }
+
+        void clear() noexcept
+        {
+            m_keys.clear();
+            m_values.clear();
+        }
+
+        key_compare key_comp() const
+        {
+            return m_compare;
+        }
+
+        void swap(flat_map& rhs) noexcept
+        {
+            m_keys.swap(rhs.m_keys);
+            m_values.swap(rhs.m_values);
+            std::swap(m_compare, rhs.m_compare);
+        }
+
+    private:
+        iterator make_iterator(size_type index) noexcept
+        {
+            return iterator{ m_keys.data(), m_values.data(), static_cast<difference_type>(index) };
+        }
+
+        const_iterator make_iterator(size_type index) const noexcept
+        {
+            return const_iterator{ m_keys.data(), m_values.data(), static_cast<difference_type>(index) };
+        }
+
+        size_type lower_bound_index(const key_type& key) const
+        {
+            const auto keys = m_keys.data();
+            return static_cast<size_type>(std::lower_bound(keys, keys + size(), key, m_compare) - keys);
+        }
+
+        size_type upper_bound_index(const key_type& key) const
+        {
+            const auto keys = m_keys.data();
+            return static_cast<size_type>(std::upper_bound(keys, keys + size(), key, m_compare) - keys);
+        }
+
+        // size() when the key is missing
+        size_type find_index(const key_type& key) const
+        {
+            const auto index = lower_bound_index(key);
+            return index != size() && !m_compare(key, m_keys[index]) ? index : size();
+        }
+
+        size_type checked_index(const key_type& key) const
+        {
+            const auto index = find_index(key);
+            if (index == size())
+            {
+                throw std::out_of_range("key not found");
+            }
+
+            return index;
+        }
+
+        void check_sizes() const
+        {
+            if (m_keys.size() != m_values.size())
+            {
+                throw std::invalid_argument("keys and values of different size");
+            }
+        }
+
+        template<typename K, typename... Args>
+        std::pair<iterator, bool> try_emplace_key(K&& key, Args&&... args)
+        {
+            const auto index = lower_bound_index(key);
+            if (index != size() && !m_compare(key, m_keys[index]))
+            {
+                return std::make_pair(make_iterator(index), false);
+            }
+
+            m_keys.insert(m_keys.cbegin() + index, std::forward<K>(key));
+            try
+            {
+                m_values.emplace(m_values.cbegin() + index, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                m_keys.erase(m_keys.cbegin() + index);
+                throw;
+            }
+
+            return std::make_pair(make_iterator(index), true);
+        }
+
+        template<typename InputIt>
+        void append(InputIt first, InputIt last, std::input_iterator_tag)
+        {
+            for (; first != last; ++first)
+            {
+                auto&& item = *first;
+                m_keys.emplace_back(item.first);
+                try
+                {
+                    m_values.emplace_back(item.second);
+                }
+                catch (...)
+                {
+                    m_keys.pop_back();
+                    throw;
+                }
+            }
+        }
+
+        template<typename ForwardIt>
+        void append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+        {
+            reserve(size() + static_cast<size_type>(std::distance(first, last)));
+            append(first, last, std::input_iterator_tag{});
+        }
+
+        // [0, old_size) is sorted and unique, the entries after it are new
+        void sort_and_merge(size_type old_size)
+        {
+            const auto keys = m_keys.data();
+            const auto values = m_values.data();
+            const auto count = size();
+
+            sort_tail(keys + old_size, values + old_size, count - old_size);
+            merge_sorted_runs(keys, 0, old_size, count, m_compare
+                              , [keys, values](size_t first, size_t middle, size_t last) {
+                std::rotate(keys + first, keys + middle, keys + last);
+                std::rotate(values + first, values + middle, values + last);
+            });
+
+            // the merge is stable, so an existing key wins over a new one
+            size_type unique_end = 0;
+            for (size_type i = 0; i < count; ++i)
+            {
+                if (i == 0 || m_compare(keys[unique_end - 1], keys[i]))
+                {
+                    if (unique_end != i)
+                    {
+                        keys[unique_end] = std::move(keys[i]);
+                        values[unique_end] = std::move(values[i]);
+                    }
+                    ++unique_end;
+                }
+            }
+
+            m_keys.erase(m_keys.cbegin() + unique_end, m_keys.cend());
+            m_values.erase(m_values.cbegin() + unique_end, m_values.cend());
+        }
+
+        // Sorts the new entries through a permutation of indices, then applies
+        // it to both arrays by following its cycles. Equal keys keep their
+        // insertion order so the first one inserted survives.
+        template<typename KeyPointer, typename ValuePointer>
+        void sort_tail(KeyPointer keys, ValuePointer values, size_type count)
+        {
+            if (count < 2)
+            {
+                return;
+            }
+
+            vector<size_type> order;
+            order.reserve(count);
+            for (size_type i = 0; i < count; ++i)
+            {
+                order.push_back(i);
+            }
+
+            const auto comp = m_compare;
+            std::sort(order.begin(), order.end(), [comp, keys](size_type lhs, size_type rhs) {
+                return comp(keys[lhs], keys[rhs]) || (!comp(keys[rhs], keys[lhs]) && lhs < rhs);
+            });
+
+            for (size_type i = 0; i < count; ++i)
+            {
+                if (order[i] == i)
+                {
+                    continue;
+                }
+
+                auto key = std::move(keys[i]);
+                auto value = std::move(values[i]);
+                auto current = i;
+                for (;;)
+                {
+                    const auto next = order[current];
+                    order[current] = current;
+                    if (next == i)
+                    {
+                        keys[current] = std::move(key);
+                        values[current] = std::move(value);
+                        break;
+                    }
+
+                    keys[current] = std::move(keys[next]);
+                    values[current] = std::move(values[next]);
+                    current = next;
+                }
+            }
+        }
+
+        key_container_type m_keys;
+        mapped_container_type m_values;
+        key_compare m_compare = key_compare{};
+    };
+}
+
+#endif //OMEGA_FLAT_MAP_HPP
@@ -0,0 +1,278 @@
+#ifndef OMEGA_FLAT_SET_HPP
+#define OMEGA_FLAT_SET_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/sorted_merge.hpp"
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace omega
+{
+    // Sorted set over an omega::vector. Lookups are binary searches over
+    // contiguous keys; a range insert appends, sorts the new keys and merges
+    // them into place, so building from n keys is O(n log n).
+    template<typename Key, typename Compare = std::less<Key>, typename Allocator = std::allocator<Key>>
+    class flat_set
+    {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using allocator_type = Allocator;
+        using container_type = vector<Key, Allocator>;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type&;
+        using const_reference = const value_type&;
+        using const_iterator = typename container_type::const_iterator;
+        using iterator = const_iterator;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = const_reverse_iterator;
+
+        flat_set() = default;
+
+        explicit flat_set(const key_compare& comp, const allocator_type& alloc = allocator_type{})
+            : m_keys( alloc )
+            , m_compare{ comp }
+        {
+        }
+
+        explicit flat_set(const allocator_type& alloc)
+            : m_keys( alloc )
+        {
+        }
+
+        template<typename InputIt>
+        flat_set(InputIt first, InputIt last, const key_compare& comp = key_compare{}
+                 , const allocator_type& alloc = allocator_type{})
+            : flat_set{ comp, alloc }
+        {
+            insert(first, last);
+        }
+
+        flat_set(std::initializer_list<Key> list, const key_compare& comp = key_compare{}
+                 , const allocator_type& alloc = allocator_type{})
+            : flat_set{ comp, alloc }
+        {
+            insert(list.begin(), list.end());
+        }
+
+        // Takes over an unsorted vector of keys
+        explicit flat_set(container_type keys, const key_compare& comp = key_compare{})
+            : m_keys( std::move(keys) )
+            , m_compare{ comp }
+        {
+            sort_and_merge(0);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return insert_unique(value);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return insert_unique(std::move(value));
+        }
+
+        // Appends the range, sorts it and merges it into the existing keys in place;
+        // for forward iterators the keys grow with a single reallocation at most
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            const auto old_size = m_keys.size();
+            append(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+            sort_and_merge(old_size);
+        }
+
+        void insert(std::initializer_list<Key> list)
+        {
+            insert(list.begin(), list.end());
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return m_keys.erase(pos);
+        }
+
+        size_type erase(const key_type& key)
+        {
+            const auto pos = find(key);
+            if (pos == end())
+            {
+                return 0;
+            }
+
+            m_keys.erase(pos);
+            return 1;
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            auto pos = lower_bound(key);
+            return pos != end() && !m_compare(key, *pos) ? pos : end();
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find(key) != end();
+        }
+
+        size_type count(const key_type& key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return std::lower_bound(begin(), end(), key, m_compare);
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            return std::upper_bound(begin(), end(), key, m_compare);
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return std::equal_range(begin(), end(), key, m_compare);
+        }
+
+        // Moves the sorted keys out, leaving the set empty
+        container_type extract() &&
+        {
+            container_type keys( std::move(m_keys) );
+            m_keys.clear();
+            return keys;
+        }
+
+        // Takes over keys that are already sorted and unique
+        void replace(container_type&& keys)
+        {
+            m_keys = std::move(keys);
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return m_keys.begin();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return m_keys.end();
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return m_keys.cbegin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return m_keys.cend();
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return m_keys.rbegin();
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return m_keys.rend();
+        }
+
+        size_type size() const noexcept
+        {
+            return m_keys.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_keys.empty();
+        }
+
+        size_type capacity() const noexcept
+        {
+            return m_keys.capacity();
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            m_keys.reserve(new_capacity);
+        }
+
+        void clear() noexcept
+        {
+            m_keys.clear();
+        }
+
+        key_compare key_comp() const
+        {
+            return m_compare;
+        }
+
+        void swap(flat_set& rhs) noexcept
+        {
+            m_keys.swap(rhs.m_keys);
+            std::swap(m_compare, rhs.m_compare);
+        }
+
+    private:
+        template<typename Value>
+        std::pair<iterator, bool> insert_unique(Value&& value)
+        {
+            auto pos = lower_bound(value);
+            if (pos != end() && !m_compare(value, *pos))
+            {
+                return std::make_pair(pos, false);
+            }
+
+            return std::make_pair(iterator{ m_keys.insert(pos, std::forward<Value>(value)) }, true);
+        }
+
+        template<typename InputIt>
+        void append(InputIt first, InputIt last, std::input_iterator_tag)
+        {
+            for (; first != last; ++first)
+            {
+                m_keys.emplace_back(*first);
+            }
+        }
+
+        template<typename ForwardIt>
+        void append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+        {
+            m_keys.reserve(m_keys.size() + static_cast<size_type>(std::distance(first, last)));
+            append(first, last, std::input_iterator_tag{});
+        }
+
+        // [0, old_size) is sorted and unique, the keys after it are new
+        void sort_and_merge(size_type old_size)
+        {
+            const auto keys = m_keys.data();
+            const auto size = m_keys.size();
+            std::sort(keys + old_size, keys + size, m_compare);
+            merge_sorted_runs(keys, 0, old_size, size, m_compare, [keys](size_t first, size_t middle, size_t last) {
+                std::rotate(keys + first, keys + middle, keys + last);
+            });
+
+            // the merge is stable, so a key that was already present wins over a new one
+            const auto comp = m_compare;
+            const auto unique_end = std::unique(keys, keys + size, [comp](const Key& lhs, const Key& rhs) {
+                return !comp(lhs, rhs);
+            });
+            m_keys.erase(m_keys.cbegin() + (unique_end - keys), m_keys.cend());
+        }
+
+        container_type m_keys;
+        key_compare m_compare = key_compare{};
+    };
+}
+
+#endif //OMEGA_FLAT_SET_HPP
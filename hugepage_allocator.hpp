@@ -0,0 +1,151 @@
+#ifndef OMEGA_HUGEPAGE_ALLOCATOR_HPP
+#define OMEGA_HUGEPAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace omega
+{
+    // Allocator that backs large blocks with 2 MB pages, so that random
+    // access over a big vector needs far fewer TLB entries. A block of at
+    // least Threshold bytes is mapped with MAP_HUGETLB when the system has
+    // reserved huge pages, and otherwise mapped 2 MB aligned and marked with
+    // madvise(MADV_HUGEPAGE) for transparent huge pages. Smaller blocks, and
+    // every block on systems other than Linux, come from operator new.
+    template<typename T, size_t Threshold = size_t{ 1 } << 21>
+    class hugepage_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t HUGE_PAGE = size_t{ 1 } << 21;
+        static constexpr size_t THRESHOLD = Threshold;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = hugepage_allocator<U, Threshold>;
+        };
+
+        hugepage_allocator() noexcept = default;
+
+        template<typename U>
+        hugepage_allocator(const hugepage_allocator<U, Threshold>&) noexcept
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            if (count > std::numeric_limits<size_type>::max() / sizeof(T) - HUGE_PAGE)
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                return static_cast<T*>(::operator new(bytes));
+            }
+
+#if defined(__linux__)
+            const auto length = round_up(bytes);
+            void* memory = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+            auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_HUGE_2MB)
+            flags |= MAP_HUGE_2MB;
+#endif
+            memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (memory != MAP_FAILED)
+            {
+                return static_cast<T*>(memory);
+            }
+#endif
+            // Map one huge page more than needed and cut both ends off so
+            // the block starts on a 2 MB boundary
+            memory = mmap(nullptr, length + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto raw = reinterpret_cast<uintptr_t>(memory);
+            const auto aligned = (raw + HUGE_PAGE - 1) & ~(uintptr_t{ HUGE_PAGE } - 1);
+            if (aligned != raw)
+            {
+                munmap(memory, aligned - raw);
+            }
+            const auto tail = raw + HUGE_PAGE - aligned;
+            if (tail)
+            {
+                munmap(reinterpret_cast<void*>(aligned + length), tail);
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+#endif
+            return reinterpret_cast<T*>(aligned);
+#endif
+        }
+
+        void deallocate(T* p, size_type count) noexcept
+        {
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                ::operator delete(p);
+                return;
+            }
+
+#if defined(__linux__)
+            munmap(p, round_up(bytes));
+#endif
+        }
+
+        // Whether a block of this many bytes is mapped in huge pages
+        static bool mapped(size_t bytes) noexcept
+        {
+#if defined(__linux__)
+            return bytes >= Threshold && bytes != 0;
+#else
+            return (void)bytes, false;
+#endif
+        }
+
+    private:
+        static size_t round_up(size_t bytes) noexcept
+        {
+            return (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        }
+    };
+
+    template<typename T, size_t Threshold>
+    constexpr size_t hugepage_allocator<T, Threshold>::HUGE_PAGE;
+
+    template<typename T, size_t Threshold>
+    constexpr size_t hugepage_allocator<T, Threshold>::THRESHOLD;
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator == (const hugepage_allocator<T, Threshold>&, const hugepage_allocator<U, Threshold>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator != (const hugepage_allocator<T, Threshold>&, const hugepage_allocator<U, Threshold>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //OMEGA_HUGEPAGE_ALLOCATOR_HPP
@@ -0,0 +1,482 @@
+#ifndef OMEGA_MAPPED_VECTOR_HPP
+#define OMEGA_MAPPED_VECTOR_HPP
+
+#include "vector_helpers/random_access_iterator.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace omega
+{
+    enum class mapped_mode
+    {
+        read_write,
+        read_only
+    };
+
+    // Vector of trivially copyable records that lives in a file mapped with
+    // MAP_SHARED. Opening maps the file and checks its header, so nothing is
+    // read or deserialized up front and pages come in as they are touched.
+    //
+    // The file starts with a 64 byte header: magic, version, element size,
+    // size and capacity. A file written on a machine of the other byte order
+    // fails the magic check. Growth extends the file with ftruncate and the
+    // mapping with mremap. Changes reach the page cache at once; flush()
+    // waits until they are on disk. System call failures, bad headers and
+    // writes through a read-only vector throw std::system_error.
+    template<typename T>
+    class mapped_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped_vector stores its elements as raw bytes");
+
+        struct header
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t element_size;
+            uint64_t size;
+            uint64_t capacity;
+        };
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using const_iterator = random_access_iterator<T>;
+        using iterator = random_access_iterator<T, false>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+        static constexpr uint64_t MAGIC = 0x524f434556474d4full;
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t DATA_OFFSET = 64;
+
+        static_assert(alignof(T) <= DATA_OFFSET, "elements must fit the alignment of the data offset");
+
+        // read_write creates the file when it does not exist
+        explicit mapped_vector(const std::string& path, mapped_mode mode = mapped_mode::read_write)
+            : m_mode{ mode }
+        {
+            const auto read_only = mode == mapped_mode::read_only;
+            m_fd = ::open(path.c_str(), read_only ? O_RDONLY | O_CLOEXEC : O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (m_fd < 0)
+            {
+                throw_errno("open " + path);
+            }
+
+            try
+            {
+                struct stat info;
+                if (fstat(m_fd, &info))
+                {
+                    throw_errno("fstat " + path);
+                }
+
+                m_length = static_cast<size_t>(info.st_size);
+                if (m_length == 0 && !read_only)
+                {
+                    create();
+                    return;
+                }
+
+                if (m_length < DATA_OFFSET)
+                {
+                    throw_format(path);
+                }
+
+                map(m_length);
+                const auto& head = *m_header;
+                if (head.magic != MAGIC || head.version != VERSION || head.element_size != sizeof(T)
+                    || head.size > head.capacity || head.capacity > (m_length - DATA_OFFSET) / sizeof(T))
+                {
+                    throw_format(path);
+                }
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        mapped_vector(const mapped_vector&) = delete;
+        mapped_vector& operator = (const mapped_vector&) = delete;
+
+        mapped_vector(mapped_vector&& rhs) noexcept
+            : m_header{ rhs.m_header }
+            , m_length{ rhs.m_length }
+            , m_fd{ rhs.m_fd }
+            , m_mode{ rhs.m_mode }
+        {
+            rhs.m_header = nullptr;
+            rhs.m_length = 0;
+            rhs.m_fd = -1;
+        }
+
+        mapped_vector& operator = (mapped_vector&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                release();
+                std::swap(m_header, rhs.m_header);
+                std::swap(m_length, rhs.m_length);
+                std::swap(m_fd, rhs.m_fd);
+                m_mode = rhs.m_mode;
+            }
+
+            return *this;
+        }
+
+        // Unmaps without msync; call flush() first for durability
+        ~mapped_vector()
+        {
+            release();
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        // The element is built before growth, which may move the mapping
+        template<typename... Args>
+        reference emplace_back(Args&&... args)
+        {
+            check_writable();
+            const value_type value( std::forward<Args>(args)... );
+            const auto count = size();
+            if (count == capacity())
+            {
+                reserve(count * 2 + 1);
+            }
+
+            std::memcpy(static_cast<void*>(data() + count), &value, sizeof(T));
+            m_header->size = count + 1;
+            return data()[count];
+        }
+
+        void pop_back()
+        {
+            check_writable();
+            --m_header->size;
+        }
+
+        void resize(size_type count)
+        {
+            resize(count, value_type{});
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            check_writable();
+            const auto fill = value;
+            reserve(count);
+            for (auto i = size(); i < count; ++i)
+            {
+                std::memcpy(static_cast<void*>(data() + i), &fill, sizeof(T));
+            }
+            m_header->size = count;
+        }
+
+        // Extends the file and the mapping to new_capacity elements
+        void reserve(size_type new_capacity)
+        {
+            check_writable();
+            if (new_capacity > capacity())
+            {
+                set_capacity(new_capacity);
+            }
+        }
+
+        // Truncates the file to the elements in use
+        void shrink_to_fit()
+        {
+            check_writable();
+            if (size() != capacity())
+            {
+                set_capacity(size());
+            }
+        }
+
+        void clear()
+        {
+            check_writable();
+            m_header->size = 0;
+        }
+
+        // Writes the dirty pages back and waits for the disk
+        void flush()
+        {
+            if (m_header && msync(m_header, m_length, MS_SYNC))
+            {
+                throw_errno("msync");
+            }
+        }
+
+        reference operator[](size_type index)
+        {
+            return data()[index];
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return data()[index];
+        }
+
+        reference at(size_type index)
+        {
+            check_index(index);
+            return data()[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            check_index(index);
+            return data()[index];
+        }
+
+        reference front()
+        {
+            return data()[0];
+        }
+
+        const_reference front() const
+        {
+            return data()[0];
+        }
+
+        reference back()
+        {
+            return data()[size() - 1];
+        }
+
+        const_reference back() const
+        {
+            return data()[size() - 1];
+        }
+
+        // Writing through a read-only vector faults
+        pointer data() noexcept
+        {
+            return reinterpret_cast<pointer>(reinterpret_cast<unsigned char*>(m_header) + DATA_OFFSET);
+        }
+
+        const_pointer data() const noexcept
+        {
+            return reinterpret_cast<const_pointer>(reinterpret_cast<const unsigned char*>(m_header) + DATA_OFFSET);
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator{ data() };
+        }
+
+        iterator end() noexcept
+        {
+            return iterator{ data() + size() };
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ data() };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ data() + size() };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_header ? static_cast<size_type>(m_header->size) : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return m_header ? static_cast<size_type>(m_header->capacity) : 0;
+        }
+
+        mapped_mode mode() const noexcept
+        {
+            return m_mode;
+        }
+
+    private:
+        [[noreturn]] static void throw_errno(const std::string& what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        [[noreturn]] static void throw_format(const std::string& path)
+        {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument)
+                                    , path + " is not a mapped_vector of this element type");
+        }
+
+        void check_writable() const
+        {
+            if (m_mode == mapped_mode::read_only)
+            {
+                throw std::system_error(std::make_error_code(std::errc::operation_not_permitted)
+                                        , "mapped_vector is read-only");
+            }
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        void create()
+        {
+            if (ftruncate(m_fd, DATA_OFFSET))
+            {
+                throw_errno("ftruncate");
+            }
+
+            map(DATA_OFFSET);
+            *m_header = header{ MAGIC, VERSION, sizeof(T), 0, 0 };
+        }
+
+        void map(size_t length)
+        {
+            const auto read_only = m_mode == mapped_mode::read_only;
+            const auto memory = mmap(nullptr, length, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw_errno("mmap");
+            }
+
+            m_header = static_cast<header*>(memory);
+            m_length = length;
+        }
+
+        // On failure the file keeps its old length and mapping
+        void set_capacity(size_type new_capacity)
+        {
+            if (new_capacity > (static_cast<size_t>(-1) / 2 - DATA_OFFSET) / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto length = DATA_OFFSET + new_capacity * sizeof(T);
+            const auto growing = length > m_length;
+            if (growing && ftruncate(m_fd, static_cast<off_t>(length)))
+            {
+                throw_errno("ftruncate");
+            }
+
+#if defined(MREMAP_MAYMOVE)
+            const auto memory = mremap(m_header, m_length, length, MREMAP_MAYMOVE);
+#else
+            const auto memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+#endif
+            if (memory == MAP_FAILED)
+            {
+                const auto error = errno;
+                if (growing)
+                {
+                    (void)ftruncate(m_fd, static_cast<off_t>(m_length));
+                }
+                throw std::system_error(error, std::generic_category(), "mremap");
+            }
+
+#if !defined(MREMAP_MAYMOVE)
+            munmap(m_header, m_length);
+#endif
+            m_header = static_cast<header*>(memory);
+            m_length = length;
+            m_header->capacity = new_capacity;
+            if (!growing && ftruncate(m_fd, static_cast<off_t>(length)))
+            {
+                throw_errno("ftruncate");
+            }
+        }
+
+        void release() noexcept
+        {
+            if (m_header)
+            {
+                munmap(m_header, m_length);
+                m_header = nullptr;
+            }
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+            m_length = 0;
+        }
+
+        header* m_header = nullptr;
+        size_t m_length = 0;
+        int m_fd = -1;
+        mapped_mode m_mode;
+    };
+
+    template<typename T>
+    constexpr uint64_t mapped_vector<T>::MAGIC;
+
+    template<typename T>
+    constexpr uint32_t mapped_vector<T>::VERSION;
+
+    template<typename T>
+    constexpr size_t mapped_vector<T>::DATA_OFFSET;
+}
+
+#endif //OMEGA_MAPPED_VECTOR_HPP
@@ -0,0 +1,157 @@
+#ifndef OMEGA_MMAP_ALLOCATOR_HPP
+#define OMEGA_MMAP_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace omega
+{
+    // Allocator that maps blocks of at least Threshold bytes straight from
+    // the kernel and resizes them with mremap(MREMAP_MAYMOVE). mremap moves
+    // page table entries instead of copying bytes, so an omega::vector of a
+    // trivially copyable T grows a mapped buffer without touching its
+    // contents (see allocator_reallocate). Smaller blocks, and every block on
+    // systems other than Linux, come from operator new.
+    template<typename T, size_t Threshold = size_t{ 1 } << 16>
+    class mmap_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t THRESHOLD = Threshold;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = mmap_allocator<U, Threshold>;
+        };
+
+        mmap_allocator() noexcept = default;
+
+        template<typename U>
+        mmap_allocator(const mmap_allocator<U, Threshold>&) noexcept
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            check_size(count);
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                return static_cast<T*>(::operator new(bytes));
+            }
+
+#if defined(__linux__)
+            const auto memory = mmap(nullptr, round_up(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+
+            return static_cast<T*>(memory);
+#endif
+        }
+
+        void deallocate(T* p, size_type count) noexcept
+        {
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                ::operator delete(p);
+                return;
+            }
+
+#if defined(__linux__)
+            munmap(p, round_up(bytes));
+#endif
+        }
+
+        // Resizes a mapped block to new_count elements, moving it if the
+        // address range after it is taken. Returns nullptr when the old or
+        // the new size is below the threshold; throws std::bad_alloc and
+        // keeps the block when the kernel refuses.
+        T* reallocate(T* p, size_type old_count, size_type new_count)
+        {
+            check_size(new_count);
+            const auto old_bytes = old_count * sizeof(T);
+            const auto new_bytes = new_count * sizeof(T);
+            if (!mapped(old_bytes) || !mapped(new_bytes))
+            {
+                return nullptr;
+            }
+
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+            if (round_up(old_bytes) == round_up(new_bytes))
+            {
+                return p;
+            }
+
+            const auto memory = mremap(p, round_up(old_bytes), round_up(new_bytes), MREMAP_MAYMOVE);
+            if (memory == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+
+            return static_cast<T*>(memory);
+#else
+            return (void)p, nullptr;
+#endif
+        }
+
+        // Whether a block of this many bytes is mapped
+        static bool mapped(size_t bytes) noexcept
+        {
+#if defined(__linux__)
+            return bytes >= Threshold && bytes != 0;
+#else
+            return (void)bytes, false;
+#endif
+        }
+
+    private:
+        static void check_size(size_type count)
+        {
+            if (count > (std::numeric_limits<size_type>::max() >> 1) / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+        }
+
+#if defined(__linux__)
+        static size_t round_up(size_t bytes) noexcept
+        {
+            static const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return (bytes + page - 1) & ~(page - 1);
+        }
+#endif
+    };
+
+    template<typename T, size_t Threshold>
+    constexpr size_t mmap_allocator<T, Threshold>::THRESHOLD;
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator == (const mmap_allocator<T, Threshold>&, const mmap_allocator<U, Threshold>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator != (const mmap_allocator<T, Threshold>&, const mmap_allocator<U, Threshold>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //OMEGA_MMAP_ALLOCATOR_HPP
@@ -0,0 +1,320 @@
+#ifndef OMEGA_PARALLEL_ALGORITHM_HPP
+#define OMEGA_PARALLEL_ALGORITHM_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/thread_pool.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace omega
+{
+    // Parallel algorithms over random access ranges such as omega::vector
+    // iterators. Each one cuts the range into chunks and runs them on a
+    // thread_pool, by default thread_pool::shared(); the overloads taking a
+    // pool first run on that one instead. Ranges shorter than MIN_CHUNK run
+    // on the calling thread. Exceptions thrown by the callbacks are rethrown
+    // once every chunk has stopped; the output is then unspecified.
+    namespace par
+    {
+        constexpr size_t MIN_CHUNK = 8192;
+
+        // Several chunks per thread let stealing even out uneven chunks
+        constexpr size_t CHUNKS_PER_THREAD = 4;
+
+        inline size_t chunk_count(const thread_pool& pool, size_t count) noexcept
+        {
+            const auto by_size = count / MIN_CHUNK;
+            const auto by_threads = pool.size() * CHUNKS_PER_THREAD;
+            const auto chunks = by_size < by_threads ? by_size : by_threads;
+            return chunks ? chunks : 1;
+        }
+
+        inline size_t chunk_begin(size_t count, size_t chunks, size_t k) noexcept
+        {
+            return count / chunks * k + (k < count % chunks ? k : count % chunks);
+        }
+
+        template<typename RandomIt, typename Function>
+        void for_each(thread_pool& pool, RandomIt first, RandomIt last, Function f)
+        {
+            const auto count = static_cast<size_t>(last - first);
+            const auto chunks = chunk_count(pool, count);
+            pool.run(chunks, [&](size_t k) {
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                for (auto it = first + chunk_begin(count, chunks, k); it != end; ++it)
+                {
+                    f(*it);
+                }
+            });
+        }
+
+        template<typename RandomIt, typename Function>
+        void for_each(RandomIt first, RandomIt last, Function f)
+        {
+            par::for_each(thread_pool::shared(), first, last, f);
+        }
+
+        // Returns the end of the output; [d_first, d_first + (last - first))
+        // may be the input itself
+        template<typename RandomIt, typename OutputIt, typename UnaryOperation>
+        OutputIt transform(thread_pool& pool, RandomIt first, RandomIt last, OutputIt d_first, UnaryOperation op)
+        {
+            const auto count = static_cast<size_t>(last - first);
+            const auto chunks = chunk_count(pool, count);
+            pool.run(chunks, [&](size_t k) {
+                const auto begin = chunk_begin(count, chunks, k);
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto out = d_first + begin;
+                for (auto it = first + begin; it != end; ++it, ++out)
+                {
+                    *out = op(*it);
+                }
+            });
+            return d_first + count;
+        }
+
+        template<typename RandomIt, typename OutputIt, typename UnaryOperation>
+        OutputIt transform(RandomIt first, RandomIt last, OutputIt d_first, UnaryOperation op)
+        {
+            return par::transform(thread_pool::shared(), first, last, d_first, op);
+        }
+
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename BinaryOperation>
+        OutputIt transform(thread_pool& pool, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, OutputIt d_first
+                           , BinaryOperation op)
+        {
+            const auto count = static_cast<size_t>(last1 - first1);
+            const auto chunks = chunk_count(pool, count);
+            pool.run(chunks, [&](size_t k) {
+                const auto begin = chunk_begin(count, chunks, k);
+                const auto end = first1 + chunk_begin(count, chunks, k + 1);
+                auto other = first2 + begin;
+                auto out = d_first + begin;
+                for (auto it = first1 + begin; it != end; ++it, ++other, ++out)
+                {
+                    *out = op(*it, *other);
+                }
+            });
+            return d_first + count;
+        }
+
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename BinaryOperation>
+        OutputIt transform(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, OutputIt d_first, BinaryOperation op)
+        {
+            return par::transform(thread_pool::shared(), first1, last1, first2, d_first, op);
+        }
+
+        // op must be associative; chunks are combined in order, so it need
+        // not be commutative
+        template<typename RandomIt, typename T, typename BinaryOperation>
+        T reduce(thread_pool& pool, RandomIt first, RandomIt last, T init, BinaryOperation op)
+        {
+            const auto count = static_cast<size_t>(last - first);
+            if (count == 0)
+            {
+                return init;
+            }
+
+            const auto chunks = chunk_count(pool, count);
+            vector<T> partial;
+            partial.resize(chunks, init);
+            pool.run(chunks, [&](size_t k) {
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto it = first + chunk_begin(count, chunks, k);
+                T sum = *it;
+                for (++it; it != end; ++it)
+                {
+                    sum = op(std::move(sum), *it);
+                }
+                partial[k] = std::move(sum);
+            });
+
+            for (auto& sum : partial)
+            {
+                init = op(std::move(init), sum);
+            }
+            return init;
+        }
+
+        template<typename RandomIt, typename T, typename BinaryOperation>
+        T reduce(RandomIt first, RandomIt last, T init, BinaryOperation op)
+        {
+            return par::reduce(thread_pool::shared(), first, last, init, op);
+        }
+
+        template<typename RandomIt, typename T>
+        T reduce(thread_pool& pool, RandomIt first, RandomIt last, T init)
+        {
+            return par::reduce(pool, first, last, init, std::plus<T>{});
+        }
+
+        template<typename RandomIt, typename T>
+        T reduce(RandomIt first, RandomIt last, T init)
+        {
+            return par::reduce(thread_pool::shared(), first, last, init, std::plus<T>{});
+        }
+
+        // Reduces every chunk but the last, turns the sums into the carry
+        // into each chunk, then scans the chunks with their carries. The
+        // output may be the input itself.
+        template<typename RandomIt, typename OutputIt, typename BinaryOperation>
+        OutputIt inclusive_scan(thread_pool& pool, RandomIt first, RandomIt last, OutputIt d_first, BinaryOperation op)
+        {
+            using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+            const auto count = static_cast<size_t>(last - first);
+            if (count == 0)
+            {
+                return d_first;
+            }
+
+            const auto chunks = chunk_count(pool, count);
+            vector<value_type> carry;
+            carry.resize(chunks, *first);
+            pool.run(chunks - 1, [&](size_t k) {
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto it = first + chunk_begin(count, chunks, k);
+                value_type sum = *it;
+                for (++it; it != end; ++it)
+                {
+                    sum = op(std::move(sum), *it);
+                }
+                carry[k + 1] = std::move(sum);
+            });
+            for (size_t k = 2; k < chunks; ++k)
+            {
+                carry[k] = op(carry[k - 1], carry[k]);
+            }
+
+            pool.run(chunks, [&](size_t k) {
+                const auto begin = chunk_begin(count, chunks, k);
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto it = first + begin;
+                auto out = d_first + begin;
+                value_type sum = k ? op(carry[k], *it) : value_type(*it);
+                *out = sum;
+                for (++it, ++out; it != end; ++it, ++out)
+                {
+                    sum = op(std::move(sum), *it);
+                    *out = sum;
+                }
+            });
+            return d_first + count;
+        }
+
+        template<typename RandomIt, typename OutputIt, typename BinaryOperation>
+        OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt d_first, BinaryOperation op)
+        {
+            return par::inclusive_scan(thread_pool::shared(), first, last, d_first, op);
+        }
+
+        template<typename RandomIt, typename OutputIt>
+        OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt d_first)
+        {
+            using value_type = typename std::iterator_traits<RandomIt>::value_type;
+            return par::inclusive_scan(thread_pool::shared(), first, last, d_first, std::plus<value_type>{});
+        }
+
+        // d_first[i] = init op first[0] op ... op first[i - 1]
+        template<typename RandomIt, typename OutputIt, typename T, typename BinaryOperation>
+        OutputIt exclusive_scan(thread_pool& pool, RandomIt first, RandomIt last, OutputIt d_first, T init
+                                , BinaryOperation op)
+        {
+            const auto count = static_cast<size_t>(last - first);
+            const auto chunks = chunk_count(pool, count);
+            vector<T> carry;
+            carry.resize(chunks, init);
+            pool.run(count ? chunks - 1 : 0, [&](size_t k) {
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto it = first + chunk_begin(count, chunks, k);
+                T sum = *it;
+                for (++it; it != end; ++it)
+                {
+                    sum = op(std::move(sum), *it);
+                }
+                carry[k + 1] = std::move(sum);
+            });
+            for (size_t k = 1; k < chunks; ++k)
+            {
+                carry[k] = op(carry[k - 1], carry[k]);
+            }
+
+            pool.run(count ? chunks : 0, [&](size_t k) {
+                const auto begin = chunk_begin(count, chunks, k);
+                const auto end = first + chunk_begin(count, chunks, k + 1);
+                auto out = d_first + begin;
+                T sum = carry[k];
+                for (auto it = first + begin; it != end; ++it, ++out)
+                {
+                    T next = op(sum, *it);
+                    *out = std::move(sum);
+                    sum = std::move(next);
+                }
+            });
+            return d_first + count;
+        }
+
+        template<typename RandomIt, typename OutputIt, typename T, typename BinaryOperation>
+        OutputIt exclusive_scan(RandomIt first, RandomIt last, OutputIt d_first, T init, BinaryOperation op)
+        {
+            return par::exclusive_scan(thread_pool::shared(), first, last, d_first, init, op);
+        }
+
+        template<typename RandomIt, typename OutputIt, typename T>
+        OutputIt exclusive_scan(RandomIt first, RandomIt last, OutputIt d_first, T init)
+        {
+            return par::exclusive_scan(thread_pool::shared(), first, last, d_first, init, std::plus<T>{});
+        }
+
+        // Sorts one chunk per thread with std::sort, then merges neighbouring
+        // runs pairwise, all pairs of a round at once. Not stable.
+        template<typename RandomIt, typename Compare>
+        void sort(thread_pool& pool, RandomIt first, RandomIt last, Compare comp)
+        {
+            const auto count = static_cast<size_t>(last - first);
+            const size_t chunks = count / MIN_CHUNK < pool.size() ? count / MIN_CHUNK : pool.size();
+            if (chunks < 2)
+            {
+                std::sort(first, last, comp);
+                return;
+            }
+
+            pool.run(chunks, [&](size_t k) {
+                std::sort(first + chunk_begin(count, chunks, k), first + chunk_begin(count, chunks, k + 1), comp);
+            });
+
+            for (size_t width = 1; width < chunks; width *= 2)
+            {
+                const auto pairs = (chunks + 2 * width - 1) / (2 * width);
+                pool.run(pairs, [&](size_t pair) {
+                    const auto left = pair * 2 * width;
+                    const auto middle = left + width;
+                    if (middle >= chunks)
+                    {
+                        return;
+                    }
+                    const auto right = middle + width < chunks ? middle + width : chunks;
+                    std::inplace_merge(first + chunk_begin(count, chunks, left)
+                                       , first + chunk_begin(count, chunks, middle)
+                                       , first + chunk_begin(count, chunks, right), comp);
+                });
+            }
+        }
+
+        template<typename RandomIt, typename Compare>
+        void sort(RandomIt first, RandomIt last, Compare comp)
+        {
+            par::sort(thread_pool::shared(), first, last, comp);
+        }
+
+        template<typename RandomIt>
+        void sort(RandomIt first, RandomIt last)
+        {
+            par::sort(thread_pool::shared(), first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>{});
+        }
+    }
+}
+
+#endif //OMEGA_PARALLEL_ALGORITHM_HPP
@@ -0,0 +1,989 @@
+#ifndef OMEGA_PERSISTENT_VECTOR_HPP
+#define OMEGA_PERSISTENT_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/persistent_iterator.hpp"
+#include "vector_helpers/span.hpp"
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace omega
+{
+    // Immutable vector stored as a relaxed radix balanced (RRB) tree with 32
+    // slots per node. push_back, set, concat and slice return new versions in
+    // O(log32 n) that share every untouched node with the old one, so copying
+    // a persistent_vector is a snapshot that costs one reference count.
+    // transient() gives a builder that edits the nodes it owns in place.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class persistent_vector
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        struct node;
+        using node_ptr = std::shared_ptr<node>;
+        using node_allocator = typename alloc_traits::template rebind_alloc<node>;
+        using child_allocator = typename alloc_traits::template rebind_alloc<node_ptr>;
+        using count_allocator = typename alloc_traits::template rebind_alloc<size_t>;
+        using node_list = vector<node_ptr, child_allocator>;
+        using count_list = vector<size_t, count_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type&;
+        using const_reference = const value_type&;
+        using const_iterator = persistent_iterator<persistent_vector>;
+        using iterator = const_iterator;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = const_reverse_iterator;
+
+        static constexpr unsigned BITS = 5;
+        static constexpr size_type BRANCHES = size_type{ 1 } << BITS;
+
+        class transient_vector;
+
+        persistent_vector() = default;
+
+        explicit persistent_vector(const allocator_type& alloc)
+            : m_allocator{ alloc }
+        {
+        }
+
+        // Packs the values into full leaves bottom up, so the tree is dense
+        template<typename It>
+        persistent_vector(It first, It last, const allocator_type& alloc = allocator_type{})
+            : m_allocator{ alloc }
+        {
+            build(first, last);
+        }
+
+        persistent_vector(std::initializer_list<T> list, const allocator_type& alloc = allocator_type{})
+            : persistent_vector( list.begin(), list.end(), alloc )
+        {
+        }
+
+        explicit persistent_vector(const vector<T, Allocator>& values)
+            : persistent_vector( values.begin(), values.end() )
+        {
+        }
+
+        persistent_vector(const vector<T, Allocator>& values, const allocator_type& alloc)
+            : persistent_vector( values.begin(), values.end(), alloc )
+        {
+        }
+
+        persistent_vector push_back(const_reference value) const
+        {
+            return push_back_internal(value);
+        }
+
+        persistent_vector push_back(value_type&& value) const
+        {
+            return push_back_internal(std::move(value));
+        }
+
+        persistent_vector pop_back() const
+        {
+            return slice(0, size() - 1);
+        }
+
+        persistent_vector set(size_type index, const_reference value) const
+        {
+            return set_internal(index, value);
+        }
+
+        persistent_vector set(size_type index, value_type&& value) const
+        {
+            return set_internal(index, std::move(value));
+        }
+
+        // Joins the two trees along their seam, repacking only the nodes on it
+        persistent_vector concat(const persistent_vector& rhs) const
+        {
+            if (rhs.empty())
+            {
+                return *this;
+            }
+
+            if (empty())
+            {
+                return persistent_vector( rhs.m_tree, m_allocator );
+            }
+
+            auto result{ *this };
+            result.edit().concat(result.m_tree, rhs.m_tree);
+            return result;
+        }
+
+        // Elements [first, last)
+        persistent_vector slice(size_type first, size_type last) const
+        {
+            if (first > last || last > size())
+            {
+                throw std::out_of_range("slice out of range");
+            }
+
+            auto result{ *this };
+            result.edit().slice(result.m_tree, first, last);
+            return result;
+        }
+
+        transient_vector transient() const
+        {
+            return transient_vector{ *this };
+        }
+
+        vector<T, Allocator> to_vector() const
+        {
+            vector<T, Allocator> result( m_allocator );
+            result.reserve(size());
+            if (m_tree.root)
+            {
+                append_leaves(*m_tree.root, m_tree.shift, result);
+            }
+
+            return result;
+        }
+
+        // The leaf holding index as a contiguous run, and the index it starts at
+        std::pair<span<const T>, size_type> chunk_at(size_type index) const
+        {
+            auto offset = index;
+            const auto leaf = find_leaf(m_tree.root.get(), m_tree.shift, offset);
+            return std::make_pair(span<const T>{ leaf->values.data(), leaf->values.size() }, index - offset);
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            const auto leaf = find_leaf(m_tree.root.get(), m_tree.shift, index);
+            return leaf->values[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            check_index(index);
+            return (*this)[index];
+        }
+
+        const_reference front() const
+        {
+            return (*this)[0];
+        }
+
+        const_reference back() const
+        {
+            return (*this)[size() - 1];
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ this, 0 };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ this, size() };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_tree.size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_tree.size == 0;
+        }
+
+        // Levels below the root, 0 while everything fits in one leaf
+        size_type depth() const noexcept
+        {
+            return m_tree.shift / BITS;
+        }
+
+    private:
+        // A leaf sits at shift 0 and holds up to BRANCHES values. A node at
+        // shift s has children holding up to 1 << s values each. A node is
+        // regular while every child but the last is full and regular, then a
+        // slot is (index >> shift); otherwise sizes keeps the cumulative counts.
+        struct node
+        {
+            node(size_t owner_id, const Allocator& alloc)
+                : owner{ owner_id }
+                , values( alloc )
+                , children( child_allocator(alloc) )
+                , sizes( count_allocator(alloc) )
+            {
+            }
+
+            size_t owner;
+            size_type count = 0;
+            vector<T, Allocator> values;
+            node_list children;
+            count_list sizes;
+        };
+
+        struct tree
+        {
+            node_ptr root;
+            unsigned shift = 0;
+            size_type size = 0;
+        };
+
+        // Tree operations on behalf of an owner. Nodes created by an editor
+        // carry its owner id and that editor may change them in place; owner 0
+        // is the persistent one that always copies the path it changes.
+        class editor
+        {
+        public:
+            editor(const Allocator& alloc, size_t owner)
+                : m_allocator( alloc )
+                , m_owner{ owner }
+            {
+            }
+
+            template<typename Value>
+            void push_back(tree& t, Value&& value) const
+            {
+                if (!t.root)
+                {
+                    t.root = make_path(0, std::forward<Value>(value));
+                }
+                else if (has_room(*t.root, t.shift))
+                {
+                    t.root = push(t.root, t.shift, std::forward<Value>(value));
+                }
+                else
+                {
+                    auto root = make_node();
+                    root->children.reserve(m_owner ? BRANCHES : 2);
+                    root->children.push_back(t.root);
+                    root->children.push_back(make_path(t.shift, std::forward<Value>(value)));
+                    refresh(*root, t.shift + BITS);
+                    t.root = std::move(root);
+                    t.shift += BITS;
+                }
+
+                ++t.size;
+            }
+
+            template<typename Value>
+            void set(tree& t, size_type index, Value&& value) const
+            {
+                t.root = set(t.root, t.shift, index, std::forward<Value>(value));
+            }
+
+            void slice(tree& t, size_type first, size_type last) const
+            {
+                if (first == last)
+                {
+                    t = tree{};
+                    return;
+                }
+
+                t.root = take(t.root, t.shift, last);
+                t.root = drop(t.root, t.shift, first);
+                t.size = last - first;
+                trim(t);
+            }
+
+            // Both trees non-empty
+            void concat(tree& t, const tree& rhs) const
+            {
+                if (t.shift == 0 && rhs.shift == 0 && t.size + rhs.size <= BRANCHES)
+                {
+                    auto leaf = editable(t.root, 0, rhs.size);
+                    for (const auto& value : rhs.root->values)
+                    {
+                        leaf->values.push_back(value);
+                    }
+                    leaf->count = leaf->values.size();
+                    t.root = std::move(leaf);
+                }
+                else
+                {
+                    t.root = concat(t.root, t.shift, rhs.root, rhs.shift);
+                    t.shift = std::max(t.shift, rhs.shift) + BITS;
+                }
+
+                t.size += rhs.size;
+                trim(t);
+            }
+
+        private:
+            node_ptr make_node() const
+            {
+                return std::allocate_shared<node>(node_allocator(m_allocator), m_owner, m_allocator);
+            }
+
+            // The node itself if this editor owns it, otherwise a copy with
+            // room for extra more slots
+            node_ptr editable(const node_ptr& source, unsigned shift, size_type extra = 0) const
+            {
+                if (m_owner && source->owner == m_owner)
+                {
+                    return source;
+                }
+
+                auto result = make_node();
+                const auto capacity = m_owner ? BRANCHES : slots(*source, shift) + extra;
+                if (shift == 0)
+                {
+                    result->values.reserve(capacity);
+                    for (const auto& value : source->values)
+                    {
+                        result->values.push_back(value);
+                    }
+                }
+                else
+                {
+                    result->children.reserve(capacity);
+                    for (const auto& child : source->children)
+                    {
+                        result->children.push_back(child);
+                    }
+                    result->sizes = source->sizes;
+                }
+
+                result->count = source->count;
+                return result;
+            }
+
+            // A leaf with value under single child nodes up to shift
+            template<typename Value>
+            node_ptr make_path(unsigned shift, Value&& value) const
+            {
+                auto result = make_node();
+                result->values.reserve(m_owner ? BRANCHES : 1);
+                result->values.push_back(std::forward<Value>(value));
+                result->count = 1;
+                for (unsigned level = BITS; level <= shift; level += BITS)
+                {
+                    auto parent = make_node();
+                    parent->children.reserve(m_owner ? BRANCHES : 1);
+                    parent->children.push_back(std::move(result));
+                    parent->count = 1;
+                    result = std::move(parent);
+                }
+
+                return result;
+            }
+
+            static bool has_room(const node& source, unsigned shift) noexcept
+            {
+                auto current = &source;
+                for (; shift > 0; shift -= BITS)
+                {
+                    if (current->children.size() < BRANCHES)
+                    {
+                        return true;
+                    }
+                    current = current->children.back().get();
+                }
+
+                return current->values.size() < BRANCHES;
+            }
+
+            // Appends below a node that has room. A regular node only runs out
+            // of room in its last child once that child is full, so appending a
+            // new child keeps it regular.
+            template<typename Value>
+            node_ptr push(const node_ptr& source, unsigned shift, Value&& value) const
+            {
+                auto result = editable(source, shift, 1);
+                if (shift == 0)
+                {
+                    result->values.push_back(std::forward<Value>(value));
+                }
+                else if (has_room(*result->children.back(), shift - BITS))
+                {
+                    auto& last = result->children.back();
+                    last = push(last, shift - BITS, std::forward<Value>(value));
+                    if (!result->sizes.empty())
+                    {
+                        ++result->sizes.back();
+                    }
+                }
+                else
+                {
+                    result->children.push_back(make_path(shift - BITS, std::forward<Value>(value)));
+                    if (!result->sizes.empty())
+                    {
+                        result->sizes.push_back(result->count + 1);
+                    }
+                }
+
+                ++result->count;
+                return result;
+            }
+
+            template<typename Value>
+            node_ptr set(const node_ptr& source, unsigned shift, size_type index, Value&& value) const
+            {
+                auto result = editable(source, shift);
+                if (shift == 0)
+                {
+                    result->values[index] = std::forward<Value>(value);
+                    return result;
+                }
+
+                const auto slot = child_slot(*result, shift, index);
+                auto& child = result->children[slot];
+                child = set(child, shift - BITS, index, std::forward<Value>(value));
+                return result;
+            }
+
+            // Keeps the first count values, 0 < count
+            node_ptr take(const node_ptr& source, unsigned shift, size_type count) const
+            {
+                if (count == source->count)
+                {
+                    return source;
+                }
+
+                auto result = editable(source, shift);
+                if (shift == 0)
+                {
+                    result->values.erase(result->values.cbegin() + count, result->values.cend());
+                    result->count = count;
+                    return result;
+                }
+
+                auto index = count - 1;
+                const auto slot = child_slot(*result, shift, index);
+                result->children.erase(result->children.cbegin() + slot + 1, result->children.cend());
+                auto& child = result->children[slot];
+                child = take(child, shift - BITS, index + 1);
+                refresh(*result, shift);
+                return result;
+            }
+
+            // Removes the first count values, count < source->count
+            node_ptr drop(const node_ptr& source, unsigned shift, size_type count) const
+            {
+                if (count == 0)
+                {
+                    return source;
+                }
+
+                auto result = editable(source, shift);
+                if (shift == 0)
+                {
+                    result->values.erase(result->values.cbegin(), result->values.cbegin() + count);
+                    result->count -= count;
+                    return result;
+                }
+
+                auto index = count;
+                const auto slot = child_slot(*result, shift, index);
+                result->children.erase(result->children.cbegin(), result->children.cbegin() + slot);
+                auto& child = result->children[0];
+                child = drop(child, shift - BITS, index);
+                refresh(*result, shift);
+                return result;
+            }
+
+            // Merges two subtrees into a node one level above the taller one,
+            // holding one or two children. Only the nodes along the seam are
+            // visited, everything else is shared.
+            node_ptr concat(const node_ptr& left, unsigned left_shift
+                            , const node_ptr& right, unsigned right_shift) const
+            {
+                if (left_shift > right_shift)
+                {
+                    const auto middle = concat(left->children.back(), left_shift - BITS, right, right_shift);
+                    return rebalance(left.get(), *middle, nullptr, left_shift);
+                }
+
+                if (left_shift < right_shift)
+                {
+                    const auto middle = concat(left, left_shift, right->children.front(), right_shift - BITS);
+                    return rebalance(nullptr, *middle, right.get(), right_shift);
+                }
+
+                if (left_shift == 0)
+                {
+                    // the leaves get repacked by the rebalance one level up
+                    auto result = make_node();
+                    result->children.reserve(2);
+                    result->children.push_back(left);
+                    result->children.push_back(right);
+                    refresh(*result, BITS);
+                    return result;
+                }
+
+                const auto middle = concat(left->children.back(), left_shift - BITS
+                                           , right->children.front(), right_shift - BITS);
+                return rebalance(left.get(), *middle, right.get(), left_shift);
+            }
+
+            // left and right are at shift, middle holds the merged seam between
+            // them. Their children are repacked and split over one or two
+            // nodes at shift, returned under a node at shift + BITS.
+            node_ptr rebalance(const node* left, const node& middle, const node* right, unsigned shift) const
+            {
+                auto seam = node_list( child_allocator(m_allocator) );
+                seam.reserve(2 * BRANCHES);
+                if (left)
+                {
+                    seam.insert(seam.cend(), left->children.begin(), left->children.end() - 1);
+                }
+                seam.insert(seam.cend(), middle.children.begin(), middle.children.end());
+                if (right)
+                {
+                    seam.insert(seam.cend(), right->children.begin() + 1, right->children.end());
+                }
+
+                const auto packed = pack(seam, shift - BITS);
+                auto result = make_node();
+                result->children.reserve(2);
+                for (size_type first = 0; first < packed.size(); first += BRANCHES)
+                {
+                    const auto last = std::min(first + BRANCHES, packed.size());
+                    auto parent = make_node();
+                    parent->children.reserve(m_owner ? BRANCHES : last - first);
+                    for (auto i = first; i < last; ++i)
+                    {
+                        parent->children.push_back(packed[i]);
+                    }
+                    refresh(*parent, shift);
+                    result->children.push_back(std::move(parent));
+                }
+
+                refresh(*result, shift + BITS);
+                return result;
+            }
+
+            // Repacks nodes at shift so there are at most EXTRA_NODES more of
+            // them than the minimum, moving slots only out of nodes that are
+            // not nearly full. Nodes the plan leaves alone are shared.
+            node_list pack(const node_list& nodes, unsigned shift) const
+            {
+                auto plan = count_list( count_allocator(m_allocator) );
+                plan.reserve(nodes.size());
+                size_type total = 0;
+                for (const auto& child : nodes)
+                {
+                    plan.push_back(slots(*child, shift));
+                    total += plan.back();
+                }
+
+                const auto optimal = (total + BRANCHES - 1) / BRANCHES;
+                auto length = plan.size();
+                size_type i = 0;
+                while (length > optimal + EXTRA_NODES)
+                {
+                    while (plan[i] > BRANCHES - EXTRA_NODES / 2)
+                    {
+                        ++i;
+                    }
+
+                    // spread node i over the nodes after it
+                    auto remaining = plan[i];
+                    while (remaining > 0)
+                    {
+                        const auto filled = std::min(remaining + plan[i + 1], BRANCHES);
+                        remaining = remaining + plan[i + 1] - filled;
+                        plan[i] = filled;
+                        ++i;
+                    }
+
+                    for (auto j = i; j + 1 < length; ++j)
+                    {
+                        plan[j] = plan[j + 1];
+                    }
+                    --i;
+                    --length;
+                }
+
+                auto result = node_list( child_allocator(m_allocator) );
+                result.reserve(length);
+                size_type source = 0;
+                size_type offset = 0;
+                for (size_type k = 0; k < length; ++k)
+                {
+                    if (offset == 0 && slots(*nodes[source], shift) == plan[k])
+                    {
+                        result.push_back(nodes[source]);
+                        ++source;
+                        continue;
+                    }
+
+                    auto packed = make_node();
+                    if (shift == 0)
+                    {
+                        packed->values.reserve(plan[k]);
+                    }
+                    else
+                    {
+                        packed->children.reserve(plan[k]);
+                    }
+
+                    for (size_type filled = 0; filled < plan[k];)
+                    {
+                        const auto& from = *nodes[source];
+                        const auto available = slots(from, shift) - offset;
+                        const auto count = std::min(plan[k] - filled, available);
+                        for (auto j = offset; j < offset + count; ++j)
+                        {
+                            if (shift == 0)
+                            {
+                                packed->values.push_back(from.values[j]);
+                            }
+                            else
+                            {
+                                packed->children.push_back(from.children[j]);
+                            }
+                        }
+
+                        filled += count;
+                        offset += count;
+                        if (count == available)
+                        {
+                            ++source;
+                            offset = 0;
+                        }
+                    }
+
+                    if (shift == 0)
+                    {
+                        packed->count = packed->values.size();
+                    }
+                    else
+                    {
+                        refresh(*packed, shift);
+                    }
+                    result.push_back(std::move(packed));
+                }
+
+                return result;
+            }
+
+            static void trim(tree& t)
+            {
+                while (t.shift > 0 && t.root->children.size() == 1)
+                {
+                    t.root = t.root->children[0];
+                    t.shift -= BITS;
+                }
+            }
+
+            const Allocator& m_allocator;
+            size_t m_owner;
+        };
+
+        persistent_vector(const tree& t, const allocator_type& alloc)
+            : m_tree( t )
+            , m_allocator{ alloc }
+        {
+        }
+
+        editor edit() const
+        {
+            return editor{ m_allocator, 0 };
+        }
+
+        template<typename Value>
+        persistent_vector push_back_internal(Value&& value) const
+        {
+            auto result{ *this };
+            result.edit().push_back(result.m_tree, std::forward<Value>(value));
+            return result;
+        }
+
+        template<typename Value>
+        persistent_vector set_internal(size_type index, Value&& value) const
+        {
+            check_index(index);
+            auto result{ *this };
+            result.edit().set(result.m_tree, index, std::forward<Value>(value));
+            return result;
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        template<typename It>
+        void build(It first, It last)
+        {
+            auto level = node_list( child_allocator(m_allocator) );
+            size_type count = 0;
+            while (first != last)
+            {
+                auto leaf = std::allocate_shared<node>(node_allocator(m_allocator), 0, m_allocator);
+                leaf->values.reserve(BRANCHES);
+                for (; first != last && leaf->values.size() < BRANCHES; ++first)
+                {
+                    leaf->values.push_back(*first);
+                }
+                leaf->count = leaf->values.size();
+                count += leaf->count;
+                level.push_back(std::move(leaf));
+            }
+
+            unsigned shift = 0;
+            while (level.size() > 1)
+            {
+                shift += BITS;
+                auto parents = node_list( child_allocator(m_allocator) );
+                parents.reserve((level.size() + BRANCHES - 1) / BRANCHES);
+                for (size_type i = 0; i < level.size(); i += BRANCHES)
+                {
+                    const auto end = std::min(i + BRANCHES, level.size());
+                    auto parent = std::allocate_shared<node>(node_allocator(m_allocator), 0, m_allocator);
+                    parent->children.reserve(end - i);
+                    for (auto j = i; j < end; ++j)
+                    {
+                        parent->children.push_back(std::move(level[j]));
+                    }
+                    refresh(*parent, shift);
+                    parents.push_back(std::move(parent));
+                }
+                level = std::move(parents);
+            }
+
+            if (count)
+            {
+                m_tree.root = level[0];
+                m_tree.shift = shift;
+                m_tree.size = count;
+            }
+        }
+
+        static size_type slots(const node& source, unsigned shift) noexcept
+        {
+            return shift == 0 ? source.values.size() : source.children.size();
+        }
+
+        // Recomputes count and the size table of a node at shift
+        static void refresh(node& target, unsigned shift)
+        {
+            const auto full = size_type{ 1 } << shift;
+            const auto children = target.children.size();
+            size_type count = 0;
+            bool regular = true;
+            for (size_type i = 0; i < children; ++i)
+            {
+                const auto& child = *target.children[i];
+                regular = regular && child.sizes.empty() && (i + 1 == children || child.count == full);
+                count += child.count;
+            }
+
+            target.count = count;
+            target.sizes.clear();
+            if (!regular)
+            {
+                target.sizes.reserve(children);
+                count = 0;
+                for (const auto& child : target.children)
+                {
+                    count += child->count;
+                    target.sizes.push_back(count);
+                }
+            }
+        }
+
+        // Slot of the child holding index; index becomes relative to that child
+        static size_type child_slot(const node& parent, unsigned shift, size_type& index) noexcept
+        {
+            auto slot = index >> shift;
+            if (parent.sizes.empty())
+            {
+                index -= slot << shift;
+                return slot;
+            }
+
+            while (parent.sizes[slot] <= index)
+            {
+                ++slot;
+            }
+            if (slot > 0)
+            {
+                index -= parent.sizes[slot - 1];
+            }
+            return slot;
+        }
+
+        static const node* find_leaf(const node* current, unsigned shift, size_type& index) noexcept
+        {
+            for (; shift > 0; shift -= BITS)
+            {
+                current = current->children[child_slot(*current, shift, index)].get();
+            }
+
+            return current;
+        }
+
+        static void append_leaves(const node& source, unsigned shift, vector<T, Allocator>& result)
+        {
+            if (shift == 0)
+            {
+                for (const auto& value : source.values)
+                {
+                    result.push_back(value);
+                }
+                return;
+            }
+
+            for (const auto& child : source.children)
+            {
+                append_leaves(*child, shift - BITS, result);
+            }
+        }
+
+        static size_t next_owner() noexcept
+        {
+            static std::atomic<size_t> last_owner{ 0 };
+            return ++last_owner;
+        }
+
+        static constexpr size_type EXTRA_NODES = 2;
+
+        tree m_tree;
+        allocator_type m_allocator = allocator_type{};
+    };
+
+    // Batch builder over a persistent_vector. It owns the nodes it creates and
+    // changes them in place, copying only nodes still shared with snapshots;
+    // persistent() hands out a snapshot and gives up ownership of its nodes.
+    template<typename T, typename Allocator>
+    class persistent_vector<T, Allocator>::transient_vector
+    {
+    public:
+        explicit transient_vector(const persistent_vector& source)
+            : m_tree( source.m_tree )
+            , m_allocator{ source.m_allocator }
+            , m_owner{ next_owner() }
+        {
+        }
+
+        transient_vector(const transient_vector&) = delete;
+        transient_vector& operator = (const transient_vector&) = delete;
+
+        transient_vector(transient_vector&& rhs) noexcept
+            : m_tree( std::move(rhs.m_tree) )
+            , m_allocator{ rhs.m_allocator }
+            , m_owner{ rhs.m_owner }
+        {
+            rhs.m_tree = tree{};
+        }
+
+        transient_vector& operator = (transient_vector&& rhs) noexcept
+        {
+            m_tree = std::move(rhs.m_tree);
+            m_allocator = rhs.m_allocator;
+            m_owner = rhs.m_owner;
+            rhs.m_tree = tree{};
+            return *this;
+        }
+
+        void push_back(const_reference value)
+        {
+            edit().push_back(m_tree, value);
+        }
+
+        void push_back(value_type&& value)
+        {
+            edit().push_back(m_tree, std::move(value));
+        }
+
+        void pop_back()
+        {
+            edit().slice(m_tree, 0, size() - 1);
+        }
+
+        void set(size_type index, const_reference value)
+        {
+            check_index(index);
+            edit().set(m_tree, index, value);
+        }
+
+        void set(size_type index, value_type&& value)
+        {
+            check_index(index);
+            edit().set(m_tree, index, std::move(value));
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return find_leaf(m_tree.root.get(), m_tree.shift, index)->values[index];
+        }
+
+        size_type size() const noexcept
+        {
+            return m_tree.size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_tree.size == 0;
+        }
+
+        persistent_vector persistent()
+        {
+            persistent_vector result( m_tree, m_allocator );
+            m_owner = next_owner();
+            return result;
+        }
+
+    private:
+        editor edit() const
+        {
+            return editor{ m_allocator, m_owner };
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+        }
+
+        tree m_tree;
+        allocator_type m_allocator;
+        size_t m_owner;
+    };
+
+    template<typename T, typename Allocator>
+    constexpr unsigned persistent_vector<T, Allocator>::BITS;
+
+    template<typename T, typename Allocator>
+    constexpr typename persistent_vector<T, Allocator>::size_type persistent_vector<T, Allocator>::BRANCHES;
+
+    template<typename T, typename Allocator>
+    constexpr typename persistent_vector<T, Allocator>::size_type persistent_vector<T, Allocator>::EXTRA_NODES;
+}
+
+#endif //OMEGA_PERSISTENT_VECTOR_HPP
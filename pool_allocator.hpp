@@ -0,0 +1,346 @@
+#ifndef OMEGA_POOL_ALLOCATOR_HPP
+#define OMEGA_POOL_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace omega
+{
+    // Memory held by the process-wide size class pool
+    struct pool_statistics
+    {
+        // bytes of slabs taken from the system; slabs are never returned
+        size_t slab_bytes;
+        // bytes of blocks handed out from slabs, rounded up to their class
+        size_t block_bytes;
+        // bytes of blocks above the threshold that are mapped on their own
+        size_t mapped_bytes;
+    };
+
+    // Process-wide free lists for blocks of 16 bytes to MAX_BLOCK, one per
+    // power of two. A class with an empty free list cuts blocks from its
+    // current slab and takes a new slab from the system when that runs out,
+    // so blocks of one size sit together and a freed block is reused only
+    // for the same size. Blocks are aligned to their size up to a page. Each
+    // class has its own lock.
+    class size_class_pool
+    {
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        struct size_class
+        {
+            std::mutex lock;
+            free_block* free = nullptr;
+            char* top = nullptr;
+            char* end = nullptr;
+            size_t slab_bytes = 0;
+            size_t block_bytes = 0;
+        };
+
+    public:
+        static constexpr unsigned MIN_SHIFT = 4;
+        static constexpr unsigned MAX_SHIFT = 20;
+        static constexpr size_t MIN_BLOCK = size_t{ 1 } << MIN_SHIFT;
+        static constexpr size_t MAX_BLOCK = size_t{ 1 } << MAX_SHIFT;
+        static constexpr size_t SLAB = size_t{ 1 } << 16;
+        static constexpr unsigned CLASSES = MAX_SHIFT - MIN_SHIFT + 1;
+
+        size_class_pool() = default;
+        size_class_pool(const size_class_pool&) = delete;
+        size_class_pool& operator = (const size_class_pool&) = delete;
+
+        // Never destroyed, so blocks may be freed during static destruction
+        static size_class_pool& instance()
+        {
+            static size_class_pool* const pool = new size_class_pool{};
+            return *pool;
+        }
+
+        // Class of a block of at least bytes aligned to align; both at most MAX_BLOCK
+        static unsigned class_of(size_t bytes, size_t align) noexcept
+        {
+            bytes = bytes > align ? bytes : align;
+            unsigned shift = MIN_SHIFT;
+            while ((size_t{ 1 } << shift) < bytes)
+            {
+                ++shift;
+            }
+            return shift - MIN_SHIFT;
+        }
+
+        static size_t block_size(unsigned index) noexcept
+        {
+            return MIN_BLOCK << index;
+        }
+
+        void* allocate(unsigned index)
+        {
+            auto& sc = m_classes[index];
+            std::lock_guard<std::mutex> guard{ sc.lock };
+            return take(sc, block_size(index));
+        }
+
+        void deallocate(void* p, unsigned index) noexcept
+        {
+            auto& sc = m_classes[index];
+            std::lock_guard<std::mutex> guard{ sc.lock };
+            give(sc, p, block_size(index));
+        }
+
+        // Takes up to count blocks under one lock; fewer only when the
+        // system runs out of memory after the first
+        size_t allocate_batch(unsigned index, void** blocks, size_t count)
+        {
+            auto& sc = m_classes[index];
+            const auto size = block_size(index);
+            std::lock_guard<std::mutex> guard{ sc.lock };
+            size_t taken = 0;
+            try
+            {
+                for (; taken < count; ++taken)
+                {
+                    blocks[taken] = take(sc, size);
+                }
+            }
+            catch (const std::bad_alloc&)
+            {
+                if (taken == 0)
+                {
+                    throw;
+                }
+            }
+            return taken;
+        }
+
+        void deallocate_batch(unsigned index, void* const* blocks, size_t count) noexcept
+        {
+            auto& sc = m_classes[index];
+            const auto size = block_size(index);
+            std::lock_guard<std::mutex> guard{ sc.lock };
+            for (size_t i = 0; i < count; ++i)
+            {
+                give(sc, blocks[i], size);
+            }
+        }
+
+        void count_mapped(size_t bytes, bool mapped) noexcept
+        {
+            if (mapped)
+            {
+                m_mapped_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            else
+            {
+                m_mapped_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+        }
+
+        pool_statistics statistics()
+        {
+            pool_statistics result{ 0, 0, m_mapped_bytes.load(std::memory_order_relaxed) };
+            for (auto& sc : m_classes)
+            {
+                std::lock_guard<std::mutex> guard{ sc.lock };
+                result.slab_bytes += sc.slab_bytes;
+                result.block_bytes += sc.block_bytes;
+            }
+            return result;
+        }
+
+    private:
+        static void* take(size_class& sc, size_t size)
+        {
+            sc.block_bytes += size;
+            if (sc.free)
+            {
+                const auto block = sc.free;
+                sc.free = block->next;
+                return block;
+            }
+
+            if (static_cast<size_t>(sc.end - sc.top) < size)
+            {
+                refill(sc, size);
+            }
+            const auto block = sc.top;
+            sc.top += size;
+            return block;
+        }
+
+        static void give(size_class& sc, void* p, size_t size) noexcept
+        {
+            const auto block = static_cast<free_block*>(p);
+            block->next = sc.free;
+            sc.free = block;
+            sc.block_bytes -= size;
+        }
+
+        // The rest of the old slab is dropped; it is smaller than one block
+        static void refill(size_class& sc, size_t size)
+        {
+            const auto bytes = size * 8 > SLAB ? size * 8 : SLAB;
+#if defined(__linux__)
+            const auto memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                sc.block_bytes -= size;
+                throw std::bad_alloc{};
+            }
+            sc.top = static_cast<char*>(memory);
+#else
+            try
+            {
+                sc.top = static_cast<char*>(::operator new(bytes));
+            }
+            catch (...)
+            {
+                sc.block_bytes -= size;
+                throw;
+            }
+#endif
+            sc.end = sc.top + bytes;
+            sc.slab_bytes += bytes;
+        }
+
+        size_class m_classes[CLASSES];
+        std::atomic<size_t> m_mapped_bytes{ 0 };
+    };
+
+    // Stateless allocator over size_class_pool for the many small buffers
+    // of short-lived vectors. A block of up to Threshold bytes comes from
+    // the pool; a bigger one is mapped on its own and unmapped when freed,
+    // so large buffers do not pin slabs. Every instance shares the pool, so
+    // allocators always compare equal and vector moves only swap pointers.
+    template<typename T, size_t Threshold = size_t{ 1 } << 15>
+    class pool_allocator
+    {
+        static_assert(Threshold <= size_class_pool::MAX_BLOCK, "the pool has no class above MAX_BLOCK");
+        static_assert(alignof(T) <= 4096, "pool blocks are aligned to a page at most");
+#if !defined(__linux__)
+        static_assert(alignof(T) <= alignof(std::max_align_t), "slabs come from operator new here");
+#endif
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t THRESHOLD = Threshold;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = pool_allocator<U, Threshold>;
+        };
+
+        pool_allocator() noexcept = default;
+
+        template<typename U>
+        pool_allocator(const pool_allocator<U, Threshold>&) noexcept
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            if (count > std::numeric_limits<size_type>::max() / 2 / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                return static_cast<T*>(size_class_pool::instance().allocate(size_class_pool::class_of(bytes, alignof(T))));
+            }
+
+#if defined(__linux__)
+            const auto memory = mmap(nullptr, round_up(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+            size_class_pool::instance().count_mapped(round_up(bytes), true);
+            return static_cast<T*>(memory);
+#else
+            return static_cast<T*>(::operator new(bytes));
+#endif
+        }
+
+        // Like operator delete, accepts the null pointer an empty vector holds
+        void deallocate(T* p, size_type count) noexcept
+        {
+            if (!p)
+            {
+                return;
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (!mapped(bytes))
+            {
+                size_class_pool::instance().deallocate(p, size_class_pool::class_of(bytes, alignof(T)));
+                return;
+            }
+
+#if defined(__linux__)
+            munmap(p, round_up(bytes));
+            size_class_pool::instance().count_mapped(round_up(bytes), false);
+#else
+            ::operator delete(p);
+#endif
+        }
+
+        // Whether a block of this many bytes bypasses the pool
+        static bool mapped(size_t bytes) noexcept
+        {
+            return bytes > Threshold;
+        }
+
+        static pool_statistics statistics()
+        {
+            return size_class_pool::instance().statistics();
+        }
+
+    private:
+        static size_t round_up(size_t bytes) noexcept
+        {
+#if defined(__linux__)
+            const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return (bytes + page - 1) & ~(page - 1);
+#else
+            return bytes;
+#endif
+        }
+    };
+
+    template<typename T, size_t Threshold>
+    constexpr size_t pool_allocator<T, Threshold>::THRESHOLD;
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator == (const pool_allocator<T, Threshold>&, const pool_allocator<U, Threshold>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator != (const pool_allocator<T, Threshold>&, const pool_allocator<U, Threshold>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //OMEGA_POOL_ALLOCATOR_HPP
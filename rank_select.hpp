@@ -0,0 +1,240 @@
+#ifndef OMEGA_RANK_SELECT_HPP
+#define OMEGA_RANK_SELECT_HPP
+
+#include "bit_vector.hpp"
+#include "vector.hpp"
+#include "vector_helpers/bit_ops.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace omega
+{
+    // Succinct rank/select index over a bit_vector.
+    // Two levels: every 65536-bit superblock stores the absolute number of set
+    // bits before it (64 bits) and every 512-bit block stores the count
+    // relative to its superblock (16 bits), about 3.1% on top of the bits.
+    // rank is two table loads plus at most eight popcounts, select is a binary
+    // search over both levels followed by a scan of one block.
+    template<typename Allocator = std::allocator<uint64_t>>
+    class rank_select
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using super_allocator = typename alloc_traits::template rebind_alloc<uint64_t>;
+        using block_allocator = typename alloc_traits::template rebind_alloc<uint16_t>;
+
+    public:
+        using bits_type = bit_vector<Allocator>;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+
+        static constexpr size_type BLOCK_BITS = 512;
+        static constexpr size_type SUPERBLOCK_BITS = 65536;
+
+        explicit rank_select(const bits_type& bits, const allocator_type& alloc = allocator_type{})
+            : m_bits{ &bits }
+            , m_super( super_allocator( alloc ) )
+            , m_blocks( block_allocator( alloc ) )
+        {
+            build();
+        }
+
+        // Indexes the whole bit vector from scratch
+        void build()
+        {
+            index_from(0, 0);
+        }
+
+        // Extends the index after bits were appended. Only the block that held
+        // the old end is recounted; use build() if earlier bits were modified.
+        void update()
+        {
+            const auto first_block = m_indexed / BLOCK_BITS;
+            index_from(first_block, ones_before_block(first_block));
+        }
+
+        // Number of set bits in [0, pos), pos <= size()
+        size_type rank1(size_type pos) const noexcept
+        {
+            const auto block = pos / BLOCK_BITS;
+            const auto word = pos / bits_type::BITS_PER_WORD;
+            const auto words = m_bits->words().data();
+
+            auto result = ones_before_block(block);
+            for (auto i = block * WORDS_PER_BLOCK; i < word; ++i)
+            {
+                result += bit_ops::popcount(words[i]);
+            }
+
+            const auto rest = pos % bits_type::BITS_PER_WORD;
+            if (rest)
+            {
+                result += bit_ops::popcount(words[word] & bit_ops::low_mask(rest));
+            }
+
+            return result;
+        }
+
+        size_type rank0(size_type pos) const noexcept
+        {
+            return pos - rank1(pos);
+        }
+
+        // Position of the k-th (0-based) set bit
+        size_type select1(size_type k) const
+        {
+            if (k >= m_ones)
+            {
+                throw std::out_of_range("rank out of range");
+            }
+
+            return select<true>(k);
+        }
+
+        // Position of the k-th (0-based) clear bit
+        size_type select0(size_type k) const
+        {
+            if (k >= m_indexed - m_ones)
+            {
+                throw std::out_of_range("rank out of range");
+            }
+
+            return select<false>(k);
+        }
+
+        size_type count() const noexcept
+        {
+            return m_ones;
+        }
+
+        size_type size() const noexcept
+        {
+            return m_indexed;
+        }
+
+        size_type size_in_bytes() const noexcept
+        {
+            return m_super.capacity() * sizeof(uint64_t) + m_blocks.capacity() * sizeof(uint16_t);
+        }
+
+    private:
+        static constexpr size_type WORDS_PER_BLOCK = BLOCK_BITS / bits_type::BITS_PER_WORD;
+        static constexpr size_type BLOCKS_PER_SUPERBLOCK = SUPERBLOCK_BITS / BLOCK_BITS;
+
+        size_type ones_before_block(size_type block) const noexcept
+        {
+            return m_super[block / BLOCKS_PER_SUPERBLOCK] + m_blocks[block];
+        }
+
+        // Keeps the entries before first_block and recounts the rest. There is
+        // one block past the last full one so rank(size()) needs no special case.
+        void index_from(size_type first_block, size_type ones)
+        {
+            const auto words = m_bits->words();
+            const auto block_count = m_bits->size() / BLOCK_BITS + 1;
+            const auto super_count = (block_count + BLOCKS_PER_SUPERBLOCK - 1) / BLOCKS_PER_SUPERBLOCK;
+
+            m_blocks.resize(first_block);
+            m_super.resize((first_block + BLOCKS_PER_SUPERBLOCK - 1) / BLOCKS_PER_SUPERBLOCK);
+            grow(m_blocks, block_count);
+            grow(m_super, super_count);
+
+            for (auto block = first_block; block < block_count; ++block)
+            {
+                if (block % BLOCKS_PER_SUPERBLOCK == 0)
+                {
+                    m_super.push_back(ones);
+                }
+                m_blocks.push_back(static_cast<uint16_t>(ones - m_super.back()));
+
+                const auto first_word = block * WORDS_PER_BLOCK;
+                const auto last_word = std::min(first_word + WORDS_PER_BLOCK, words.size());
+                if (first_word < last_word)
+                {
+                    ones += bit_ops::popcount(words.data() + first_word, last_word - first_word);
+                }
+            }
+
+            m_ones = ones;
+            m_indexed = m_bits->size();
+        }
+
+        // Geometric growth so a series of small appends does not reallocate the index every time
+        template<typename Table>
+        static void grow(Table& table, size_type count)
+        {
+            if (table.capacity() < count)
+            {
+                table.reserve(std::max(count, table.capacity() * 2));
+            }
+        }
+
+        template<bool Ones>
+        static size_type ones_or_zeros(size_type ones, size_type bits) noexcept
+        {
+            return Ones ? ones : bits - ones;
+        }
+
+        // Largest index in [first, last) whose value is <= k, value(first) must be <= k
+        template<typename Value>
+        static size_type last_not_greater(size_type first, size_type last, size_type k, Value value)
+        {
+            while (last - first > 1)
+            {
+                const auto middle = first + (last - first) / 2;
+                if (value(middle) <= k)
+                {
+                    first = middle;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return first;
+        }
+
+        template<bool Ones>
+        size_type select(size_type k) const
+        {
+            const auto super = last_not_greater(0, m_super.size(), k, [this](size_type i) {
+                return ones_or_zeros<Ones>(m_super[i], i * SUPERBLOCK_BITS);
+            });
+
+            const auto first_block = super * BLOCKS_PER_SUPERBLOCK;
+            const auto last_block = std::min(first_block + BLOCKS_PER_SUPERBLOCK, m_blocks.size());
+            const auto block = last_not_greater(first_block, last_block, k, [this](size_type i) {
+                return ones_or_zeros<Ones>(ones_before_block(i), i * BLOCK_BITS);
+            });
+
+            auto rest = k - ones_or_zeros<Ones>(ones_before_block(block), block * BLOCK_BITS);
+            const auto words = m_bits->words().data();
+            for (auto i = block * WORDS_PER_BLOCK; ; ++i)
+            {
+                const auto word = Ones ? words[i] : ~words[i];
+                const auto count = bit_ops::popcount(word);
+                if (rest < count)
+                {
+                    return i * bits_type::BITS_PER_WORD
+                        + bit_ops::select_in_word(word, static_cast<unsigned>(rest));
+                }
+                rest -= count;
+            }
+        }
+
+        const bits_type* m_bits;
+        vector<uint64_t, super_allocator> m_super;
+        vector<uint16_t, block_allocator> m_blocks;
+        size_type m_ones = 0;
+        size_type m_indexed = 0;
+    };
+
+    template<typename Allocator>
+    constexpr typename rank_select<Allocator>::size_type rank_select<Allocator>::BLOCK_BITS;
+
+    template<typename Allocator>
+    constexpr typename rank_select<Allocator>::size_type rank_select<Allocator>::SUPERBLOCK_BITS;
+}
+
+#endif //OMEGA_RANK_SELECT_HPP
@@ -0,0 +1,406 @@
+#ifndef OMEGA_RCU_VECTOR_HPP
+#define OMEGA_RCU_VECTOR_HPP
+
+#include "aligned_allocator.hpp"
+#include "vector.hpp"
+#include "vector_helpers/asymmetric_fence.hpp"
+#include "vector_helpers/vector_helper.hpp"
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace omega
+{
+    // Read-copy-update vector for read-mostly tables. Writers build a whole
+    // new buffer with vector_helper and publish it with one pointer store;
+    // the buffer it replaces is retired and freed once no reader can still
+    // see it.
+    //
+    // A reader takes one of max_readers slots with make_reader() and pins a
+    // snapshot with read(). Pinning is wait-free: a relaxed store to the
+    // reader's own cache line, a compiler barrier, one atomic load of the
+    // published pointer and a second relaxed store of its epoch. The
+    // matching full barrier runs on the writer side through membarrier
+    // (see asymmetric_fence). Writers are serialized by a mutex.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class rcu_vector
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        struct buffer
+        {
+            buffer(const Allocator& alloc, uint64_t birth)
+                : allocator{ alloc }
+                , values{ allocator }
+                , epoch{ birth }
+            {
+            }
+
+            Allocator allocator;
+            vector_helper<T, Allocator> values;
+            uint64_t epoch;
+        };
+
+        using buffer_allocator = typename alloc_traits::template rebind_alloc<buffer>;
+        using buffer_traits = std::allocator_traits<buffer_allocator>;
+
+        static constexpr size_t CACHE_LINE = 64;
+
+        // 0 while the reader is not pinned, otherwise the oldest epoch it may see
+        struct alignas(CACHE_LINE) reader_slot
+        {
+            std::atomic<uint64_t> epoch{ 0 };
+            std::atomic<bool> in_use{ false };
+        };
+
+        // operator new only guarantees 16 bytes, which would split slots
+        // across cache lines
+        using slot_allocator = aligned_allocator<reader_slot, CACHE_LINE>;
+
+        // A pinned reader that has not read the pointer yet protects every buffer
+        static constexpr uint64_t PINNED = 1;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using const_reference = const value_type&;
+        using const_pointer = const T*;
+        using const_iterator = const T*;
+
+        class reader;
+        class snapshot;
+
+        explicit rcu_vector(size_type max_readers = 64, const allocator_type& alloc = allocator_type{})
+            : m_allocator{ alloc }
+            , m_retired( buffer_pointer_allocator(m_allocator) )
+        {
+            m_slots.allocate(max_readers);
+            for (size_type i = 0; i < max_readers; ++i)
+            {
+                m_slots.construct();
+            }
+            m_current.store(make_buffer(), std::memory_order_release);
+        }
+
+        template<typename It>
+        rcu_vector(It first, It last, size_type max_readers = 64, const allocator_type& alloc = allocator_type{})
+            : rcu_vector{ max_readers, alloc }
+        {
+            assign(first, last);
+        }
+
+        rcu_vector(const rcu_vector&) = delete;
+        rcu_vector& operator = (const rcu_vector&) = delete;
+
+        // No reader may be pinned any more
+        ~rcu_vector()
+        {
+            free_buffer(m_current.load(std::memory_order_relaxed));
+            for (auto retired : m_retired)
+            {
+                free_buffer(retired);
+            }
+        }
+
+        // Throws std::length_error when all max_readers slots are taken
+        reader make_reader()
+        {
+            for (size_type i = 0; i < m_slots.m_size; ++i)
+            {
+                bool expected = false;
+                if (m_slots.m_data[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    return reader{ *this, m_slots.m_data[i] };
+                }
+            }
+
+            throw std::length_error("no free reader slot");
+        }
+
+        template<typename It>
+        void assign(It first, It last)
+        {
+            std::lock_guard<std::mutex> lock{ m_writer };
+            auto fresh = make_buffer();
+            try
+            {
+                fresh->values.allocate(static_cast<size_type>(std::distance(first, last)));
+                for (; first != last; ++first)
+                {
+                    fresh->values.construct(*first);
+                }
+            }
+            catch (...)
+            {
+                free_buffer(fresh);
+                throw;
+            }
+            publish(fresh);
+        }
+
+        void assign(std::initializer_list<T> list)
+        {
+            assign(list.begin(), list.end());
+        }
+
+        // Copies the current contents into an omega::vector, lets edit change
+        // it and publishes the result
+        template<typename Edit>
+        void update(Edit edit)
+        {
+            std::lock_guard<std::mutex> lock{ m_writer };
+            const auto current = m_current.load(std::memory_order_relaxed);
+            vector<T, Allocator> values( m_allocator );
+            values.reserve(current->values.m_size);
+            for (size_type i = 0; i < current->values.m_size; ++i)
+            {
+                values.push_back(current->values.m_data[i]);
+            }
+            edit(values);
+
+            auto fresh = make_buffer();
+            try
+            {
+                fresh->values.allocate(values.size());
+                for (auto& value : values)
+                {
+                    fresh->values.construct(std::move_if_noexcept(value));
+                }
+            }
+            catch (...)
+            {
+                free_buffer(fresh);
+                throw;
+            }
+            publish(fresh);
+        }
+
+        // Frees the retired buffers no reader can see any more
+        void reclaim()
+        {
+            std::lock_guard<std::mutex> lock{ m_writer };
+            asymmetric_fence::heavy();
+            reclaim_locked();
+        }
+
+        // Buffers replaced by a writer and still waiting for readers
+        size_type retired_count()
+        {
+            std::lock_guard<std::mutex> lock{ m_writer };
+            return m_retired.size();
+        }
+
+    private:
+        using buffer_pointer_allocator = typename alloc_traits::template rebind_alloc<buffer*>;
+
+        buffer* make_buffer()
+        {
+            buffer_allocator alloc{ m_allocator };
+            const auto memory = buffer_traits::allocate(alloc, 1);
+            return ::new (static_cast<void*>(memory)) buffer{ m_allocator, ++m_epoch };
+        }
+
+        void free_buffer(buffer* retired) noexcept
+        {
+            buffer_allocator alloc{ m_allocator };
+            retired->~buffer();
+            buffer_traits::deallocate(alloc, retired, 1);
+        }
+
+        // The writer stores the pointer, then a full barrier, then reads the
+        // slots; a reader stores its slot, then a barrier, then reads the
+        // pointer. Either the writer sees the reader pinned or the reader
+        // sees the new buffer.
+        void publish(buffer* fresh)
+        {
+            try
+            {
+                m_retired.reserve(m_retired.size() + 1);
+            }
+            catch (...)
+            {
+                free_buffer(fresh);
+                throw;
+            }
+
+            const auto old = m_current.exchange(fresh, std::memory_order_acq_rel);
+            m_retired.push_back(old);
+            asymmetric_fence::heavy();
+            reclaim_locked();
+        }
+
+        void reclaim_locked() noexcept
+        {
+            auto oldest = UINT64_MAX;
+            for (size_type i = 0; i < m_slots.m_size; ++i)
+            {
+                const auto epoch = m_slots.m_data[i].epoch.load(std::memory_order_acquire);
+                if (epoch && epoch < oldest)
+                {
+                    oldest = epoch;
+                }
+            }
+
+            size_type kept = 0;
+            for (size_type i = 0; i < m_retired.size(); ++i)
+            {
+                if (m_retired[i]->epoch < oldest)
+                {
+                    free_buffer(m_retired[i]);
+                }
+                else
+                {
+                    m_retired[kept++] = m_retired[i];
+                }
+            }
+            m_retired.resize(kept);
+        }
+
+        allocator_type m_allocator = allocator_type{};
+        slot_allocator m_slot_allocator;
+        vector_helper<reader_slot, slot_allocator> m_slots{ m_slot_allocator };
+        std::mutex m_writer;
+        uint64_t m_epoch = PINNED;
+        vector<buffer*, buffer_pointer_allocator> m_retired;
+        unsigned char m_padding[CACHE_LINE] = {};
+        std::atomic<buffer*> m_current{ nullptr };
+    };
+
+    // A registered reader. Not thread safe itself: each thread uses its own.
+    template<typename T, typename Allocator>
+    class rcu_vector<T, Allocator>::reader
+    {
+    public:
+        reader(const reader&) = delete;
+        reader& operator = (const reader&) = delete;
+
+        reader(reader&& rhs) noexcept
+            : m_owner{ rhs.m_owner }
+            , m_slot{ rhs.m_slot }
+        {
+            rhs.m_slot = nullptr;
+        }
+
+        ~reader()
+        {
+            if (m_slot)
+            {
+                m_slot->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        // Pins the current buffer until the snapshot goes away; one snapshot
+        // per reader at a time
+        snapshot read() const noexcept
+        {
+            m_slot->epoch.store(PINNED, std::memory_order_relaxed);
+            asymmetric_fence::light();
+            const auto current = m_owner->m_current.load(std::memory_order_acquire);
+            m_slot->epoch.store(current->epoch, std::memory_order_relaxed);
+            return snapshot{ current, m_slot };
+        }
+
+    private:
+        friend rcu_vector;
+
+        reader(rcu_vector& owner, reader_slot& slot) noexcept
+            : m_owner{ &owner }
+            , m_slot{ &slot }
+        {
+        }
+
+        rcu_vector* m_owner;
+        reader_slot* m_slot;
+    };
+
+    // Read-only view of a pinned buffer; it stays valid while the snapshot lives
+    template<typename T, typename Allocator>
+    class rcu_vector<T, Allocator>::snapshot
+    {
+    public:
+        snapshot(const snapshot&) = delete;
+        snapshot& operator = (const snapshot&) = delete;
+
+        snapshot(snapshot&& rhs) noexcept
+            : m_buffer{ rhs.m_buffer }
+            , m_slot{ rhs.m_slot }
+        {
+            rhs.m_slot = nullptr;
+        }
+
+        ~snapshot()
+        {
+            if (m_slot)
+            {
+                m_slot->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        const_reference operator[](size_type index) const noexcept
+        {
+            return m_buffer->values.m_data[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return m_buffer->values.m_data[index];
+        }
+
+        const_pointer data() const noexcept
+        {
+            return m_buffer->values.m_data;
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return data();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return data() + size();
+        }
+
+        size_type size() const noexcept
+        {
+            return m_buffer->values.m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        friend reader;
+
+        snapshot(const buffer* pinned, reader_slot* slot) noexcept
+            : m_buffer{ pinned }
+            , m_slot{ slot }
+        {
+        }
+
+        const buffer* m_buffer;
+        reader_slot* m_slot;
+    };
+
+    template<typename T, typename Allocator>
+    constexpr size_t rcu_vector<T, Allocator>::CACHE_LINE;
+
+    template<typename T, typename Allocator>
+    constexpr uint64_t rcu_vector<T, Allocator>::PINNED;
+}
+
+#endif //OMEGA_RCU_VECTOR_HPP
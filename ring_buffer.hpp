@@ -0,0 +1,536 @@
+#ifndef OMEGA_RING_BUFFER_HPP
+#define OMEGA_RING_BUFFER_HPP
+
+#include "vector_helpers/ring_iterator.hpp"
+#include "vector_helpers/span.hpp"
+#include "vector_helpers/vector_helper.hpp"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace omega
+{
+    enum class ring_growth
+    {
+        grow,
+        fixed
+    };
+
+    // FIFO over a power-of-two buffer. Elements are addressed with
+    // (head + index) & mask, so pop_front is O(1) and never moves anything.
+    // A growable ring relocates into a buffer twice as big when full, a fixed
+    // one throws std::length_error instead.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class ring_buffer
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = typename alloc_traits::pointer;
+        using const_pointer = typename alloc_traits::const_pointer;
+        using const_iterator = ring_iterator<T>;
+        using iterator = ring_iterator<T, false>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+        ring_buffer() noexcept(noexcept(allocator_type())) = default;
+
+        explicit ring_buffer(const allocator_type& alloc) noexcept
+            : m_allocator{ alloc }
+        {
+        }
+
+        // capacity is rounded up to a power of two
+        explicit ring_buffer(size_type capacity, ring_growth growth = ring_growth::grow
+                             , const allocator_type& alloc = allocator_type{})
+            : m_growth{ growth }
+            , m_allocator{ alloc }
+        {
+            if (capacity)
+            {
+                relocate(round_up(capacity));
+            }
+        }
+
+        ring_buffer(const ring_buffer& rhs)
+            : m_growth{ rhs.m_growth }
+            , m_allocator{ alloc_traits::select_on_container_copy_construction(rhs.m_allocator) }
+        {
+            copy_assign(rhs);
+        }
+
+        ring_buffer(ring_buffer&& rhs) noexcept
+            : m_data{ rhs.m_data }
+            , m_head{ rhs.m_head }
+            , m_size{ rhs.m_size }
+            , m_capacity{ rhs.m_capacity }
+            , m_growth{ rhs.m_growth }
+            , m_allocator{ std::move(rhs.m_allocator) }
+        {
+            rhs.m_data = nullptr;
+            rhs.m_head = 0;
+            rhs.m_size = 0;
+            rhs.m_capacity = 0;
+        }
+
+        ring_buffer& operator = (const ring_buffer& rhs)
+        {
+            if (this == std::addressof(rhs))
+            {
+                return *this;
+            }
+
+            const bool copy_storage = alloc_traits::propagate_on_container_copy_assignment::value
+                                      && m_allocator != rhs.m_allocator;
+            if (copy_storage)
+            {
+                //clearing container in case vector_helper throws
+                clear_capacity();
+                m_allocator = rhs.m_allocator;
+            }
+
+            m_growth = rhs.m_growth;
+            copy_assign(rhs);
+
+            return *this;
+        }
+
+        ring_buffer& operator = (ring_buffer&& rhs)
+        {
+            if (this == std::addressof(rhs))
+            {
+                return *this;
+            }
+
+            const bool move_storage = alloc_traits::propagate_on_container_move_assignment::value
+                                      || m_allocator == rhs.m_allocator;
+
+            m_growth = rhs.m_growth;
+            if (move_storage)
+            {
+                move_assign(std::move(rhs));
+            }
+            else
+            {
+                copy_assign(rhs);
+            }
+
+            return *this;
+        }
+
+        ~ring_buffer()
+        {
+            clear_capacity();
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(value_type&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        // Appends a range, growing at most once; the range is constructed in
+        // at most two contiguous runs
+        template<typename InputIt>
+        void push_back(InputIt first, InputIt last)
+        {
+            push_back_range(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+        }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            if (m_size == m_capacity)
+            {
+                check_growth(1);
+
+                vector_helper<T, allocator_type> temp{ m_allocator };
+                temp.allocate(m_capacity ? m_capacity * 2 : 1);
+                move_elements(temp);
+                temp.construct(std::forward<Args>(args)...);
+                adopt(temp);
+                return;
+            }
+
+            alloc_traits::construct(m_allocator, &m_data[physical(m_size)], std::forward<Args>(args)...);
+            ++m_size;
+        }
+
+        void pop_front()
+        {
+            alloc_traits::destroy(m_allocator, &m_data[m_head]);
+            advance_head(1);
+        }
+
+        // Drops the first count elements, count <= size()
+        void pop_front(size_type count)
+        {
+            const auto first_run = std::min(count, m_capacity - m_head);
+            destroy_run(m_head, first_run);
+            destroy_run(0, count - first_run);
+            advance_head(count);
+        }
+
+        void pop_back()
+        {
+            alloc_traits::destroy(m_allocator, &m_data[physical(m_size - 1)]);
+            --m_size;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity <= m_capacity)
+            {
+                return;
+            }
+
+            relocate(round_up(new_capacity));
+        }
+
+        void shrink_to_fit()
+        {
+            const auto new_capacity = round_up(m_size);
+            if (new_capacity == m_capacity)
+            {
+                return;
+            }
+
+            relocate(new_capacity);
+        }
+
+        void clear() noexcept
+        {
+            destroy_elements();
+        }
+
+        reference operator[](size_type index)
+        {
+            return m_data[physical(index)];
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return m_data[physical(index)];
+        }
+
+        reference at(size_type index)
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return m_data[physical(index)];
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return m_data[physical(index)];
+        }
+
+        reference front()
+        {
+            return m_data[m_head];
+        }
+
+        const_reference front() const
+        {
+            return m_data[m_head];
+        }
+
+        reference back()
+        {
+            return m_data[physical(m_size - 1)];
+        }
+
+        const_reference back() const
+        {
+            return m_data[physical(m_size - 1)];
+        }
+
+        // The elements as two contiguous runs in FIFO order, the second one is
+        // empty unless the contents wrap around the end of the buffer
+        std::pair<span<T>, span<T>> as_spans() noexcept
+        {
+            const auto first_run = std::min(m_size, m_capacity - m_head);
+            return std::make_pair(span<T>{ m_data + m_head, first_run }
+                                  , span<T>{ m_data, m_size - first_run });
+        }
+
+        std::pair<span<const T>, span<const T>> as_spans() const noexcept
+        {
+            const auto first_run = std::min(m_size, m_capacity - m_head);
+            return std::make_pair(span<const T>{ m_data + m_head, first_run }
+                                  , span<const T>{ m_data, m_size - first_run });
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator{ m_data, mask(), m_head };
+        }
+
+        iterator end() noexcept
+        {
+            return iterator{ m_data, mask(), m_head + m_size };
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ m_data, mask(), m_head };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ m_data, mask(), m_head + m_size };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        bool full() const noexcept
+        {
+            return m_size == m_capacity;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        ring_growth growth() const noexcept
+        {
+            return m_growth;
+        }
+
+        void swap(ring_buffer& rhs) noexcept
+        {
+            const bool swap_storage = alloc_traits::propagate_on_container_swap::value
+                && m_allocator != rhs.m_allocator;
+
+            using std::swap;
+            if (swap_storage)
+            {
+                swap(m_allocator, rhs.m_allocator);
+            }
+
+            std::swap(m_data, rhs.m_data);
+            std::swap(m_head, rhs.m_head);
+            std::swap(m_size, rhs.m_size);
+            std::swap(m_capacity, rhs.m_capacity);
+            std::swap(m_growth, rhs.m_growth);
+        }
+
+    private:
+        static size_type round_up(size_type count) noexcept
+        {
+            size_type result = 1;
+            while (result < count)
+            {
+                result <<= 1;
+            }
+            return count ? result : 0;
+        }
+
+        size_type mask() const noexcept
+        {
+            return m_capacity - 1;
+        }
+
+        size_type physical(size_type index) const noexcept
+        {
+            return (m_head + index) & mask();
+        }
+
+        void advance_head(size_type count) noexcept
+        {
+            m_size -= count;
+            m_head = m_size ? physical(count) : 0;
+        }
+
+        void check_growth(size_type count) const
+        {
+            if (m_growth == ring_growth::fixed && m_size + count > m_capacity)
+            {
+                throw std::length_error("ring_buffer is full");
+            }
+        }
+
+        template<typename InputIt>
+        void push_back_range(InputIt first, InputIt last, std::input_iterator_tag)
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        template<typename ForwardIt>
+        void push_back_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            if (m_size + count > m_capacity)
+            {
+                check_growth(count);
+                relocate(round_up(std::max(m_size + count, m_capacity * 2)));
+            }
+
+            const auto tail = physical(m_size);
+            const auto first_run = std::min(count, m_capacity - tail);
+            for (size_type i = 0; i < first_run; ++i, ++first)
+            {
+                alloc_traits::construct(m_allocator, &m_data[tail + i], *first);
+                ++m_size;
+            }
+
+            for (size_type i = 0; i < count - first_run; ++i, ++first)
+            {
+                alloc_traits::construct(m_allocator, &m_data[i], *first);
+                ++m_size;
+            }
+        }
+
+        void destroy_run(size_type first, size_type count) noexcept
+        {
+            for (size_type i = 0; i < count; ++i)
+            {
+                alloc_traits::destroy(m_allocator, &m_data[first + i]);
+            }
+        }
+
+        void destroy_elements() noexcept
+        {
+            const auto first_run = std::min(m_size, m_capacity - m_head);
+            destroy_run(m_head, first_run);
+            destroy_run(0, m_size - first_run);
+            m_size = 0;
+            m_head = 0;
+        }
+
+        void move_elements(vector_helper<T, allocator_type>& temp)
+        {
+            for (size_type i = 0; i < m_size; ++i)
+            {
+                temp.construct(std::move_if_noexcept<T>(m_data[physical(i)]));
+            }
+        }
+
+        void relocate(size_type new_capacity)
+        {
+            vector_helper<T, allocator_type> temp{ m_allocator };
+            temp.allocate(new_capacity);
+            move_elements(temp);
+            adopt(temp);
+        }
+
+        // Takes over a linear buffer built in temp; the old buffer is handed
+        // back to temp empty, so temp only deallocates it
+        void adopt(vector_helper<T, allocator_type>& temp) noexcept
+        {
+            destroy_elements();
+            std::swap(m_data, temp.m_data);
+            std::swap(m_size, temp.m_size);
+            std::swap(m_capacity, temp.m_capacity);
+        }
+
+        void copy_assign(const ring_buffer& rhs)
+        {
+            vector_helper<T, allocator_type> temp{ m_allocator };
+            temp.allocate(rhs.m_capacity);
+            for (size_type i = 0; i < rhs.m_size; ++i)
+            {
+                temp.construct(rhs[i]);
+            }
+            adopt(temp);
+        }
+
+        void move_assign(ring_buffer&& rhs) noexcept
+        {
+            clear_capacity();
+
+            if (m_allocator != rhs.m_allocator)
+            {
+                m_allocator = std::move(rhs.m_allocator);
+            }
+
+            m_data = rhs.m_data;
+            m_head = rhs.m_head;
+            m_size = rhs.m_size;
+            m_capacity = rhs.m_capacity;
+
+            rhs.m_data = nullptr;
+            rhs.m_head = 0;
+            rhs.m_size = 0;
+            rhs.m_capacity = 0;
+        }
+
+        void clear_capacity() noexcept
+        {
+            destroy_elements();
+            alloc_traits::deallocate(m_allocator, m_data, m_capacity);
+            m_data = nullptr;
+            m_capacity = 0;
+        }
+
+        pointer m_data = nullptr;
+        size_type m_head = 0;
+        size_type m_size = 0;
+        size_type m_capacity = 0;
+        ring_growth m_growth = ring_growth::grow;
+        allocator_type m_allocator = allocator_type{};
+    };
+}
+
+#endif //OMEGA_RING_BUFFER_HPP
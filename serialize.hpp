@@ -0,0 +1,295 @@
+#ifndef OMEGA_SERIALIZE_HPP
+#define OMEGA_SERIALIZE_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/fd_io.hpp"
+#include "vector_helpers/vector_access.hpp"
+#include "vector_helpers/vector_helper.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace omega
+{
+    // Start of every serialized vector. byte_order is written as 0x0102 in
+    // the writer's order, so a reader of the other order sees 0x0201 and
+    // rejects the stream before reading the payload.
+    struct serialized_header
+    {
+        static constexpr uint32_t MAGIC = 0x5653474full;
+        static constexpr uint16_t VERSION = 1;
+        static constexpr uint16_t NATIVE_ORDER = 0x0102;
+        // set when the payload was written by serializer<T>
+        static constexpr uint32_t HOOK = 1;
+
+        uint32_t magic;
+        uint16_t version;
+        uint16_t byte_order;
+        uint32_t element_size;
+        uint32_t flags;
+        uint64_t count;
+        uint64_t payload_bytes;
+    };
+
+    [[noreturn]] inline void throw_serialized(const char* what)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), what);
+    }
+
+    // Appends the bytes of a value to the payload a hook builds. The buffer
+    // grows geometrically and may end up longer than size().
+    class byte_writer
+    {
+    public:
+        explicit byte_writer(vector<unsigned char>& bytes) noexcept
+            : m_bytes{ bytes }
+        {
+        }
+
+        void write(const void* data, size_t size)
+        {
+            if (m_size + size > m_bytes.size())
+            {
+                m_bytes.resize(m_bytes.size() * 2 > m_size + size ? m_bytes.size() * 2 : m_size + size);
+            }
+
+            std::memcpy(m_bytes.data() + m_size, data, size);
+            m_size += size;
+        }
+
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "write raw bytes of trivially copyable values only");
+            write(&value, sizeof(T));
+        }
+
+        // Bytes written so far
+        size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+    private:
+        vector<unsigned char>& m_bytes;
+        size_t m_size = 0;
+    };
+
+    // Reads a payload back; throws std::system_error past its end
+    class byte_reader
+    {
+    public:
+        byte_reader(const unsigned char* first, const unsigned char* last) noexcept
+            : m_first{ first }
+            , m_last{ last }
+        {
+        }
+
+        void read(void* data, size_t size)
+        {
+            if (size > remaining())
+            {
+                throw_serialized("serialized element overruns its payload");
+            }
+
+            std::memcpy(data, m_first, size);
+            m_first += size;
+        }
+
+        template<typename T>
+        T read()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "read raw bytes of trivially copyable values only");
+            T value;
+            read(&value, sizeof(T));
+            return value;
+        }
+
+        size_t remaining() const noexcept
+        {
+            return static_cast<size_t>(m_last - m_first);
+        }
+
+    private:
+        const unsigned char* m_first;
+        const unsigned char* m_last;
+    };
+
+    // Hook for element types that are not trivially copyable. Specialize it
+    // with
+    //     static void write(byte_writer& out, const T& value);
+    //     static T read(byte_reader& in);
+    template<typename T>
+    struct serializer
+    {
+        static_assert(!std::is_same<T, T>::value, "specialize omega::serializer for this element type");
+    };
+
+    template<typename CharT, typename Traits, typename Allocator>
+    struct serializer<std::basic_string<CharT, Traits, Allocator>>
+    {
+        using string_type = std::basic_string<CharT, Traits, Allocator>;
+
+        static void write(byte_writer& out, const string_type& value)
+        {
+            out.write(static_cast<uint64_t>(value.size()));
+            out.write(value.data(), value.size() * sizeof(CharT));
+        }
+
+        static string_type read(byte_reader& in)
+        {
+            const auto size = in.read<uint64_t>();
+            if (size > in.remaining() / sizeof(CharT))
+            {
+                throw_serialized("serialized string overruns its payload");
+            }
+
+            string_type value;
+            value.resize(static_cast<size_t>(size));
+            in.read(&value[0], value.size() * sizeof(CharT));
+            return value;
+        }
+    };
+
+    template<typename T, typename Allocator>
+    void serialize_internal(const vector<T, Allocator>& values, int fd, std::true_type)
+    {
+        serialized_header header{ serialized_header::MAGIC, serialized_header::VERSION, serialized_header::NATIVE_ORDER
+                                  , sizeof(T), 0, values.size(), values.size() * sizeof(T) };
+        iovec buffers[2] = { { &header, sizeof(header) }
+                             , { const_cast<T*>(to_address(values.data())), values.size() * sizeof(T) } };
+        fd_io::write_all(fd, buffers, values.empty() ? 1 : 2);
+    }
+
+    template<typename T, typename Allocator>
+    void serialize_internal(const vector<T, Allocator>& values, int fd, std::false_type)
+    {
+        vector<unsigned char> payload;
+        byte_writer out{ payload };
+        for (const auto& value : values)
+        {
+            serializer<T>::write(out, value);
+        }
+
+        serialized_header header{ serialized_header::MAGIC, serialized_header::VERSION, serialized_header::NATIVE_ORDER
+                                  , sizeof(T), serialized_header::HOOK, values.size(), out.size() };
+        iovec buffers[2] = { { &header, sizeof(header) }, { payload.data(), out.size() } };
+        fd_io::write_all(fd, buffers, out.size() ? 2 : 1);
+    }
+
+    // Most payload bytes read from a pipe or socket before the buffer has to
+    // grow. The header is not trusted for more: the buffer doubles as bytes
+    // arrive, so a forged count ends as a truncated stream instead of a huge
+    // allocation. A regular file holding the whole payload is read at once.
+    constexpr size_t SERIALIZED_CHUNK = size_t{ 1 } << 20;
+
+    // The elements are read into uninitialized capacity; being trivially
+    // copyable, they need no constructor call
+    template<typename T, typename Allocator>
+    void deserialize_internal(vector<T, Allocator>& result, const serialized_header& header, int fd, std::true_type)
+    {
+        const auto count = static_cast<size_t>(header.count);
+        if (header.count > static_cast<size_t>(-1) / 2 / sizeof(T) || header.payload_bytes != header.count * sizeof(T))
+        {
+            throw_serialized("serialized omega::vector has an inconsistent size");
+        }
+
+        vector_helper<T, Allocator> temp{ vector_access::allocator(result) };
+        const auto first = fd_io::holds(fd, count * sizeof(T)) ? count : (SERIALIZED_CHUNK + sizeof(T) - 1) / sizeof(T);
+        while (temp.m_size < count)
+        {
+            if (temp.m_size == temp.m_capacity)
+            {
+                const auto wanted = temp.m_capacity ? temp.m_capacity * 2 : first;
+                vector_helper<T, Allocator> grown{ vector_access::allocator(result) };
+                grown.allocate(wanted < count ? wanted : count);
+                if (temp.m_size)
+                {
+                    std::memcpy(to_address(grown.m_data), to_address(temp.m_data), temp.m_size * sizeof(T));
+                }
+                std::swap(grown.m_data, temp.m_data);
+                std::swap(grown.m_capacity, temp.m_capacity);
+            }
+
+            const auto bytes = (temp.m_capacity - temp.m_size) * sizeof(T);
+            if (fd_io::read_all(fd, to_address(temp.m_data + temp.m_size), bytes) != bytes)
+            {
+                throw_serialized("truncated omega::vector payload");
+            }
+            temp.m_size = temp.m_capacity;
+        }
+        vector_access::adopt(result, temp);
+    }
+
+    template<typename T, typename Allocator>
+    void deserialize_internal(vector<T, Allocator>& result, const serialized_header& header, int fd, std::false_type)
+    {
+        const auto bytes = static_cast<size_t>(header.payload_bytes);
+        if (header.payload_bytes > static_cast<size_t>(-1) / 2)
+        {
+            throw_serialized("serialized omega::vector has an inconsistent size");
+        }
+
+        vector<unsigned char> payload;
+        for (size_t done = 0; done < bytes; done = payload.size())
+        {
+            const auto wanted = done ? done * 2 : fd_io::holds(fd, bytes) ? bytes : SERIALIZED_CHUNK;
+            payload.resize(wanted < bytes ? wanted : bytes);
+            if (fd_io::read_all(fd, payload.data() + done, payload.size() - done) != payload.size() - done)
+            {
+                throw_serialized("truncated omega::vector payload");
+            }
+        }
+
+        // a forged count must not allocate more than the payload could hold
+        result.reserve(header.count <= bytes ? static_cast<size_t>(header.count) : bytes);
+        byte_reader in{ payload.data(), payload.data() + bytes };
+        for (uint64_t i = 0; i < header.count; ++i)
+        {
+            result.push_back(serializer<T>::read(in));
+        }
+        if (in.remaining())
+        {
+            throw_serialized("serialized omega::vector has an inconsistent size");
+        }
+    }
+
+    // Writes a header and the elements to fd. A trivially copyable T goes
+    // out in one writev of the header and data(); any other T is encoded
+    // through serializer<T> first. Throws std::system_error when a write fails.
+    template<typename T, typename Allocator>
+    void serialize(const vector<T, Allocator>& values, int fd)
+    {
+        serialize_internal(values, fd, std::is_trivially_copyable<T>{});
+    }
+
+    // Reads a vector written by serialize. A trivially copyable T is read
+    // straight into the new buffer; any other T is decoded through
+    // serializer<T>. Throws std::system_error on a read error, a header of
+    // another element size, byte order or version, or a truncated stream.
+    template<typename T, typename Allocator = std::allocator<T>>
+    vector<T, Allocator> deserialize(int fd, const Allocator& alloc = Allocator{})
+    {
+        serialized_header header;
+        if (fd_io::read_all(fd, &header, sizeof(header)) != sizeof(header))
+        {
+            throw_serialized("truncated omega::vector header");
+        }
+
+        const auto hooked = !std::is_trivially_copyable<T>::value;
+        if (header.magic != serialized_header::MAGIC || header.version != serialized_header::VERSION
+            || header.byte_order != serialized_header::NATIVE_ORDER || header.element_size != sizeof(T)
+            || header.flags != (hooked ? serialized_header::HOOK : 0u))
+        {
+            throw_serialized("serialized omega::vector has another version, byte order or element type");
+        }
+
+        vector<T, Allocator> result( alloc );
+        deserialize_internal(result, header, fd, std::is_trivially_copyable<T>{});
+        return result;
+    }
+}
+
+#endif //OMEGA_SERIALIZE_HPP
@@ -0,0 +1,265 @@
+#ifndef OMEGA_SHARDED_VECTOR_HPP
+#define OMEGA_SHARDED_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/parallel_construct.hpp"
+#include "vector_helpers/vector_access.hpp"
+#include "vector_helpers/vector_helper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace omega
+{
+    // A set of omega::vector shards, one per writer, for collecting results
+    // from many threads. A thread takes a shard with make_writer() and
+    // appends to it without any synchronization; shards sit on separate
+    // cache lines so writers never share one.
+    //
+    // merge() concatenates the shards in shard order into one vector: it
+    // sizes the result once, allocates once and moves the elements over on
+    // several threads. Each shard keeps its own append order. merge(),
+    // size() and clear() must not run while writers append.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class sharded_vector
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        static constexpr size_t CACHE_LINE = 64;
+
+        struct shard
+        {
+            explicit shard(const Allocator& alloc)
+                : values( alloc )
+            {
+            }
+
+            // keeps the vector off the line of the previous shard
+            unsigned char padding[CACHE_LINE];
+            vector<T, Allocator> values;
+            std::atomic<bool> in_use{ false };
+        };
+
+        using shard_allocator = typename alloc_traits::template rebind_alloc<shard>;
+        using shard_traits = std::allocator_traits<shard_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        class writer;
+
+        explicit sharded_vector(size_type max_writers = 64, const allocator_type& alloc = allocator_type{})
+            : m_allocator{ alloc }
+            , m_shard_count{ max_writers }
+        {
+            shard_allocator shards{ m_allocator };
+            m_shards = shard_traits::allocate(shards, m_shard_count);
+            size_type built = 0;
+            try
+            {
+                for (; built < m_shard_count; ++built)
+                {
+                    ::new (static_cast<void*>(m_shards + built)) shard{ m_allocator };
+                }
+            }
+            catch (...)
+            {
+                destroy_shards(built);
+                throw;
+            }
+        }
+
+        sharded_vector(const sharded_vector&) = delete;
+        sharded_vector& operator = (const sharded_vector&) = delete;
+
+        // No writer may be left
+        ~sharded_vector()
+        {
+            destroy_shards(m_shard_count);
+        }
+
+        // Throws std::length_error when all max_writers shards are taken
+        writer make_writer()
+        {
+            for (size_type i = 0; i < m_shard_count; ++i)
+            {
+                bool expected = false;
+                if (m_shards[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    return writer{ m_shards[i] };
+                }
+            }
+
+            throw std::length_error("no free shard");
+        }
+
+        // Moves every element into one vector and leaves the shards empty
+        // with their capacity kept. If an element cannot be moved without
+        // throwing it is copied, and a throwing copy leaves the shards as
+        // they were.
+        vector<T, Allocator> merge(unsigned threads = std::thread::hardware_concurrency())
+        {
+            std::unique_ptr<size_type[]> offsets{ new size_type[m_shard_count + 1] };
+            offsets[0] = 0;
+            for (size_type i = 0; i < m_shard_count; ++i)
+            {
+                offsets[i + 1] = offsets[i] + m_shards[i].values.size();
+            }
+            const auto count = offsets[m_shard_count];
+
+            vector<T, Allocator> result( m_allocator );
+            vector_helper<T, Allocator> temp{ vector_access::allocator(result) };
+            temp.allocate(count);
+            const auto shards = m_shards;
+            const auto last_shard = m_shard_count;
+            construct_parallel(temp, count, threads ? threads : 1
+                               , [shards, last_shard, &offsets](size_type first, size_type last
+                                                                , parallel_output<T, Allocator>& output) {
+                auto index = first;
+                auto current = static_cast<size_type>(std::upper_bound(&offsets[0], &offsets[0] + last_shard + 1, first)
+                                                       - &offsets[0]) - 1;
+                for (; index < last; ++current)
+                {
+                    auto& values = shards[current].values;
+                    const auto end = offsets[current + 1] < last ? offsets[current + 1] : last;
+                    for (; index < end; ++index)
+                    {
+                        output.construct(std::move_if_noexcept(values[index - offsets[current]]));
+                    }
+                }
+            });
+
+            vector_access::adopt(result, temp);
+            for (size_type i = 0; i < m_shard_count; ++i)
+            {
+                m_shards[i].values.clear();
+            }
+            return result;
+        }
+
+        // Elements over all shards
+        size_type size() const noexcept
+        {
+            size_type count = 0;
+            for (size_type i = 0; i < m_shard_count; ++i)
+            {
+                count += m_shards[i].values.size();
+            }
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type shard_count() const noexcept
+        {
+            return m_shard_count;
+        }
+
+        void clear() noexcept
+        {
+            for (size_type i = 0; i < m_shard_count; ++i)
+            {
+                m_shards[i].values.clear();
+            }
+        }
+
+        allocator_type get_allocator() const
+        {
+            return m_allocator;
+        }
+
+    private:
+        using shard_pointer = typename shard_traits::pointer;
+
+        void destroy_shards(size_type built) noexcept
+        {
+            shard_allocator shards{ m_allocator };
+            for (size_type i = 0; i < built; ++i)
+            {
+                m_shards[i].~shard();
+            }
+            shard_traits::deallocate(shards, m_shards, m_shard_count);
+        }
+
+        allocator_type m_allocator = allocator_type{};
+        size_type m_shard_count;
+        shard_pointer m_shards = nullptr;
+    };
+
+    // Exclusive access to one shard. Not thread safe itself: each thread
+    // uses its own. The shard keeps its elements when the writer goes away.
+    template<typename T, typename Allocator>
+    class sharded_vector<T, Allocator>::writer
+    {
+    public:
+        writer(const writer&) = delete;
+        writer& operator = (const writer&) = delete;
+
+        writer(writer&& rhs) noexcept
+            : m_shard{ rhs.m_shard }
+        {
+            rhs.m_shard = nullptr;
+        }
+
+        ~writer()
+        {
+            if (m_shard)
+            {
+                m_shard->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        void push_back(const_reference value)
+        {
+            m_shard->values.push_back(value);
+        }
+
+        void push_back(value_type&& value)
+        {
+            m_shard->values.push_back(std::move(value));
+        }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            m_shard->values.emplace_back(std::forward<Args>(args)...);
+        }
+
+        void reserve(size_type capacity)
+        {
+            m_shard->values.reserve(capacity);
+        }
+
+        // Elements in this writer's shard
+        size_type size() const noexcept
+        {
+            return m_shard->values.size();
+        }
+
+    private:
+        friend sharded_vector;
+
+        explicit writer(shard& owned) noexcept
+            : m_shard{ &owned }
+        {
+        }
+
+        shard* m_shard;
+    };
+
+    template<typename T, typename Allocator>
+    constexpr size_t sharded_vector<T, Allocator>::CACHE_LINE;
+}
+
+#endif //OMEGA_SHARDED_VECTOR_HPP
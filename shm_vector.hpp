@@ -0,0 +1,403 @@
+#ifndef OMEGA_SHM_VECTOR_HPP
+#define OMEGA_SHM_VECTOR_HPP
+
+#include "vector_helpers/random_access_iterator.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace omega
+{
+    // Append-only vector in a POSIX shared memory object, written by one
+    // process and read by any number of others without copying.
+    //
+    // The writer creates the object with a fixed max_size. Every process
+    // maps the whole max_size range at once, so element addresses never
+    // change; the writer extends the object with ftruncate ahead of the
+    // elements. An append copies the element in and then publishes the new
+    // size with a release store; readers load the size with acquire and may
+    // read every index below it. Published elements are never modified, so
+    // readers need no lock. T must be trivially copyable, since its bytes are
+    // read by other processes.
+    //
+    // The writer unlinks the name when it is destroyed; readers that are
+    // already attached keep their mapping. System call failures, bad objects
+    // and writes through a reader throw std::system_error.
+    template<typename T>
+    class shm_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "shm_vector shares its elements as raw bytes");
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2
+                      , "the magic and size are shared between processes and must be lock free");
+
+        static constexpr size_t CACHE_LINE = 64;
+
+        struct header
+        {
+            // stored last with release, so a reader that loads it with
+            // acquire sees the fields below it initialized
+            std::atomic<uint64_t> magic;
+            uint32_t version;
+            uint32_t element_size;
+            uint64_t max_size;
+            unsigned char padding[CACHE_LINE - 3 * sizeof(uint64_t)];
+            // on its own cache line, the only field written after creation
+            std::atomic<uint64_t> size;
+        };
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using const_reference = const value_type&;
+        using const_pointer = const T*;
+        using const_iterator = random_access_iterator<T>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr uint64_t MAGIC = 0x524f434556534d4full;
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t DATA_OFFSET = 2 * CACHE_LINE;
+
+        static_assert(sizeof(header) <= DATA_OFFSET && alignof(T) <= DATA_OFFSET, "header layout");
+
+        // Creates the object as the writer; fails with EEXIST when the name
+        // is taken. name follows shm_open: a leading slash and no other.
+        shm_vector(const std::string& name, size_type max_size)
+            : m_name{ name }
+            , m_writer{ false }
+        {
+            if (max_size > (static_cast<size_t>(-1) / 2 - DATA_OFFSET) / sizeof(T))
+            {
+                throw std::length_error("shm_vector max_size too large");
+            }
+
+            m_fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+            if (m_fd < 0)
+            {
+                throw_errno("shm_open " + name);
+            }
+
+            // the name is ours to unlink only once we created it
+            m_writer = true;
+            try
+            {
+                resize_object(DATA_OFFSET);
+                map(DATA_OFFSET + max_size * sizeof(T), PROT_READ | PROT_WRITE);
+                const auto head = ::new (static_cast<void*>(m_header)) header{};
+                head->version = VERSION;
+                head->element_size = sizeof(T);
+                head->max_size = max_size;
+                head->size.store(0, std::memory_order_relaxed);
+                head->magic.store(MAGIC, std::memory_order_release);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        // Attaches to an existing object as a reader
+        explicit shm_vector(const std::string& name)
+            : m_name{ name }
+            , m_writer{ false }
+        {
+            m_fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+            if (m_fd < 0)
+            {
+                throw_errno("shm_open " + name);
+            }
+
+            try
+            {
+                struct stat info;
+                if (fstat(m_fd, &info))
+                {
+                    throw_errno("fstat " + name);
+                }
+                if (static_cast<size_t>(info.st_size) < DATA_OFFSET)
+                {
+                    throw_format(name);
+                }
+
+                map(DATA_OFFSET, PROT_READ);
+                // an object still being created reads as zeros until the magic is stored
+                if (m_header->magic.load(std::memory_order_acquire) != MAGIC)
+                {
+                    throw_format(name);
+                }
+                const auto max_size = m_header->max_size;
+                if (m_header->version != VERSION || m_header->element_size != sizeof(T)
+                    || max_size > (static_cast<size_t>(-1) / 2 - DATA_OFFSET) / sizeof(T))
+                {
+                    throw_format(name);
+                }
+
+                munmap(m_header, m_length);
+                m_header = nullptr;
+                map(DATA_OFFSET + static_cast<size_t>(max_size) * sizeof(T), PROT_READ);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        shm_vector(const shm_vector&) = delete;
+        shm_vector& operator = (const shm_vector&) = delete;
+
+        shm_vector(shm_vector&& rhs) noexcept
+            : m_name{ std::move(rhs.m_name) }
+            , m_header{ rhs.m_header }
+            , m_length{ rhs.m_length }
+            , m_committed{ rhs.m_committed }
+            , m_fd{ rhs.m_fd }
+            , m_writer{ rhs.m_writer }
+        {
+            rhs.m_header = nullptr;
+            rhs.m_length = 0;
+            rhs.m_committed = 0;
+            rhs.m_fd = -1;
+            rhs.m_writer = false;
+        }
+
+        ~shm_vector()
+        {
+            release();
+        }
+
+        // Removes a name left behind by a writer that did not exit cleanly
+        static bool unlink(const std::string& name) noexcept
+        {
+            return shm_unlink(name.c_str()) == 0;
+        }
+
+        // Writer only. Throws std::length_error past max_size().
+        void push_back(const_reference value)
+        {
+            append(&value, &value + 1);
+        }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            const value_type value( std::forward<Args>(args)... );
+            append(&value, &value + 1);
+        }
+
+        // Copies the range in and publishes it with one size store, so
+        // readers see all of it or none
+        template<typename ForwardIt>
+        void append(ForwardIt first, ForwardIt last)
+        {
+            check_writer();
+            const auto size = m_header->size.load(std::memory_order_relaxed);
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            if (count > max_size() - size)
+            {
+                throw std::length_error("shm_vector is full");
+            }
+
+            commit(size + count);
+            auto target = data_address() + size;
+            for (; first != last; ++first, ++target)
+            {
+                const value_type value = *first;
+                std::memcpy(static_cast<void*>(target), &value, sizeof(T));
+            }
+            m_header->size.store(size + count, std::memory_order_release);
+        }
+
+        // Elements published so far; every index below it is readable
+        size_type size() const noexcept
+        {
+            return m_header ? static_cast<size_type>(m_header->size.load(std::memory_order_acquire)) : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type max_size() const noexcept
+        {
+            return m_header ? static_cast<size_type>(m_header->max_size) : 0;
+        }
+
+        bool writer() const noexcept
+        {
+            return m_writer;
+        }
+
+        const_reference operator[](size_type index) const noexcept
+        {
+            return data()[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return data()[index];
+        }
+
+        const_pointer data() const noexcept
+        {
+            return data_address();
+        }
+
+        // Iterators cover the elements published when begin() or end() was
+        // called; call end() once per pass
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ data() };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ data() + size() };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+    private:
+        [[noreturn]] static void throw_errno(const std::string& what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        [[noreturn]] static void throw_format(const std::string& name)
+        {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument)
+                                    , name + " is not a shm_vector of this element type");
+        }
+
+        void check_writer() const
+        {
+            if (!m_writer)
+            {
+                throw std::system_error(std::make_error_code(std::errc::operation_not_permitted)
+                                        , "shm_vector reader cannot append");
+            }
+        }
+
+        T* data_address() const noexcept
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(m_header) + DATA_OFFSET);
+        }
+
+        void map(size_t length, int protection)
+        {
+            const auto memory = mmap(nullptr, length, protection, MAP_SHARED, m_fd, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw_errno("mmap");
+            }
+
+            m_header = static_cast<header*>(memory);
+            m_length = length;
+        }
+
+        void resize_object(size_t length)
+        {
+            if (ftruncate(m_fd, static_cast<off_t>(length)))
+            {
+                throw_errno("ftruncate");
+            }
+        }
+
+        // Extends the object to hold count elements, doubling so appends
+        // make a logarithmic number of system calls
+        void commit(size_type count)
+        {
+            if (count <= m_committed)
+            {
+                return;
+            }
+
+            const size_type minimum = 4096 / sizeof(T) + 1;
+            auto target = m_committed * 2 > count ? m_committed * 2 : count;
+            target = target > minimum ? target : minimum;
+            target = target < max_size() ? target : max_size();
+            resize_object(DATA_OFFSET + target * sizeof(T));
+            m_committed = target;
+        }
+
+        void release() noexcept
+        {
+            if (m_header)
+            {
+                munmap(m_header, m_length);
+                m_header = nullptr;
+            }
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+            if (m_writer)
+            {
+                shm_unlink(m_name.c_str());
+                m_writer = false;
+            }
+            m_length = 0;
+        }
+
+        std::string m_name;
+        header* m_header = nullptr;
+        size_t m_length = 0;
+        size_type m_committed = 0;
+        int m_fd = -1;
+        bool m_writer;
+    };
+
+    template<typename T>
+    constexpr size_t shm_vector<T>::CACHE_LINE;
+
+    template<typename T>
+    constexpr uint64_t shm_vector<T>::MAGIC;
+
+    template<typename T>
+    constexpr uint32_t shm_vector<T>::VERSION;
+
+    template<typename T>
+    constexpr size_t shm_vector<T>::DATA_OFFSET;
+}
+
+#endif //OMEGA_SHM_VECTOR_HPP
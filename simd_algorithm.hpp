@@ -0,0 +1,343 @@
+#ifndef OMEGA_SIMD_ALGORITHM_HPP
+#define OMEGA_SIMD_ALGORITHM_HPP
+
+#include "vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define OMEGA_SIMD_X86 1
+#else
+#define OMEGA_SIMD_X86 0
+#endif
+
+namespace omega
+{
+    // find, count, contains, min, max, minmax and sum over contiguous
+    // arithmetic elements. Four and eight byte arithmetic types run SSE2,
+    // AVX2 or AVX-512 kernels picked at runtime from CPUID; other types,
+    // other compilers and other architectures use plain loops.
+    //
+    // sum adds integers modulo 2^bits and reassociates floating point adds
+    // across lanes, so a float sum may differ from std::accumulate in the
+    // last bits. min, max and minmax need a non-empty range, and their
+    // result is unspecified when it holds a NaN.
+    namespace simd
+    {
+        enum class isa
+        {
+            scalar,
+            sse2,
+            avx2,
+            avx512
+        };
+
+        // Best instruction set of this machine, detected once
+        inline isa detected_isa() noexcept
+        {
+#if OMEGA_SIMD_X86
+            static const isa level = [] {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+                    && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+                {
+                    return isa::avx512;
+                }
+                return __builtin_cpu_supports("avx2") ? isa::avx2 : isa::sse2;
+            }();
+            return level;
+#else
+            return isa::scalar;
+#endif
+        }
+
+        template<typename T>
+        struct is_vectorizable
+            : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value
+                                           && (sizeof(T) == 4 || sizeof(T) == 8)>
+        {
+        };
+
+        // Integers are summed unsigned so that overflow wraps instead of
+        // being undefined
+        template<typename T, bool = std::is_integral<T>::value>
+        struct sum_type
+        {
+            using type = T;
+        };
+
+        template<typename T>
+        struct sum_type<T, true>
+        {
+            using type = typename std::make_unsigned<T>::type;
+        };
+
+        namespace scalar
+        {
+            template<typename T>
+            size_t find(const T* data, size_t count, const T& value) noexcept
+            {
+                size_t i = 0;
+                while (i < count && !(data[i] == value))
+                {
+                    ++i;
+                }
+                return i;
+            }
+
+            template<typename T>
+            size_t count(const T* data, size_t count, const T& value) noexcept
+            {
+                size_t total = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    total += data[i] == value;
+                }
+                return total;
+            }
+
+            template<bool Min, bool Max, typename T>
+            void extremes(const T* data, size_t count, T& low, T& high)
+            {
+                low = data[0];
+                high = data[0];
+                for (size_t i = 1; i < count; ++i)
+                {
+                    if (Min && data[i] < low)
+                    {
+                        low = data[i];
+                    }
+                    if (Max && high < data[i])
+                    {
+                        high = data[i];
+                    }
+                }
+            }
+
+            template<typename T>
+            T sum(const T* data, size_t count)
+            {
+                using S = typename sum_type<T>::type;
+                S total = S();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    total += static_cast<S>(data[i]);
+                }
+                return static_cast<T>(total);
+            }
+        }
+
+#if OMEGA_SIMD_X86
+#define OMEGA_SIMD_NAMESPACE sse2
+#define OMEGA_SIMD_BYTES 16
+#include "vector_helpers/simd_kernels.ipp"
+#undef OMEGA_SIMD_NAMESPACE
+#undef OMEGA_SIMD_BYTES
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define OMEGA_SIMD_NAMESPACE avx2
+#define OMEGA_SIMD_BYTES 32
+#include "vector_helpers/simd_kernels.ipp"
+#undef OMEGA_SIMD_NAMESPACE
+#undef OMEGA_SIMD_BYTES
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl")
+#define OMEGA_SIMD_NAMESPACE avx512
+#define OMEGA_SIMD_BYTES 64
+#include "vector_helpers/simd_kernels.ipp"
+#undef OMEGA_SIMD_NAMESPACE
+#undef OMEGA_SIMD_BYTES
+#pragma GCC pop_options
+#endif
+
+        // Runs the kernels of the requested instruction set, or of the best
+        // one this machine has if that is lower
+        template<typename T, bool = is_vectorizable<T>::value && OMEGA_SIMD_X86>
+        struct kernels
+        {
+            static size_t find(const T* data, size_t count, const T& value, isa)
+            {
+                return scalar::find(data, count, value);
+            }
+
+            static size_t count(const T* data, size_t count, const T& value, isa)
+            {
+                return scalar::count(data, count, value);
+            }
+
+            template<bool Min, bool Max>
+            static void extremes(const T* data, size_t count, T& low, T& high, isa)
+            {
+                scalar::extremes<Min, Max>(data, count, low, high);
+            }
+
+            static T sum(const T* data, size_t count, isa)
+            {
+                return scalar::sum(data, count);
+            }
+        };
+
+#if OMEGA_SIMD_X86
+        template<typename T>
+        struct kernels<T, true>
+        {
+            static isa usable(isa level) noexcept
+            {
+                return level < detected_isa() ? level : detected_isa();
+            }
+
+            static size_t find(const T* data, size_t count, T value, isa level)
+            {
+                switch (usable(level))
+                {
+                case isa::avx512: return avx512::find(data, count, value);
+                case isa::avx2: return avx2::find(data, count, value);
+                case isa::sse2: return sse2::find(data, count, value);
+                default: return scalar::find(data, count, value);
+                }
+            }
+
+            static size_t count(const T* data, size_t count, T value, isa level)
+            {
+                switch (usable(level))
+                {
+                case isa::avx512: return avx512::count(data, count, value);
+                case isa::avx2: return avx2::count(data, count, value);
+                case isa::sse2: return sse2::count(data, count, value);
+                default: return scalar::count(data, count, value);
+                }
+            }
+
+            template<bool Min, bool Max>
+            static void extremes(const T* data, size_t count, T& low, T& high, isa level)
+            {
+                switch (usable(level))
+                {
+                case isa::avx512: avx512::extremes<Min, Max>(data, count, low, high); break;
+                case isa::avx2: avx2::extremes<Min, Max>(data, count, low, high); break;
+                case isa::sse2: sse2::extremes<Min, Max>(data, count, low, high); break;
+                default: scalar::extremes<Min, Max>(data, count, low, high); break;
+                }
+            }
+
+            static T sum(const T* data, size_t count, isa level)
+            {
+                switch (usable(level))
+                {
+                case isa::avx512: return avx512::sum(data, count);
+                case isa::avx2: return avx2::sum(data, count);
+                case isa::sse2: return sse2::sum(data, count);
+                default: return scalar::sum(data, count);
+                }
+            }
+        };
+#endif
+
+        // Pointer ranges; level limits the instruction set, mainly for tests
+        // and benchmarks
+
+        template<typename T>
+        const T* find(const T* first, const T* last, const T& value, isa level = detected_isa())
+        {
+            return first + kernels<T>::find(first, static_cast<size_t>(last - first), value, level);
+        }
+
+        template<typename T>
+        size_t count(const T* first, const T* last, const T& value, isa level = detected_isa())
+        {
+            return kernels<T>::count(first, static_cast<size_t>(last - first), value, level);
+        }
+
+        template<typename T>
+        bool contains(const T* first, const T* last, const T& value, isa level = detected_isa())
+        {
+            return simd::find(first, last, value, level) != last;
+        }
+
+        template<typename T>
+        T min(const T* first, const T* last, isa level = detected_isa())
+        {
+            T low = *first;
+            T high = *first;
+            kernels<T>::template extremes<true, false>(first, static_cast<size_t>(last - first), low, high, level);
+            return low;
+        }
+
+        template<typename T>
+        T max(const T* first, const T* last, isa level = detected_isa())
+        {
+            T low = *first;
+            T high = *first;
+            kernels<T>::template extremes<false, true>(first, static_cast<size_t>(last - first), low, high, level);
+            return high;
+        }
+
+        template<typename T>
+        std::pair<T, T> minmax(const T* first, const T* last, isa level = detected_isa())
+        {
+            std::pair<T, T> result{ *first, *first };
+            kernels<T>::template extremes<true, true>(first, static_cast<size_t>(last - first)
+                                                      , result.first, result.second, level);
+            return result;
+        }
+
+        template<typename T>
+        T sum(const T* first, const T* last, isa level = detected_isa())
+        {
+            return kernels<T>::sum(first, static_cast<size_t>(last - first), level);
+        }
+
+        // omega::vector
+
+        template<typename T, typename Allocator>
+        typename vector<T, Allocator>::const_iterator find(const vector<T, Allocator>& values, const T& value)
+        {
+            const auto first = to_address(values.data());
+            return values.cbegin() + (simd::find(first, first + values.size(), value) - first);
+        }
+
+        template<typename T, typename Allocator>
+        size_t count(const vector<T, Allocator>& values, const T& value)
+        {
+            return simd::count(to_address(values.data()), to_address(values.data()) + values.size(), value);
+        }
+
+        template<typename T, typename Allocator>
+        bool contains(const vector<T, Allocator>& values, const T& value)
+        {
+            return simd::contains(to_address(values.data()), to_address(values.data()) + values.size(), value);
+        }
+
+        template<typename T, typename Allocator>
+        T min(const vector<T, Allocator>& values)
+        {
+            return simd::min(to_address(values.data()), to_address(values.data()) + values.size());
+        }
+
+        template<typename T, typename Allocator>
+        T max(const vector<T, Allocator>& values)
+        {
+            return simd::max(to_address(values.data()), to_address(values.data()) + values.size());
+        }
+
+        template<typename T, typename Allocator>
+        std::pair<T, T> minmax(const vector<T, Allocator>& values)
+        {
+            return simd::minmax(to_address(values.data()), to_address(values.data()) + values.size());
+        }
+
+        template<typename T, typename Allocator>
+        T sum(const vector<T, Allocator>& values)
+        {
+            return simd::sum(to_address(values.data()), to_address(values.data()) + values.size());
+        }
+    }
+}
+
+#endif //OMEGA_SIMD_ALGORITHM_HPP
@@ -0,0 +1,346 @@
+#ifndef OMEGA_SOA_VECTOR_HPP
+#define OMEGA_SOA_VECTOR_HPP
+
+#include "vector.hpp"
+#include "vector_helpers/index_sequence.hpp"
+#include "vector_helpers/span.hpp"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+namespace omega
+{
+    // Structure-of-arrays container. Every field lives in its own
+    // omega::vector (with the allocator rebound to the field type) and all
+    // columns are grown together, so a column can be scanned without pulling
+    // the other fields through the cache.
+    template<typename Allocator, typename... Ts>
+    class basic_soa_vector
+    {
+        static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+        template<typename U>
+        using column_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+        template<typename U>
+        using column_type = vector<U, column_allocator<U>>;
+
+        using columns_type = std::tuple<column_type<Ts>...>;
+        using column_indices = make_index_sequence<sizeof...(Ts)>;
+
+    public:
+        using value_type = std::tuple<Ts...>;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::tuple<Ts&...>;
+        using const_reference = std::tuple<const Ts&...>;
+
+        template<size_t I>
+        using column_value_type = typename std::tuple_element<I, value_type>::type;
+
+        basic_soa_vector() = default;
+
+        explicit basic_soa_vector(const allocator_type& alloc)
+            : m_columns{ column_type<Ts>( column_allocator<Ts>( alloc ) )... }
+        {
+        }
+
+        template<typename RowAllocator>
+        explicit basic_soa_vector(const vector<value_type, RowAllocator>& rows
+                                  , const allocator_type& alloc = allocator_type{})
+            : basic_soa_vector{ alloc }
+        {
+            assign(rows);
+        }
+
+        template<typename RowAllocator>
+        void assign(const vector<value_type, RowAllocator>& rows)
+        {
+            clear();
+            reserve(rows.size());
+            for (const auto& row : rows)
+            {
+                push_back(row);
+            }
+        }
+
+        template<typename RowAllocator = std::allocator<value_type>>
+        vector<value_type, RowAllocator> to_aos(const RowAllocator& alloc = RowAllocator{}) const
+        {
+            vector<value_type, RowAllocator> rows( alloc );
+            rows.reserve(size());
+            for (size_type i = 0; i < size(); ++i)
+            {
+                emplace_row(rows, i, column_indices{});
+            }
+            return rows;
+        }
+
+        void push_back(const value_type& row)
+        {
+            push_back_row(row, column_indices{});
+        }
+
+        void push_back(value_type&& row)
+        {
+            push_back_row(std::move(row), column_indices{});
+        }
+
+        // One argument per column, each forwarded to that column's constructor
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back needs one argument per column");
+
+            if (size() == capacity())
+            {
+                // args may refer to elements that growth frees, so the row
+                // is built before the columns move
+                value_type row( std::forward<Args>(args)... );
+                reserve(capacity() * 2 + 1);
+                push_back_row(std::move(row), column_indices{});
+                return;
+            }
+
+            emplace_columns<0>(std::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            pop_back_columns(column_indices{});
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            reserve_columns(new_capacity, column_indices{});
+        }
+
+        void resize(size_type count)
+        {
+            const auto old_size = size();
+            if (count > old_size)
+            {
+                reserve(count);
+            }
+
+            resize_columns<0>(count, old_size);
+        }
+
+        void shrink_to_fit()
+        {
+            shrink_columns(column_indices{});
+        }
+
+        void clear() noexcept
+        {
+            clear_columns(column_indices{});
+        }
+
+        reference operator[](size_type index)
+        {
+            return row(index, column_indices{});
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return row(index, column_indices{});
+        }
+
+        reference at(size_type index)
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return row(index, column_indices{});
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return row(index, column_indices{});
+        }
+
+        reference front()
+        {
+            return row(0, column_indices{});
+        }
+
+        const_reference front() const
+        {
+            return row(0, column_indices{});
+        }
+
+        reference back()
+        {
+            return row(size() - 1, column_indices{});
+        }
+
+        const_reference back() const
+        {
+            return row(size() - 1, column_indices{});
+        }
+
+        template<size_t I>
+        span<column_value_type<I>> column() noexcept
+        {
+            auto& column = std::get<I>(m_columns);
+            return span<column_value_type<I>>{ column.data(), column.size() };
+        }
+
+        template<size_t I>
+        span<const column_value_type<I>> column() const noexcept
+        {
+            const auto& column = std::get<I>(m_columns);
+            return span<const column_value_type<I>>{ column.data(), column.size() };
+        }
+
+        size_type size() const noexcept
+        {
+            return std::get<0>(m_columns).size();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return min_capacity(column_indices{});
+        }
+
+        void swap(basic_soa_vector& rhs) noexcept
+        {
+            swap_columns(rhs, column_indices{});
+        }
+
+    private:
+        template<typename Row, size_t... Is>
+        void push_back_row(Row&& row, index_sequence<Is...>)
+        {
+            emplace_back(std::get<Is>(std::forward<Row>(row))...);
+        }
+
+        template<typename Rows, size_t... Is>
+        void emplace_row(Rows& rows, size_type index, index_sequence<Is...>) const
+        {
+            rows.emplace_back(std::get<Is>(m_columns)[index]...);
+        }
+
+        template<size_t... Is>
+        reference row(size_type index, index_sequence<Is...>)
+        {
+            return reference{ std::get<Is>(m_columns)[index]... };
+        }
+
+        template<size_t... Is>
+        const_reference row(size_type index, index_sequence<Is...>) const
+        {
+            return const_reference{ std::get<Is>(m_columns)[index]... };
+        }
+
+        // Capacity is reserved up front, so a column can only fail while
+        // constructing its element; the columns already extended are rolled back.
+        template<size_t I, typename Arg, typename... Rest>
+        void emplace_columns(Arg&& arg, Rest&&... rest)
+        {
+            auto& column = std::get<I>(m_columns);
+            column.emplace_back(std::forward<Arg>(arg));
+            try
+            {
+                emplace_columns<I + 1>(std::forward<Rest>(rest)...);
+            }
+            catch (...)
+            {
+                column.pop_back();
+                throw;
+            }
+        }
+
+        template<size_t I>
+        void emplace_columns()
+        {
+        }
+
+        template<size_t I>
+        typename std::enable_if<(I < sizeof...(Ts))>::type resize_columns(size_type count, size_type old_size)
+        {
+            auto& column = std::get<I>(m_columns);
+            column.resize(count);
+            try
+            {
+                resize_columns<I + 1>(count, old_size);
+            }
+            catch (...)
+            {
+                column.resize(old_size);
+                throw;
+            }
+        }
+
+        template<size_t I>
+        typename std::enable_if<(I == sizeof...(Ts))>::type resize_columns(size_type, size_type)
+        {
+        }
+
+        template<size_t... Is>
+        void pop_back_columns(index_sequence<Is...>)
+        {
+            const int expand[] = { (std::get<Is>(m_columns).pop_back(), 0)... };
+            (void)expand;
+        }
+
+        template<size_t... Is>
+        void reserve_columns(size_type new_capacity, index_sequence<Is...>)
+        {
+            const int expand[] = { (std::get<Is>(m_columns).reserve(new_capacity), 0)... };
+            (void)expand;
+        }
+
+        template<size_t... Is>
+        void shrink_columns(index_sequence<Is...>)
+        {
+            const int expand[] = { (std::get<Is>(m_columns).shrink_to_fit(), 0)... };
+            (void)expand;
+        }
+
+        template<size_t... Is>
+        void clear_columns(index_sequence<Is...>) noexcept
+        {
+            const int expand[] = { (std::get<Is>(m_columns).clear(), 0)... };
+            (void)expand;
+        }
+
+        template<size_t... Is>
+        void swap_columns(basic_soa_vector& rhs, index_sequence<Is...>) noexcept
+        {
+            const int expand[] = { (std::get<Is>(m_columns).swap(std::get<Is>(rhs.m_columns)), 0)... };
+            (void)expand;
+        }
+
+        // A failed reserve can leave the leading columns bigger than the rest,
+        // so the usable capacity is the smallest one.
+        template<size_t... Is>
+        size_type min_capacity(index_sequence<Is...>) const noexcept
+        {
+            const size_type capacities[] = { std::get<Is>(m_columns).capacity()... };
+            return *std::min_element(capacities, capacities + sizeof...(Is));
+        }
+
+        columns_type m_columns;
+    };
+
+    template<typename... Ts>
+    using soa_vector = basic_soa_vector<std::allocator<std::tuple<Ts...>>, Ts...>;
+}
+
+#endif //OMEGA_SOA_VECTOR_HPP
@@ -0,0 +1,84 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include "../aligned_allocator.hpp"
+#include "../ring_buffer.hpp"
+#include "../vector.hpp"
+#include "allocator.hpp"
+
+template class omega::vector<float, omega::aligned_allocator<float, 64>>;
+template class omega::vector<std::string, omega::aligned_allocator<std::string, 128>>;
+
+namespace
+{
+    template<typename T>
+    bool aligned(const T* p, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    }
+
+    struct alignas(32) wide
+    {
+        double values[4];
+    };
+}
+
+TEST_CASE( "allocator_alignment", "[aligned_allocator]" ) {
+    REQUIRE( omega::allocator_alignment<std::allocator<double>>::value == alignof(double) );
+    REQUIRE( omega::allocator_alignment<allocator<int>>::value == alignof(int) );
+    REQUIRE( (omega::allocator_alignment<omega::aligned_allocator<float, 64>>::value == 64) );
+    REQUIRE( (omega::allocator_alignment<omega::aligned_allocator<wide, 16>>::value == 32) );
+    using rebound = std::allocator_traits<omega::aligned_allocator<float, 128>>::rebind_alloc<char>;
+    REQUIRE( omega::allocator_alignment<rebound>::value == 128 );
+}
+
+TEST_CASE( "aligned vectors stay aligned", "[aligned_allocator]" ) {
+    using aligned_vector = omega::vector<float, omega::aligned_allocator<float, 64>>;
+    aligned_vector values;
+
+    SECTION( "growth" ) {
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(static_cast<float>(i));
+            REQUIRE( aligned(values.data(), 64) );
+        }
+        REQUIRE( values[999] == 999.0f );
+    }
+    SECTION( "reserve, resize, shrink and insert" ) {
+        values.reserve(100);
+        REQUIRE( aligned(values.data(), 64) );
+        values.resize(37, 1.5f);
+        REQUIRE( aligned(values.data(), 64) );
+        values.shrink_to_fit();
+        REQUIRE( (aligned(values.data(), 64) && values.capacity() == 37) );
+        values.insert(values.cbegin() + 3, 5, 2.0f);
+        REQUIRE( (aligned(values.data(), 64) && values[3] == 2.0f && values.size() == 42) );
+        values.erase(values.cbegin(), values.cbegin() + 10);
+        REQUIRE( aligned(values.data(), 64) );
+        values.assign(omega::parallel, 50000, 3.0f);
+        REQUIRE( (aligned(values.data(), 64) && values[49999] == 3.0f) );
+    }
+    SECTION( "copy, move and swap" ) {
+        values.assign({ 1.0f, 2.0f, 3.0f });
+        aligned_vector copy{ values };
+        aligned_vector moved{ std::move(copy) };
+        aligned_vector other{ 9.0f };
+        other.swap(moved);
+        REQUIRE( (aligned(other.data(), 64) && aligned(moved.data(), 64)) );
+        REQUIRE( (other.size() == 3 && moved[0] == 9.0f) );
+        moved = other;
+        REQUIRE( (aligned(moved.data(), 64) && moved == other) );
+    }
+    SECTION( "class types and other containers" ) {
+        omega::vector<std::string, omega::aligned_allocator<std::string, 128>> words{ "a", "b" };
+        words.push_back("c");
+        REQUIRE( (aligned(words.data(), 128) && words[2] == "c") );
+
+        omega::ring_buffer<double, omega::aligned_allocator<double, 64>> ring;
+        for (int i = 0; i < 100; ++i)
+        {
+            ring.push_back(i);
+        }
+        REQUIRE( (ring.front() == 0 && ring.back() == 99) );
+    }
+}
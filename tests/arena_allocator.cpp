@@ -0,0 +1,102 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include "../arena_allocator.hpp"
+#include "../vector.hpp"
+
+namespace
+{
+    struct alignas(64) line
+    {
+        uint64_t values[8];
+    };
+}
+
+template class omega::vector<int, omega::arena_allocator<int>>;
+template class omega::vector<std::string, omega::arena_allocator<std::string>>;
+
+static_assert(omega::allocator_expand<omega::arena_allocator<std::string>>::value, "arena blocks grow in place");
+static_assert(!omega::allocator_expand<std::allocator<int>>::value, "std::allocator has no hook");
+
+TEST_CASE( "arena_allocator", "[arena_allocator]" ) {
+    SECTION( "blocks are aligned and come from chunks" ) {
+        omega::monotonic_arena arena{ 4096 };
+        const auto small = arena.allocate(3, 1);
+        const auto aligned = arena.allocate(sizeof(line), alignof(line));
+        REQUIRE( (small && reinterpret_cast<uintptr_t>(aligned) % alignof(line) == 0) );
+        REQUIRE( arena.bytes_used() == 3 + sizeof(line) );
+
+        // bigger than the next chunk
+        const auto big = static_cast<char*>(arena.allocate(1 << 20, 16));
+        big[(1 << 20) - 1] = 1;
+        REQUIRE( arena.bytes_reserved() > (1 << 20) + 4096 );
+    }
+    SECTION( "only the top block expands" ) {
+        omega::monotonic_arena arena;
+        const auto first = arena.allocate(64, 8);
+        const auto second = arena.allocate(64, 8);
+        REQUIRE( !arena.try_expand(first, 64, 128) );
+        REQUIRE( arena.try_expand(second, 64, 128) );
+        REQUIRE( arena.allocate(8, 8) == static_cast<char*>(second) + 128 );
+        REQUIRE( !arena.try_expand(second, 128, omega::monotonic_arena::DEFAULT_CHUNK) );
+    }
+    SECTION( "vector grows in place" ) {
+        omega::monotonic_arena arena;
+        omega::arena_allocator<int> alloc{ arena };
+        omega::vector<int, omega::arena_allocator<int>> values(alloc);
+        values.push_back(0);
+        const auto data = values.data();
+        // the argument refers into the buffer that grows
+        while (values.size() < 1000)
+        {
+            values.push_back(values[values.size() - 1] + 1);
+        }
+        REQUIRE( (values.data() == data && values[999] == 999) );
+        REQUIRE( arena.bytes_used() == values.capacity() * sizeof(int) );
+
+        values.reserve(2000);
+        REQUIRE( (values.data() == data && values.capacity() == 2000) );
+
+        // another block on top stops the expansion
+        arena.allocate(1, 1);
+        values.reserve(4000);
+        REQUIRE( (values.data() != data && values[500] == 500 && values.capacity() == 4000) );
+    }
+    SECTION( "class types" ) {
+        omega::monotonic_arena arena;
+        omega::vector<std::string, omega::arena_allocator<std::string>> words(omega::arena_allocator<std::string>{ arena });
+        for (int i = 0; i < 3000; ++i)
+        {
+            words.push_back(std::to_string(i) + " is a number long enough to be on the heap");
+        }
+        words.push_back(words[1]);
+        REQUIRE( (words[2999].substr(0, 4) == "2999" && words.back() == words[1]) );
+    }
+    SECTION( "reset keeps the largest chunk" ) {
+        omega::monotonic_arena arena{ 1024 };
+        for (int i = 0; i < 100; ++i)
+        {
+            arena.allocate(1000, 8);
+        }
+        const auto reserved = arena.bytes_reserved();
+        arena.reset();
+        REQUIRE( (arena.bytes_used() == 0 && arena.bytes_reserved() < reserved && arena.bytes_reserved() > 0) );
+        const auto kept = arena.bytes_reserved();
+        arena.allocate(1000, 8);
+        REQUIRE( arena.bytes_reserved() == kept );
+    }
+    SECTION( "vectors of different arenas" ) {
+        omega::monotonic_arena first_arena;
+        omega::monotonic_arena second_arena;
+        omega::arena_allocator<int> first_alloc{ first_arena };
+        omega::arena_allocator<int> second_alloc{ second_arena };
+        REQUIRE( (first_alloc != second_alloc && first_alloc == omega::arena_allocator<long>(first_alloc)) );
+
+        omega::vector<int, omega::arena_allocator<int>> first(first_alloc);
+        omega::vector<int, omega::arena_allocator<int>> second(second_alloc);
+        first.assign({ 1, 2, 3 });
+        // the elements are copied into the second arena
+        second = std::move(first);
+        REQUIRE( (second.size() == 3 && second[2] == 3 && second_arena.bytes_used() == 3 * sizeof(int)) );
+    }
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include <stdexcept>
+#include <vector>
+#include "../bit_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::bit_vector<>;
+template class omega::bit_vector<allocator<uint64_t>>;
+
+TEST_CASE( "bit_vector element access", "[bit_vector]" ) {
+    omega::bit_vector<> v { true, false, true };
+
+    SECTION( "initializer_list" ) {
+        REQUIRE( v.size() == 3 );
+        REQUIRE( (v[0] && !v[1] && v[2]) );
+    }
+    SECTION( "proxy reference writes through" ) {
+        v[1] = true;
+        v[0] = v[1];
+        v[2].flip();
+        REQUIRE( (v[0] && v[1] && !v[2]) );
+    }
+    SECTION( "push_back across word boundary" ) {
+        for (int i = 0; i < 130; ++i)
+        {
+            v.push_back(i % 3 == 0);
+        }
+        REQUIRE( v.size() == 133 );
+        REQUIRE( v.capacity() >= 133 );
+        REQUIRE( (v[3] && !v[4] && v[132]) );
+        REQUIRE( v.words().size() == 3 );
+    }
+    SECTION( "pop_back clears the popped bit" ) {
+        v.pop_back();
+        v.push_back(false);
+        REQUIRE( (v.size() == 3 && !v.back()) );
+    }
+    SECTION( "at - index out of range" ) {
+        REQUIRE_THROWS_AS( v.at(3), std::out_of_range );
+        const auto& cv = v;
+        REQUIRE_THROWS_AS( cv.at(3), std::out_of_range );
+    }
+    SECTION( "resize with value" ) {
+        v.resize(100, true);
+        REQUIRE( (v.size() == 100 && v.count() == 99 && !v[1]) );
+        v.resize(2);
+        REQUIRE( v.count() == 1 );
+        v.resize(70);
+        REQUIRE( v.count() == 1 );
+    }
+    SECTION( "clear" ) {
+        v.clear();
+        REQUIRE( (v.empty() && v.none()) );
+    }
+}
+
+TEST_CASE( "bit_vector word operations", "[bit_vector]" ) {
+    omega::bit_vector<> v;
+    v.resize(200);
+
+    SECTION( "set_range inside one word" ) {
+        v.set_range(3, 10);
+        REQUIRE( v.count() == 7 );
+        REQUIRE( (!v[2] && v[3] && v[9] && !v[10]) );
+    }
+    SECTION( "set_range across words" ) {
+        v.set_range(60, 190);
+        REQUIRE( v.count() == 130 );
+        v.set_range(64, 128, false);
+        REQUIRE( v.count() == 66 );
+        REQUIRE( (v[63] && !v[64] && !v[127] && v[128]) );
+    }
+    SECTION( "set_range out of range" ) {
+        REQUIRE_THROWS_AS( v.set_range(10, 201), std::out_of_range );
+        REQUIRE_THROWS_AS( v.set_range(10, 5), std::out_of_range );
+    }
+    SECTION( "find_first and find_next" ) {
+        REQUIRE( v.find_first() == omega::bit_vector<>::npos );
+        v.set(5);
+        v.set(64);
+        v.set(199);
+        std::vector<size_t> found;
+        for (auto i = v.find_first(); i != omega::bit_vector<>::npos; i = v.find_next(i))
+        {
+            found.push_back(i);
+        }
+        REQUIRE( found == (std::vector<size_t>{ 5, 64, 199 }) );
+    }
+    SECTION( "flip all keeps the tail clear" ) {
+        v.flip();
+        REQUIRE( v.count() == 200 );
+        v.push_back(false);
+        REQUIRE( v.count() == 200 );
+    }
+}
+
+TEST_CASE( "bit_vector bitwise operators", "[bit_vector]" ) {
+    omega::bit_vector<> a;
+    omega::bit_vector<> b;
+    a.resize(300);
+    b.resize(300);
+    a.set_range(0, 200);
+    b.set_range(100, 300);
+
+    SECTION( "and" ) {
+        REQUIRE( (a & b).count() == 100 );
+    }
+    SECTION( "or" ) {
+        REQUIRE( (a | b).count() == 300 );
+    }
+    SECTION( "xor" ) {
+        auto c = a ^ b;
+        REQUIRE( c.count() == 200 );
+        REQUIRE( (c[99] && !c[100] && !c[199] && c[200]) );
+    }
+    SECTION( "different sizes" ) {
+        b.push_back(true);
+        REQUIRE_THROWS_AS( a &= b, std::invalid_argument );
+    }
+}
@@ -1,12 +1,18 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+#include <atomic>
+#include <limits>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <stdexcept>
 #include <vector>
 #include <list>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "../vector.hpp"
 #include "allocator.hpp"
+#include "offset_allocator.hpp"
 
 class Test
 {
@@ -51,6 +57,7 @@ omega::vector<int> foo(omega::vector<int> v)
 template class omega::vector<int>;
 template class omega::vector<std::string>;
 template class omega::vector<Test>;
+template class omega::vector<int, offset_allocator<int>>;
 
 TEMPLATE_TEST_CASE( "vectors can be sized and resized", "[vector][template]", int, std::string, Test, (std::tuple<int,float>) )
 {
@@ -731,3 +738,214 @@ TEST_CASE( "iterators", "[vector]" ) {
         REQUIRE( (v.cbegin() <= v.begin() && v.begin() <= v.cend() && it0 >= it2 && it0 <= it2) );
     }
 }
+
+// Counts live instances; the copy constructor throws once copies_left runs out
+struct Counted
+{
+    static std::atomic<int> live;
+    static std::atomic<int> copies_left;
+
+    explicit Counted(int v) : value(v) { ++live; }
+
+    Counted(const Counted& rhs) : value(rhs.value)
+    {
+        if (copies_left.fetch_sub(1) == 0)
+        {
+            throw std::runtime_error("copy failed");
+        }
+        ++live;
+    }
+
+    ~Counted() { --live; }
+
+    int value;
+};
+
+std::atomic<int> Counted::live{ 0 };
+std::atomic<int> Counted::copies_left{ -1 };
+
+TEST_CASE( "parallel construction", "[vector]" ) {
+    const omega::parallel_policy four{ 4 };
+    std::vector<std::string> source;
+    for (int i = 0; i < 50000; ++i)
+    {
+        source.push_back(std::to_string(i));
+    }
+
+    SECTION( "from iterators and copies" ) {
+        omega::vector<std::string> v(omega::parallel, source.begin(), source.end());
+        REQUIRE( (v.size() == source.size() && v[0] == "0" && v[49999] == "49999") );
+        omega::vector<std::string> copy(four, v);
+        REQUIRE( std::equal(copy.begin(), copy.end(), source.begin()) );
+        std::list<int> list{ 1, 2, 3 };
+        omega::vector<int> small(four, list.begin(), list.end());
+        REQUIRE( (small.size() == 3 && small[2] == 3) );
+    }
+    SECTION( "assign" ) {
+        omega::vector<std::string> v{ "old" };
+        v.assign(four, 30000, "x");
+        REQUIRE( (v.size() == 30000 && v[0] == "x" && v[29999] == "x") );
+        v.assign(four, source.begin(), source.begin() + 10);
+        REQUIRE( (v.size() == 10 && v[9] == "9") );
+        v.assign(four, 0, "y");
+        REQUIRE( v.empty() );
+    }
+    SECTION( "resize keeps the elements" ) {
+        omega::vector<std::string> v(four, source.begin(), source.begin() + 20000);
+        v.resize(four, 60000, v[5]);
+        REQUIRE( (v.size() == 60000 && v[19999] == "19999" && v[20000] == "5" && v[59999] == "5") );
+        v.resize(four, 30000);
+        REQUIRE( (v.size() == 30000 && v[29999] == "5") );
+        v.resize(four, 40000);
+        REQUIRE( (v.size() == 40000 && v[39999].empty()) );
+    }
+    SECTION( "custom allocator" ) {
+        omega::vector<int, allocator<int>> v;
+        v.assign(four, 20000, 7);
+        REQUIRE( (v.size() == 20000 && v[19999] == 7) );
+    }
+    SECTION( "a throwing copy unwinds every chunk" ) {
+        {
+            omega::vector<Counted> v;
+            v.reserve(20000);
+            for (int i = 0; i < 20000; ++i)
+            {
+                v.emplace_back(i);
+            }
+            Counted::copies_left = 15000;
+            REQUIRE_THROWS_AS( (omega::vector<Counted>(four, v)), std::runtime_error );
+            Counted::copies_left = 15000;
+            REQUIRE_THROWS_AS( v.assign(four, 20000, Counted{ 1 }), std::runtime_error );
+            Counted::copies_left = -1;
+            REQUIRE( (v.size() == 20000 && v[19999].value == 19999) );
+            REQUIRE( Counted::live == 20000 );
+
+            // Counted has no move constructor, so resize copies the old
+            // elements and a throwing fill leaves them intact
+            Counted::copies_left = 30000;
+            REQUIRE_THROWS_AS( v.resize(four, 60000, Counted{ 2 }), std::runtime_error );
+            Counted::copies_left = -1;
+            REQUIRE( (v.size() == 20000 && v[12345].value == 12345 && Counted::live == 20000) );
+        }
+        REQUIRE( Counted::live == 0 );
+    }
+}
+
+TEST_CASE( "comparison operators", "[vector]" ) {
+    SECTION( "integers" ) {
+        omega::vector<int> a{ 1, 2, 3 };
+        omega::vector<int> b{ 1, 2, 3 };
+        omega::vector<int> c{ 1, 2, 4 };
+        omega::vector<int> prefix{ 1, 2 };
+        omega::vector<int> negative{ -1, 2, 3 };
+        REQUIRE( (a == b && !(a != b) && a != c && a != prefix) );
+        REQUIRE( (a < c && !(c < a) && prefix < a && negative < a) );
+        REQUIRE( (c > a && a <= b && a >= b && a <= c && !(a >= c)) );
+        REQUIRE( (omega::vector<int>{} == omega::vector<int>{} && omega::vector<int>{} < prefix) );
+    }
+    SECTION( "long integer ranges differ late" ) {
+        omega::vector<long> a;
+        a.resize(1000, 5);
+        auto b = a;
+        REQUIRE( a == b );
+        b[900] = 6;
+        REQUIRE( (a != b && a < b && !(b < a)) );
+        b[900] = -6;
+        REQUIRE( b < a );
+    }
+    SECTION( "unsigned bytes" ) {
+        omega::vector<unsigned char> a{ 1, 200, 3 };
+        omega::vector<unsigned char> b{ 1, 200 };
+        omega::vector<unsigned char> c{ 1, 201 };
+        REQUIRE( (b < a && a < c && !(c < a) && a == a) );
+    }
+    SECTION( "floating point compares values, not bytes" ) {
+        omega::vector<double> zero{ 0.0 };
+        omega::vector<double> negative_zero{ -0.0 };
+        omega::vector<double> nan{ std::numeric_limits<double>::quiet_NaN() };
+        REQUIRE( zero == negative_zero );
+        REQUIRE( nan != nan );
+    }
+    SECTION( "strings" ) {
+        omega::vector<std::string> a{ "apple", "pear" };
+        omega::vector<std::string> b{ "apple", "plum" };
+        REQUIRE( (a != b && a < b && b > a) );
+    }
+}
+
+TEST_CASE( "hash", "[vector]" ) {
+    SECTION( "byte hash matches xxHash64" ) {
+        REQUIRE( omega::hash_bytes::hash("", 0) == 0xef46db3751d8e999ull );
+        REQUIRE( omega::hash_bytes::hash("abc", 3) == 0x44bc2cf5ad770999ull );
+        const std::string text = "Nobody inspects the spammish repetition";
+        REQUIRE( omega::hash_bytes::hash(text.data(), text.size()) == 0xfbcea83c8a378bf1ull );
+    }
+    SECTION( "equal vectors hash equal" ) {
+        omega::vector<int> a{ 1, 2, 3 };
+        omega::vector<int> b{ 1, 2, 3 };
+        omega::vector<int> c{ 1, 2, 4 };
+        const omega::hash<omega::vector<int>> hasher;
+        REQUIRE( hasher(a) == hasher(b) );
+        REQUIRE( hasher(a) != hasher(c) );
+        omega::vector<double> zero{ 0.0, 1.0 };
+        omega::vector<double> negative_zero{ -0.0, 1.0 };
+        REQUIRE( std::hash<omega::vector<double>>{}(zero) == std::hash<omega::vector<double>>{}(negative_zero) );
+    }
+    SECTION( "vectors as unordered_map keys" ) {
+        std::unordered_map<omega::vector<std::string>, int> cache;
+        cache[omega::vector<std::string>{ "a", "b" }] = 1;
+        cache[omega::vector<std::string>{ "b", "a" }] = 2;
+        REQUIRE( cache.size() == 2 );
+        REQUIRE( cache.at(omega::vector<std::string>{ "a", "b" }) == 1 );
+    }
+}
+
+TEST_CASE( "fancy pointers", "[vector]" ) {
+    using shared_vector = omega::vector<int, offset_allocator<int>>;
+    const size_t bytes = 1 << 20;
+    char path[] = "/tmp/omega_fancy_XXXXXX";
+    const auto fd = mkstemp(path);
+    REQUIRE( fd >= 0 );
+    unlink(path);
+    REQUIRE( ftruncate(fd, bytes) == 0 );
+
+    // one block mapped twice stands in for a segment shared by two processes
+    const auto first = static_cast<char*>(mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    const auto second = static_cast<char*>(mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+    REQUIRE( (first != MAP_FAILED && second != MAP_FAILED && first != second) );
+
+    const auto arena = offset_arena::create(first, bytes);
+    const auto slot = arena->allocate(sizeof(shared_vector), alignof(shared_vector));
+    const auto offset = static_cast<char*>(slot) - first;
+    auto& writer = *new (slot) shared_vector( offset_allocator<int>{ arena } );
+    for (int i = 0; i < 1000; ++i)
+    {
+        writer.push_back(i);
+    }
+    writer.insert(writer.begin() + 1, { -1, -2 });
+    writer.erase(writer.begin() + 3, writer.begin() + 5);
+    writer.emplace(writer.end(), 5000);
+
+    auto& reader = *reinterpret_cast<shared_vector*>(second + offset);
+    REQUIRE( (reader.size() == 1001 && reader[1] == -1 && reader[3] == 3 && reader.back() == 5000) );
+    REQUIRE( (&reader[0] != &writer[0] && reader == writer) );
+    REQUIRE( omega::hash<shared_vector>{}(reader) == omega::hash<shared_vector>{}(writer) );
+    long long sum = 0;
+    for (auto it = reader.cbegin(); it != reader.cend(); ++it)
+    {
+        sum += *it;
+    }
+    REQUIRE( sum == 999 * 1000 / 2 - 3 - 1 - 2 + 5000 );
+    REQUIRE( *reader.rbegin() == 5000 );
+
+    reader.resize(2000, 7);
+    REQUIRE( (writer.size() == 2000 && writer[1999] == 7 && writer.data()[1000] == 5000) );
+    shared_vector copy( writer );
+    REQUIRE( copy == reader );
+    copy.clear();
+    writer.~shared_vector();
+
+    munmap(first, bytes);
+    munmap(second, bytes);
+}
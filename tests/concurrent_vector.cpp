@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../concurrent_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::concurrent_vector<int>;
+template class omega::concurrent_vector<std::string>;
+
+TEST_CASE( "concurrent_vector on one thread", "[concurrent_vector]" ) {
+    omega::concurrent_vector<std::string> values;
+
+    SECTION( "push_back returns the index" ) {
+        REQUIRE( values.push_back("a") == 0 );
+        REQUIRE( values.emplace_back(3, 'b') == 1 );
+        REQUIRE( (values[0] == "a" && values.at(1) == "bbb") );
+        REQUIRE( values.size() == 2 );
+        REQUIRE_FALSE( values.ready(2) );
+        REQUIRE_THROWS_AS( values.at(2), std::out_of_range );
+    }
+    SECTION( "growth never moves elements" ) {
+        values.push_back("first");
+        const auto address = &values[0];
+        for (int i = 0; i < 5000; ++i)
+        {
+            values.push_back(std::to_string(i));
+        }
+        REQUIRE( &values[0] == address );
+        REQUIRE( values[5000] == "4999" );
+    }
+    SECTION( "grow_by spans segments" ) {
+        values.push_back("x");
+        REQUIRE( values.grow_by(100, "y") == 1 );
+        REQUIRE( values.grow_by(3) == 101 );
+        REQUIRE( values.size() == 104 );
+        REQUIRE( (values[31] == "y" && values[32] == "y" && values[100] == "y") );
+        REQUIRE( (values.ready(103) && values[103].empty()) );
+    }
+    SECTION( "to_vector and clear" ) {
+        for (int i = 0; i < 100; ++i)
+        {
+            values.push_back(std::to_string(i));
+        }
+        const auto copy = values.to_vector();
+        REQUIRE( (copy.size() == 100 && copy[99] == "99") );
+        values.clear();
+        REQUIRE( values.empty() );
+        REQUIRE( values.push_back("again") == 0 );
+    }
+    SECTION( "custom allocator" ) {
+        omega::concurrent_vector<int, allocator<int>> numbers;
+        numbers.grow_by(1000, 7);
+        REQUIRE( numbers.to_vector().size() == 1000 );
+    }
+}
+
+TEST_CASE( "concurrent_vector with many writers", "[concurrent_vector]" ) {
+    const int threads = 8;
+    const int per_thread = 20000;
+    omega::concurrent_vector<int> values;
+    std::atomic<int> mismatches{ 0 };
+
+    // Catch assertions are not thread safe, so writers only count mismatches
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+    {
+        writers.emplace_back([&values, &mismatches, t] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                if (i % 100 == 0)
+                {
+                    const auto first = values.grow_by(10, t * per_thread + i);
+                    mismatches += values[first + 9] != t * per_thread + i;
+                    i += 9;
+                    continue;
+                }
+                const auto index = values.push_back(t * per_thread + i);
+                mismatches += values[index] != t * per_thread + i;
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    REQUIRE( mismatches == 0 );
+    REQUIRE( values.size() == static_cast<size_t>(threads * per_thread) );
+    auto all = values.to_vector();
+    std::vector<int> sorted(all.begin(), all.end());
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> expected;
+    for (int t = 0; t < threads; ++t)
+    {
+        for (int i = 0; i < per_thread; ++i)
+        {
+            expected.push_back(i % 100 < 10 ? t * per_thread + i - i % 100 : t * per_thread + i);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE( sorted == expected );
+}
@@ -0,0 +1,159 @@
+#include "catch.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../cow_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::cow_vector<int>;
+template class omega::cow_vector<std::string>;
+
+namespace
+{
+    std::size_t allocations = 0;
+
+    template<typename T>
+    class counting_allocator : public allocator<T>
+    {
+    public:
+        counting_allocator() noexcept {}
+        template<typename U> counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        template<typename U>
+        struct rebind
+        {
+            using other = counting_allocator<U>;
+        };
+
+        T* allocate(std::size_t n)
+        {
+            ++allocations;
+            return allocator<T>::allocate(n);
+        }
+    };
+
+    template<typename T, typename U>
+    bool operator == (const counting_allocator<T>&, const counting_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U>
+    bool operator != (const counting_allocator<T>&, const counting_allocator<U>&) noexcept
+    {
+        return false;
+    }
+
+    template<typename Vector>
+    std::vector<typename Vector::value_type> contents(const Vector& values)
+    {
+        return std::vector<typename Vector::value_type>(values.cbegin(), values.cend());
+    }
+}
+
+TEST_CASE( "cow_vector sharing", "[cow_vector]" ) {
+    const omega::cow_vector<std::string> original{ "a", "b", "c" };
+
+    SECTION( "copies share the buffer" ) {
+        const auto copy = original;
+        REQUIRE( copy.use_count() == 2 );
+        REQUIRE( copy.data() == original.data() );
+        REQUIRE( contents(copy) == contents(original) );
+    }
+    SECTION( "a write clones a shared buffer once" ) {
+        auto copy = original;
+        copy[1] = "x";
+        copy.at(2) = "y";
+        REQUIRE( copy.data() != original.data() );
+        REQUIRE( (original.use_count() == 1 && copy.use_count() == 1) );
+        REQUIRE( contents(original) == (std::vector<std::string>{ "a", "b", "c" }) );
+        REQUIRE( contents(copy) == (std::vector<std::string>{ "a", "x", "y" }) );
+    }
+    SECTION( "a buffer with mutable references out is not shared" ) {
+        auto values = original;
+        auto& first = values[0];
+        const auto copy = values;
+        first = "z";
+        REQUIRE( copy.data() != values.data() );
+        REQUIRE( copy[0] == "a" );
+        REQUIRE( values[0] == "z" );
+    }
+    SECTION( "push_back, pop_back, resize and clear on a shared copy" ) {
+        auto pushed = original;
+        pushed.push_back(pushed[0]);
+        auto popped = original;
+        popped.pop_back();
+        auto resized = original;
+        resized.resize(4, "d");
+        auto cleared = original;
+        cleared.clear();
+
+        REQUIRE( contents(pushed) == (std::vector<std::string>{ "a", "b", "c", "a" }) );
+        REQUIRE( contents(popped) == (std::vector<std::string>{ "a", "b" }) );
+        REQUIRE( contents(resized) == (std::vector<std::string>{ "a", "b", "c", "d" }) );
+        REQUIRE( (cleared.empty() && cleared.capacity() == 0) );
+        REQUIRE( original.use_count() == 1 );
+        REQUIRE( contents(original) == (std::vector<std::string>{ "a", "b", "c" }) );
+    }
+    SECTION( "move leaves the source empty" ) {
+        auto copy = original;
+        const auto moved = std::move(copy);
+        REQUIRE( copy.empty() );
+        REQUIRE( moved.use_count() == 2 );
+        REQUIRE_THROWS_AS( moved.at(3), std::out_of_range );
+    }
+}
+
+TEST_CASE( "cow_vector storage", "[cow_vector]" ) {
+    SECTION( "the header shares the allocation with the elements" ) {
+        allocations = 0;
+        omega::cow_vector<double, counting_allocator<double>> values;
+        values.reserve(10);
+        for (int i = 0; i < 10; ++i)
+        {
+            values.push_back(i);
+        }
+        const auto copy = values;
+        REQUIRE( allocations == 1 );
+        values.push_back(10);
+        REQUIRE( allocations == 2 );
+        REQUIRE( (copy.size() == 10 && values.size() == 11 && values[10] == 10) );
+    }
+    SECTION( "growth keeps the elements" ) {
+        omega::cow_vector<int> values;
+        for (int i = 0; i < 100; ++i)
+        {
+            values.emplace_back(i);
+        }
+        REQUIRE( values.size() == 100 );
+        REQUIRE( values.capacity() >= 100 );
+        REQUIRE( (values.front() == 0 && values.back() == 99) );
+    }
+    SECTION( "conversion from omega::vector" ) {
+        const omega::vector<int> source{ 1, 2, 3 };
+        const omega::cow_vector<int> values(source);
+        REQUIRE( contents(values) == (std::vector<int>{ 1, 2, 3 }) );
+    }
+}
+
+TEST_CASE( "cow_vector allocators", "[cow_vector]" ) {
+    SECTION( "copies with unequal allocators do not share" ) {
+        const omega::cow_vector<int, not_equal_allocator<int>> values{ 1, 2, 3 };
+        const auto copy = values;
+        REQUIRE( copy.data() != values.data() );
+        REQUIRE( contents(copy) == contents(values) );
+    }
+    SECTION( "copy assignment propagates the allocator" ) {
+        const omega::cow_vector<int, propagate_not_equal_allocator<int>> values{ 1, 2, 3 };
+        omega::cow_vector<int, propagate_not_equal_allocator<int>> copy{ 4 };
+        copy = values;
+        REQUIRE( contents(copy) == (std::vector<int>{ 1, 2, 3 }) );
+    }
+    SECTION( "move assignment between unequal allocators copies" ) {
+        omega::cow_vector<int, not_equal_allocator<int>> values{ 1, 2, 3 };
+        omega::cow_vector<int, not_equal_allocator<int>> other;
+        other = std::move(values);
+        REQUIRE( contents(other) == (std::vector<int>{ 1, 2, 3 }) );
+    }
+}
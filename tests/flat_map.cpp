@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include <list>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../flat_map.hpp"
+
+template class omega::flat_map<int, std::string>;
+
+namespace
+{
+    template<typename Map>
+    std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> entries(const Map& map)
+    {
+        std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> result;
+        for (auto item : map)
+        {
+            result.emplace_back(item.first, item.second);
+        }
+        return result;
+    }
+
+    using entry = std::pair<int, std::string>;
+}
+
+TEST_CASE( "flat_map single element operations", "[flat_map]" ) {
+    omega::flat_map<int, std::string> map { { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "z" } };
+
+    SECTION( "initializer_list sorts and keeps the first duplicate" ) {
+        REQUIRE( entries(map) == (std::vector<entry>{ { 1, "a" }, { 2, "b" }, { 3, "c" } }) );
+    }
+    SECTION( "keys and values are separate vectors" ) {
+        REQUIRE( (map.keys().size() == 3 && map.keys()[2] == 3) );
+        REQUIRE( map.values()[1] == "b" );
+    }
+    SECTION( "insert and try_emplace" ) {
+        REQUIRE( map.insert(std::make_pair(0, std::string("zero"))).second );
+        REQUIRE_FALSE( map.try_emplace(2, "other").second );
+        REQUIRE( (*map.try_emplace(4, 2, 'd').first).second == "dd" );
+        REQUIRE( map.size() == 5 );
+        REQUIRE( map.find(2)->second == "b" );
+    }
+    SECTION( "operator [] and at" ) {
+        map[2] = "bb";
+        map[7] = "g";
+        REQUIRE( (map.at(2) == "bb" && map.at(7) == "g" && map.size() == 4) );
+        REQUIRE_THROWS_AS( map.at(5), std::out_of_range );
+        const auto& cmap = map;
+        REQUIRE( cmap.at(1) == "a" );
+    }
+    SECTION( "lookups" ) {
+        REQUIRE( map.contains(2) );
+        REQUIRE( map.count(4) == 0 );
+        REQUIRE( map.find(4) == map.end() );
+        REQUIRE( map.lower_bound(2)->first == 2 );
+        REQUIRE( map.upper_bound(2)->first == 3 );
+    }
+    SECTION( "erase" ) {
+        REQUIRE( map.erase(2) == 1 );
+        REQUIRE( map.erase(2) == 0 );
+        REQUIRE( map.erase(map.begin())->first == 3 );
+        REQUIRE( entries(map) == (std::vector<entry>{ { 3, "c" } }) );
+    }
+    SECTION( "values are mutable through iterators" ) {
+        for (auto item : map)
+        {
+            item.second += "!";
+        }
+        REQUIRE( map.at(3) == "c!" );
+    }
+}
+
+TEST_CASE( "flat_map bulk insert", "[flat_map]" ) {
+    omega::flat_map<int, std::string> map { { 10, "ten" }, { 30, "thirty" } };
+
+    SECTION( "merges a range into existing entries" ) {
+        std::vector<entry> more { { 20, "twenty" }, { 5, "five" }, { 30, "other" }, { 5, "again" } };
+        map.insert(more.begin(), more.end());
+        REQUIRE( entries(map) == (std::vector<entry>{ { 5, "five" }, { 10, "ten" }, { 20, "twenty" }, { 30, "thirty" } }) );
+    }
+    SECTION( "input iterators" ) {
+        std::list<entry> more { { 40, "forty" } };
+        map.insert(more.begin(), more.end());
+        REQUIRE( map.rbegin()->second == "forty" );
+    }
+    SECTION( "matches std::map on random data" ) {
+        std::mt19937 generator{ 5 };
+        std::map<int, std::string> expected(map.begin(), map.end());
+        for (int round = 0; round < 5; ++round)
+        {
+            std::vector<entry> values;
+            for (int i = 0; i < 5000; ++i)
+            {
+                const auto key = static_cast<int>(generator() % 20000);
+                values.emplace_back(key, std::to_string(round));
+            }
+            map.insert(values.begin(), values.end());
+            expected.insert(values.begin(), values.end());
+        }
+        REQUIRE( entries(map) == std::vector<entry>(expected.begin(), expected.end()) );
+    }
+}
+
+TEST_CASE( "flat_map extract and replace", "[flat_map]" ) {
+    omega::flat_map<int, std::string> map { { 2, "b" }, { 1, "a" } };
+
+    auto parts = std::move(map).extract();
+    REQUIRE( map.empty() );
+    REQUIRE( (parts.keys.size() == 2 && parts.keys[0] == 1 && parts.values[0] == "a") );
+
+    parts.keys.push_back(3);
+    REQUIRE_THROWS_AS( map.replace(std::move(parts.keys), omega::vector<std::string>{}), std::invalid_argument );
+
+    omega::flat_map<int, std::string> adopted(omega::vector<int>{ 9, 8 }, omega::vector<std::string>{ "nine", "eight" });
+    REQUIRE( entries(adopted) == (std::vector<entry>{ { 8, "eight" }, { 9, "nine" } }) );
+}
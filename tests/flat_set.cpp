@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include <functional>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../flat_set.hpp"
+
+template class omega::flat_set<int>;
+template class omega::flat_set<std::string>;
+
+TEST_CASE( "flat_set single element operations", "[flat_set]" ) {
+    omega::flat_set<int> set { 5, 1, 3, 1 };
+
+    SECTION( "initializer_list sorts and removes duplicates" ) {
+        REQUIRE( std::vector<int>(set.begin(), set.end()) == (std::vector<int>{ 1, 3, 5 }) );
+    }
+    SECTION( "insert" ) {
+        REQUIRE( set.insert(4).second );
+        REQUIRE_FALSE( set.insert(3).second );
+        REQUIRE( *set.insert(0).first == 0 );
+        REQUIRE( std::vector<int>(set.begin(), set.end()) == (std::vector<int>{ 0, 1, 3, 4, 5 }) );
+    }
+    SECTION( "lookups" ) {
+        REQUIRE( set.contains(3) );
+        REQUIRE( set.count(2) == 0 );
+        REQUIRE( set.find(2) == set.end() );
+        REQUIRE( *set.lower_bound(2) == 3 );
+        REQUIRE( *set.upper_bound(3) == 5 );
+        REQUIRE( set.equal_range(3).second - set.equal_range(3).first == 1 );
+    }
+    SECTION( "erase" ) {
+        REQUIRE( set.erase(3) == 1 );
+        REQUIRE( set.erase(3) == 0 );
+        REQUIRE( *set.erase(set.begin()) == 5 );
+        REQUIRE( set.size() == 1 );
+    }
+    SECTION( "custom comparator" ) {
+        omega::flat_set<int, std::greater<int>> reversed { 1, 3, 2 };
+        REQUIRE( std::vector<int>(reversed.begin(), reversed.end()) == (std::vector<int>{ 3, 2, 1 }) );
+    }
+}
+
+TEST_CASE( "flat_set bulk insert", "[flat_set]" ) {
+    omega::flat_set<int> set { 10, 20, 30 };
+
+    SECTION( "merges a range into existing keys" ) {
+        std::vector<int> more { 25, 5, 20, 35, 5 };
+        set.insert(more.begin(), more.end());
+        REQUIRE( std::vector<int>(set.begin(), set.end()) == (std::vector<int>{ 5, 10, 20, 25, 30, 35 }) );
+    }
+    SECTION( "input iterators" ) {
+        std::list<int> more { 1, 40 };
+        set.insert(more.begin(), more.end());
+        REQUIRE( std::vector<int>(set.begin(), set.end()) == (std::vector<int>{ 1, 10, 20, 30, 40 }) );
+    }
+    SECTION( "matches std::set on random data" ) {
+        std::mt19937 generator{ 3 };
+        std::set<int> expected(set.begin(), set.end());
+        for (int round = 0; round < 5; ++round)
+        {
+            std::vector<int> values;
+            for (int i = 0; i < 20000; ++i)
+            {
+                values.push_back(static_cast<int>(generator() % 50000));
+            }
+            set.insert(values.begin(), values.end());
+            expected.insert(values.begin(), values.end());
+        }
+        REQUIRE( std::vector<int>(set.begin(), set.end()) == std::vector<int>(expected.begin(), expected.end()) );
+    }
+}
+
+TEST_CASE( "flat_set extract and replace", "[flat_set]" ) {
+    omega::flat_set<std::string> set { "b", "a" };
+
+    auto keys = std::move(set).extract();
+    REQUIRE( set.empty() );
+    REQUIRE( (keys.size() == 2 && keys[0] == "a" && keys[1] == "b") );
+
+    keys.push_back("c");
+    set.replace(std::move(keys));
+    REQUIRE( set.size() == 3 );
+    REQUIRE( set.contains("c") );
+
+    omega::flat_set<std::string> adopted(omega::vector<std::string>{ "z", "x", "z" });
+    REQUIRE( std::vector<std::string>(adopted.begin(), adopted.end()) == (std::vector<std::string>{ "x", "z" }) );
+}
@@ -0,0 +1,52 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include "../hugepage_allocator.hpp"
+#include "../vector.hpp"
+
+template class omega::vector<uint64_t, omega::hugepage_allocator<uint64_t>>;
+template class omega::vector<std::string, omega::hugepage_allocator<std::string, 4096>>;
+
+TEST_CASE( "hugepage_allocator", "[hugepage_allocator]" ) {
+    SECTION( "small blocks come from operator new" ) {
+        omega::hugepage_allocator<int> alloc;
+        REQUIRE_FALSE( alloc.mapped(1000 * sizeof(int)) );
+        const auto p = alloc.allocate(1000);
+        p[999] = 7;
+        alloc.deallocate(p, 1000);
+    }
+    SECTION( "large blocks start on a huge page" ) {
+        omega::hugepage_allocator<uint64_t> alloc;
+        const size_t count = (size_t{ 3 } << 20) + 5;
+        const auto p = alloc.allocate(count);
+#if defined(__linux__)
+        REQUIRE( alloc.mapped(count * sizeof(uint64_t)) );
+        REQUIRE( reinterpret_cast<uintptr_t>(p) % omega::hugepage_allocator<uint64_t>::HUGE_PAGE == 0 );
+#endif
+        p[0] = 1;
+        p[count - 1] = 2;
+        REQUIRE( p[count - 1] == 2 );
+        alloc.deallocate(p, count);
+    }
+    SECTION( "vector growth crosses the threshold" ) {
+        omega::vector<uint64_t, omega::hugepage_allocator<uint64_t>> values;
+        for (uint64_t i = 0; i < (1u << 20); ++i)
+        {
+            values.push_back(i * 3);
+        }
+        REQUIRE( (values.size() == (1u << 20) && values[12345] == 12345 * 3) );
+        values.shrink_to_fit();
+        values.resize(10);
+        values.shrink_to_fit();
+        REQUIRE( (values.size() == 10 && values[9] == 27) );
+    }
+    SECTION( "class types with a low threshold" ) {
+        omega::vector<std::string, omega::hugepage_allocator<std::string, 4096>> words;
+        for (int i = 0; i < 1000; ++i)
+        {
+            words.push_back(std::to_string(i));
+        }
+        auto copy = words;
+        REQUIRE( (copy == words && copy[999] == "999") );
+    }
+}
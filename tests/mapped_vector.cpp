@@ -0,0 +1,93 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include "../mapped_vector.hpp"
+
+namespace
+{
+    struct record
+    {
+        uint64_t key;
+        double value;
+    };
+
+    std::string temp_path(const char* name)
+    {
+        return "/tmp/omega_" + std::string{ name } + "_" + std::to_string(getpid());
+    }
+}
+
+template class omega::mapped_vector<record>;
+
+TEST_CASE( "mapped_vector", "[mapped_vector]" ) {
+    const auto path = temp_path("mapped_vector");
+    std::remove(path.c_str());
+
+    SECTION( "contents survive reopening" ) {
+        {
+            omega::mapped_vector<record> records(path);
+            REQUIRE( (records.empty() && records.capacity() == 0) );
+            for (uint64_t i = 0; i < 100000; ++i)
+            {
+                records.push_back(record{ i, i * 0.25 });
+            }
+            // the argument refers into the mapping that grows
+            while (records.size() != records.capacity())
+            {
+                records.push_back(records[3]);
+            }
+            records.push_back(records[5]);
+            records.flush();
+        }
+
+        omega::mapped_vector<record> records(path);
+        REQUIRE( (records.size() > 100000 && records.back().key == 5 && records[99999].value == 99999 * 0.25) );
+        records.resize(10);
+        records.shrink_to_fit();
+        REQUIRE( records.capacity() == 10 );
+        records.emplace_back(record{ 77, 1.5 });
+        REQUIRE( (records.size() == 11 && records.at(10).key == 77) );
+        REQUIRE_THROWS_AS( records.at(11), std::out_of_range );
+    }
+    SECTION( "read-only mode" ) {
+        {
+            omega::mapped_vector<record> records(path);
+            records.resize(1000, record{ 1, 2.0 });
+        }
+
+        const omega::mapped_vector<record> records(path, omega::mapped_mode::read_only);
+        REQUIRE( (records.size() == 1000 && records[999].value == 2.0) );
+        double sum = 0;
+        for (const auto& item : records)
+        {
+            sum += item.value;
+        }
+        REQUIRE( sum == 2000.0 );
+
+        omega::mapped_vector<record> read_only(path, omega::mapped_mode::read_only);
+        REQUIRE_THROWS_AS( read_only.push_back(record{ 2, 3.0 }), std::system_error );
+        REQUIRE_THROWS_AS( read_only.clear(), std::system_error );
+        REQUIRE( read_only.size() == 1000 );
+    }
+    SECTION( "bad files are rejected" ) {
+        REQUIRE_THROWS_AS( omega::mapped_vector<record>(path, omega::mapped_mode::read_only), std::system_error );
+        {
+            omega::mapped_vector<record> records(path);
+            records.push_back(record{ 1, 1.0 });
+        }
+        REQUIRE_THROWS_AS( omega::mapped_vector<uint32_t>(path), std::system_error );
+    }
+    SECTION( "move" ) {
+        omega::mapped_vector<record> records(path);
+        records.push_back(record{ 4, 4.0 });
+        auto moved = std::move(records);
+        REQUIRE( (moved.size() == 1 && records.size() == 0) );
+        records = std::move(moved);
+        REQUIRE( records[0].key == 4 );
+    }
+
+    std::remove(path.c_str());
+}
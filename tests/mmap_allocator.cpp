@@ -0,0 +1,80 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include "../mmap_allocator.hpp"
+#include "../vector.hpp"
+
+namespace
+{
+    struct record
+    {
+        uint64_t key;
+        double weight;
+        char tag[16];
+    };
+}
+
+template class omega::vector<uint64_t, omega::mmap_allocator<uint64_t>>;
+template class omega::vector<std::string, omega::mmap_allocator<std::string, 4096>>;
+
+static_assert(omega::allocator_reallocate<omega::mmap_allocator<record>>::value, "records are remapped");
+static_assert(!omega::allocator_reallocate<omega::mmap_allocator<std::string>>::value, "strings are moved");
+static_assert(!omega::allocator_reallocate<std::allocator<int>>::value, "std::allocator has no hook");
+
+TEST_CASE( "mmap_allocator", "[mmap_allocator]" ) {
+    SECTION( "reallocate keeps the contents" ) {
+        omega::mmap_allocator<uint64_t> alloc;
+        const size_t count = 1 << 16;
+        auto p = alloc.allocate(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            p[i] = i;
+        }
+        REQUIRE( alloc.reallocate(p, count, count - 1) == p );
+        p = alloc.reallocate(p, count, count * 16);
+#if defined(__linux__)
+        REQUIRE( p != nullptr );
+        p[count * 16 - 1] = 1;
+        REQUIRE( (p[0] == 0 && p[count - 1] == count - 1) );
+        alloc.deallocate(p, count * 16);
+#else
+        REQUIRE( p == nullptr );
+#endif
+    }
+    SECTION( "small blocks are not remapped" ) {
+        omega::mmap_allocator<int> alloc;
+        const auto p = alloc.allocate(100);
+        REQUIRE( alloc.reallocate(p, 100, 1 << 20) == nullptr );
+        alloc.deallocate(p, 100);
+    }
+    SECTION( "vector growth" ) {
+        omega::vector<record, omega::mmap_allocator<record>> records;
+        for (uint64_t i = 0; i < 100000; ++i)
+        {
+            records.push_back(record{ i, i * 0.5, "r" });
+        }
+        // the argument refers into the buffer that is remapped
+        while (records.size() != records.capacity())
+        {
+            records.push_back(records[1]);
+        }
+        records.push_back(records[2]);
+        REQUIRE( (records.back().key == 2 && records[99999].key == 99999) );
+
+        records.reserve(records.capacity() * 3);
+        REQUIRE( records[12345].weight == 12345 * 0.5 );
+        records.resize(records.capacity() + 10, records[7]);
+        REQUIRE( (records.back().key == 7 && records[8].key == 8) );
+        records.shrink_to_fit();
+        REQUIRE( records.capacity() == records.size() );
+    }
+    SECTION( "class types grow by moving" ) {
+        omega::vector<std::string, omega::mmap_allocator<std::string, 4096>> words;
+        for (int i = 0; i < 5000; ++i)
+        {
+            words.push_back(std::to_string(i));
+        }
+        words.push_back(words[0]);
+        REQUIRE( (words[4999] == "4999" && words.back() == "0") );
+    }
+}
@@ -0,0 +1,148 @@
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+// Pointer that stores the distance from its own address to the target, so
+// a structure built from them stays valid wherever its memory is mapped.
+// An offset of 1 means null.
+template <class T>
+class offset_ptr
+{
+public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = offset_ptr;
+    using reference = typename std::add_lvalue_reference<T>::type;
+    using iterator_category = std::random_access_iterator_tag;
+
+    template <class U> using rebind = offset_ptr<U>;
+
+    offset_ptr() noexcept {}
+    offset_ptr(std::nullptr_t) noexcept {}
+    offset_ptr(T* p) noexcept { set(p); }
+    offset_ptr(const offset_ptr& rhs) noexcept { set(rhs.get()); }
+
+    template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    offset_ptr(const offset_ptr<U>& rhs) noexcept { set(rhs.get()); }
+
+    offset_ptr& operator=(const offset_ptr& rhs) noexcept
+    {
+        set(rhs.get());
+        return *this;
+    }
+
+    static offset_ptr pointer_to(reference r) noexcept { return offset_ptr(std::addressof(r)); }
+
+    T* get() const noexcept
+    {
+        return m_offset == 1 ? nullptr
+                             : reinterpret_cast<T*>(reinterpret_cast<std::intptr_t>(this) + m_offset);
+    }
+
+    T* operator->() const noexcept { return get(); }
+    reference operator*() const noexcept { return *get(); }
+    reference operator[](difference_type n) const noexcept { return get()[n]; }
+    explicit operator bool() const noexcept { return m_offset != 1; }
+
+    offset_ptr& operator++() noexcept { set(get() + 1); return *this; }
+    offset_ptr& operator--() noexcept { set(get() - 1); return *this; }
+    offset_ptr operator++(int) noexcept { offset_ptr old(*this); ++*this; return old; }
+    offset_ptr operator--(int) noexcept { offset_ptr old(*this); --*this; return old; }
+    offset_ptr& operator+=(difference_type n) noexcept { set(get() + n); return *this; }
+    offset_ptr& operator-=(difference_type n) noexcept { set(get() - n); return *this; }
+
+    friend offset_ptr operator+(const offset_ptr& p, difference_type n) noexcept { return offset_ptr(p.get() + n); }
+    friend offset_ptr operator+(difference_type n, const offset_ptr& p) noexcept { return offset_ptr(p.get() + n); }
+    friend offset_ptr operator-(const offset_ptr& p, difference_type n) noexcept { return offset_ptr(p.get() - n); }
+    friend difference_type operator-(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() - b.get(); }
+
+    friend bool operator==(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() == b.get(); }
+    friend bool operator!=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() != b.get(); }
+    friend bool operator<(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() < b.get(); }
+    friend bool operator<=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() <= b.get(); }
+    friend bool operator>(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() > b.get(); }
+    friend bool operator>=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() >= b.get(); }
+    friend bool operator==(const offset_ptr& a, std::nullptr_t) noexcept { return !a; }
+    friend bool operator!=(const offset_ptr& a, std::nullptr_t) noexcept { return static_cast<bool>(a); }
+
+private:
+    void set(const volatile void* p) noexcept
+    {
+        m_offset = p ? reinterpret_cast<std::intptr_t>(p) - reinterpret_cast<std::intptr_t>(this) : 1;
+    }
+
+    std::intptr_t m_offset = 1;
+};
+
+// Bump allocator over a memory block that starts with an offset_arena, for
+// containers that live inside the same block. deallocate frees nothing.
+struct offset_arena
+{
+    std::size_t used;
+    std::size_t capacity;
+
+    static offset_arena* create(void* block, std::size_t bytes) noexcept
+    {
+        return new (block) offset_arena{ sizeof(offset_arena), bytes };
+    }
+
+    void* allocate(std::size_t bytes, std::size_t align)
+    {
+        const auto first = (used + align - 1) & ~(align - 1);
+        if (first + bytes > capacity)
+        {
+            throw std::bad_alloc{};
+        }
+        used = first + bytes;
+        return reinterpret_cast<char*>(this) + first;
+    }
+};
+
+template <class T>
+class offset_allocator
+{
+public:
+    using value_type = T;
+    using pointer = offset_ptr<T>;
+
+    template <class U> friend class offset_allocator;
+
+    explicit offset_allocator(offset_arena* arena) noexcept : m_arena(arena) {}
+    offset_allocator(const offset_allocator& rhs) noexcept : m_arena(rhs.m_arena.get()) {}
+    template <class U> offset_allocator(const offset_allocator<U>& rhs) noexcept : m_arena(rhs.m_arena.get()) {}
+
+    offset_allocator& operator=(const offset_allocator& rhs) noexcept
+    {
+        m_arena = rhs.m_arena;
+        return *this;
+    }
+
+    pointer allocate(std::size_t n)
+    {
+        return pointer(static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))));
+    }
+
+    void deallocate(pointer, std::size_t) noexcept {}
+
+    offset_arena* arena() const noexcept { return m_arena.get(); }
+
+private:
+    offset_ptr<offset_arena> m_arena;
+};
+
+template <class T, class U>
+bool
+operator==(offset_allocator<T> const& x, offset_allocator<U> const& y) noexcept
+{
+    return x.arena() == y.arena();
+}
+
+template <class T, class U>
+bool
+operator!=(offset_allocator<T> const& x, offset_allocator<U> const& y) noexcept
+{
+    return !(x == y);
+}
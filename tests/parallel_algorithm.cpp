@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../parallel_algorithm.hpp"
+
+namespace
+{
+    omega::vector<int> shuffled(int count)
+    {
+        omega::vector<int> values;
+        values.reserve(count);
+        unsigned state = 12345;
+        for (int i = 0; i < count; ++i)
+        {
+            state = state * 1103515245 + 12345;
+            values.push_back(static_cast<int>(state >> 8) % 1000);
+        }
+        return values;
+    }
+}
+
+TEST_CASE( "thread_pool runs every index once", "[parallel_algorithm]" ) {
+    omega::thread_pool pool{ 4 };
+    REQUIRE( pool.size() == 4 );
+
+    SECTION( "flat" ) {
+        std::vector<std::atomic<int>> hits(1000);
+        pool.run(hits.size(), [&hits](size_t k) { ++hits[k]; });
+        REQUIRE( std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }) );
+    }
+    SECTION( "nested" ) {
+        std::atomic<int> total{ 0 };
+        pool.run(16, [&pool, &total](size_t) {
+            pool.run(16, [&total](size_t) { ++total; });
+        });
+        REQUIRE( total == 256 );
+    }
+    SECTION( "exceptions reach the caller" ) {
+        std::atomic<int> finished{ 0 };
+        REQUIRE_THROWS_AS( pool.run(50, [&finished](size_t k) {
+            if (k == 17)
+            {
+                throw std::runtime_error("task failed");
+            }
+            ++finished;
+        }), std::runtime_error );
+        REQUIRE( finished == 49 );
+    }
+    SECTION( "a pool of one runs on the caller" ) {
+        omega::thread_pool single{ 1 };
+        int sum = 0;
+        single.run(10, [&sum](size_t k) { sum += static_cast<int>(k); });
+        REQUIRE( sum == 45 );
+    }
+}
+
+TEST_CASE( "parallel algorithms match the serial ones", "[parallel_algorithm]" ) {
+    omega::thread_pool pool{ 4 };
+
+    for (const int count : { 0, 1, 1000, 100003 })
+    {
+        const auto input = shuffled(count);
+        const std::vector<int> reference(input.begin(), input.end());
+
+        auto sorted = input;
+        omega::par::sort(pool, sorted.begin(), sorted.end(), std::less<int>{});
+        auto expected = reference;
+        std::sort(expected.begin(), expected.end());
+        REQUIRE( std::equal(sorted.begin(), sorted.end(), expected.begin()) );
+
+        auto descending = input;
+        omega::par::sort(descending.begin(), descending.end(), std::greater<int>{});
+        REQUIRE( std::is_sorted(descending.begin(), descending.end(), std::greater<int>{}) );
+
+        omega::vector<long long> squares;
+        squares.resize(count);
+        const auto squares_end = omega::par::transform(pool, input.begin(), input.end(), squares.begin()
+                                                       , [](int v) { return static_cast<long long>(v) * v; });
+        REQUIRE( squares_end == squares.end() );
+        bool squared = true;
+        for (int i = 0; i < count; ++i)
+        {
+            squared = squared && squares[i] == static_cast<long long>(reference[i]) * reference[i];
+        }
+        REQUIRE( squared );
+
+        REQUIRE( omega::par::reduce(pool, input.begin(), input.end(), 0LL, std::plus<long long>{})
+                 == std::accumulate(reference.begin(), reference.end(), 0LL) );
+
+        omega::vector<int> inclusive;
+        inclusive.resize(count);
+        omega::par::inclusive_scan(pool, input.begin(), input.end(), inclusive.begin(), std::plus<int>{});
+        std::vector<int> partial(reference.size());
+        std::partial_sum(reference.begin(), reference.end(), partial.begin());
+        REQUIRE( std::equal(inclusive.begin(), inclusive.end(), partial.begin()) );
+
+        auto in_place = input;
+        omega::par::exclusive_scan(pool, in_place.begin(), in_place.end(), in_place.begin(), 7, std::plus<int>{});
+        bool shifted = true;
+        for (int i = 0; i < count; ++i)
+        {
+            shifted = shifted && in_place[i] == 7 + (i ? partial[i - 1] : 0);
+        }
+        REQUIRE( shifted );
+    }
+}
+
+TEST_CASE( "parallel algorithms on the shared pool", "[parallel_algorithm]" ) {
+    auto values = shuffled(50000);
+
+    SECTION( "for_each and binary transform" ) {
+        omega::par::for_each(values.begin(), values.end(), [](int& v) { v += 1; });
+        REQUIRE( std::all_of(values.begin(), values.end(), [](int v) { return v >= 1 && v <= 1000; }) );
+        omega::vector<int> sums;
+        sums.resize(values.size());
+        omega::par::transform(values.begin(), values.end(), values.begin(), sums.begin(), std::plus<int>{});
+        REQUIRE( (sums[0] == 2 * values[0] && sums[49999] == 2 * values[49999]) );
+    }
+    SECTION( "non-commutative reduce keeps the order" ) {
+        omega::vector<std::string> words;
+        for (int i = 0; i < 20000; ++i)
+        {
+            words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+        }
+        const auto joined = omega::par::reduce(words.begin(), words.end(), std::string{});
+        REQUIRE( (joined.size() == 20000 && joined.substr(0, 3) == "abc" && joined.substr(26, 2) == "ab") );
+    }
+    SECTION( "sort and scans with defaults" ) {
+        omega::par::sort(values.begin(), values.end());
+        REQUIRE( std::is_sorted(values.begin(), values.end()) );
+        omega::vector<int> out;
+        out.resize(values.size());
+        omega::par::inclusive_scan(values.begin(), values.end(), out.begin());
+        omega::par::exclusive_scan(values.begin(), values.end(), out.begin(), 0);
+        REQUIRE( (out[0] == 0 && out[1] == values[0]) );
+    }
+    SECTION( "callback exceptions propagate" ) {
+        REQUIRE_THROWS_AS( omega::par::for_each(values.begin(), values.end(), [](int v) {
+            if (v == 500)
+            {
+                throw std::runtime_error("bad value");
+            }
+        }), std::runtime_error );
+    }
+}
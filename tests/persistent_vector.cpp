@@ -0,0 +1,203 @@
+#include "catch.hpp"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../persistent_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::persistent_vector<int>;
+template class omega::persistent_vector<std::string>;
+
+namespace
+{
+    template<typename Vector>
+    std::vector<typename Vector::value_type> contents(const Vector& values)
+    {
+        return std::vector<typename Vector::value_type>(values.begin(), values.end());
+    }
+
+    std::vector<int> iota(int first, int last)
+    {
+        std::vector<int> result;
+        for (int i = first; i < last; ++i)
+        {
+            result.push_back(i);
+        }
+        return result;
+    }
+
+    omega::persistent_vector<int> make(int first, int last)
+    {
+        const auto values = iota(first, last);
+        return omega::persistent_vector<int>(values.begin(), values.end());
+    }
+}
+
+TEST_CASE( "persistent_vector versions", "[persistent_vector]" ) {
+    SECTION( "push_back and set leave the old version alone" ) {
+        omega::persistent_vector<std::string> empty;
+        const auto one = empty.push_back("a");
+        const auto two = one.push_back("b");
+        const auto changed = two.set(0, "c");
+        REQUIRE( empty.empty() );
+        REQUIRE( contents(one) == (std::vector<std::string>{ "a" }) );
+        REQUIRE( contents(two) == (std::vector<std::string>{ "a", "b" }) );
+        REQUIRE( contents(changed) == (std::vector<std::string>{ "c", "b" }) );
+        REQUIRE_THROWS_AS( two.at(2), std::out_of_range );
+        REQUIRE_THROWS_AS( two.set(2, "d"), std::out_of_range );
+    }
+    SECTION( "push_back grows the tree a level at a time" ) {
+        omega::persistent_vector<int> values;
+        std::vector<omega::persistent_vector<int>> versions;
+        for (int i = 0; i < 40000; ++i)
+        {
+            values = values.push_back(i);
+            if (i % 10000 == 0)
+            {
+                versions.push_back(values);
+            }
+        }
+        REQUIRE( values.size() == 40000 );
+        REQUIRE( values.depth() == 3 );
+        REQUIRE( contents(values) == iota(0, 40000) );
+        REQUIRE( versions[2].size() == 20001 );
+        REQUIRE( versions[2].back() == 20000 );
+    }
+    SECTION( "pop_back and slice" ) {
+        const auto values = make(0, 5000);
+        REQUIRE( contents(values.pop_back()) == iota(0, 4999) );
+        REQUIRE( contents(values.slice(1000, 3333)) == iota(1000, 3333) );
+        REQUIRE( values.slice(7, 7).empty() );
+        REQUIRE( values.slice(90, 120).depth() == 1 );
+        REQUIRE( values.slice(40, 50).depth() == 0 );
+        REQUIRE_THROWS_AS( values.slice(10, 5001), std::out_of_range );
+        REQUIRE( values.size() == 5000 );
+    }
+    SECTION( "concat" ) {
+        const auto left = make(0, 1000);
+        const auto right = make(1000, 1100);
+        REQUIRE( contents(left.concat(right)) == iota(0, 1100) );
+        REQUIRE( contents(right.concat(left).slice(100, 1100)) == iota(0, 1000) );
+        REQUIRE( contents(make(0, 3).concat(make(3, 10))) == iota(0, 10) );
+        REQUIRE( left.concat(omega::persistent_vector<int>{}).size() == 1000 );
+    }
+    SECTION( "repeated concat of small pieces keeps the tree shallow" ) {
+        omega::persistent_vector<int> values;
+        for (int i = 0; i < 3000; i += 3)
+        {
+            values = values.concat(make(i, i + 3));
+        }
+        REQUIRE( contents(values) == iota(0, 3000) );
+        REQUIRE( values.depth() <= 3 );
+    }
+    SECTION( "conversion to and from omega::vector" ) {
+        omega::vector<int> source;
+        for (int i = 0; i < 2000; ++i)
+        {
+            source.push_back(i);
+        }
+        const omega::persistent_vector<int> values(source);
+        const auto back = values.to_vector();
+        REQUIRE( std::vector<int>(back.begin(), back.end()) == iota(0, 2000) );
+        REQUIRE( values.depth() == 2 );
+        const auto chunk = values.chunk_at(100);
+        REQUIRE( (chunk.first.size() == 32 && chunk.second == 96 && chunk.first[4] == 100) );
+    }
+    SECTION( "iterators" ) {
+        const auto values = make(0, 100).slice(3, 100);
+        auto it = values.end();
+        it -= 10;
+        REQUIRE( *it == 90 );
+        REQUIRE( it[-50] == 40 );
+        REQUIRE( values.end() - values.begin() == 97 );
+        REQUIRE( *values.rbegin() == 99 );
+    }
+}
+
+TEST_CASE( "persistent_vector transients", "[persistent_vector]" ) {
+    const auto base = make(0, 100);
+
+    SECTION( "batch updates do not touch the source or earlier snapshots" ) {
+        auto builder = base.transient();
+        for (int i = 100; i < 2000; ++i)
+        {
+            builder.push_back(i);
+        }
+        const auto first = builder.persistent();
+        builder.set(0, -1);
+        builder.pop_back();
+        const auto second = builder.persistent();
+
+        REQUIRE( contents(base) == iota(0, 100) );
+        REQUIRE( contents(first) == iota(0, 2000) );
+        REQUIRE( second.size() == 1999 );
+        REQUIRE( (second[0] == -1 && second[1] == 1 && second.back() == 1998) );
+        REQUIRE_THROWS_AS( builder.set(1999, 0), std::out_of_range );
+    }
+    SECTION( "custom allocator" ) {
+        omega::persistent_vector<int, allocator<int>> values;
+        auto builder = values.transient();
+        for (int i = 0; i < 100; ++i)
+        {
+            builder.push_back(i);
+        }
+        values = builder.persistent();
+        REQUIRE( values.to_vector().size() == 100 );
+        REQUIRE( values.concat(values).slice(50, 150)[60] == 10 );
+    }
+}
+
+TEST_CASE( "persistent_vector random operations", "[persistent_vector]" ) {
+    std::mt19937 random{ 42 };
+    omega::persistent_vector<int> values;
+    std::vector<int> expected;
+    int next = 0;
+
+    for (int step = 0; step < 400; ++step)
+    {
+        const auto action = random() % 5;
+        if (action == 0 || expected.empty())
+        {
+            const auto count = static_cast<int>(random() % 300);
+            values = values.concat(make(next, next + count));
+            const auto added = iota(next, next + count);
+            expected.insert(expected.end(), added.begin(), added.end());
+            next += count;
+        }
+        else if (action == 1)
+        {
+            const auto first = random() % (expected.size() + 1);
+            const auto last = first + random() % (expected.size() - first + 1);
+            values = values.slice(first, last);
+            expected = std::vector<int>(expected.begin() + first, expected.begin() + last);
+        }
+        else if (action == 2)
+        {
+            const auto index = random() % expected.size();
+            values = values.set(index, -step);
+            expected[index] = -step;
+        }
+        else if (action == 3)
+        {
+            auto builder = values.transient();
+            for (int i = 0; i < 50; ++i)
+            {
+                builder.push_back(next);
+                expected.push_back(next++);
+            }
+            values = builder.persistent();
+        }
+        else
+        {
+            values = make(next, next + 40).concat(values);
+            auto added = iota(next, next + 40);
+            expected.insert(expected.begin(), added.begin(), added.end());
+            next += 40;
+        }
+
+        REQUIRE( contents(values) == expected );
+    }
+
+    REQUIRE( values.depth() <= 4 );
+}
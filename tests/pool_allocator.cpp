@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../pool_allocator.hpp"
+#include "../vector.hpp"
+
+namespace
+{
+    struct alignas(64) line
+    {
+        uint64_t values[8];
+    };
+}
+
+template class omega::vector<int, omega::pool_allocator<int>>;
+template class omega::vector<std::string, omega::pool_allocator<std::string>>;
+
+static_assert(std::allocator_traits<omega::pool_allocator<int>>::is_always_equal::value, "stateless");
+
+TEST_CASE( "pool_allocator", "[pool_allocator]" ) {
+    SECTION( "size classes" ) {
+        REQUIRE( omega::size_class_pool::class_of(1, 1) == 0 );
+        REQUIRE( omega::size_class_pool::class_of(16, 8) == 0 );
+        REQUIRE( omega::size_class_pool::class_of(17, 8) == 1 );
+        REQUIRE( omega::size_class_pool::class_of(8, 64) == 2 );
+        REQUIRE( omega::size_class_pool::block_size(omega::size_class_pool::class_of(5000, 8)) == 8192 );
+    }
+    SECTION( "freed blocks are reused for the same class" ) {
+        omega::pool_allocator<uint64_t> alloc;
+        const auto first = alloc.allocate(100);
+        const auto second = alloc.allocate(100);
+        REQUIRE( second != first );
+        alloc.deallocate(first, 100);
+        // 100 and 128 elements share the 1 KB class
+        const auto again = alloc.allocate(128);
+        REQUIRE( again == first );
+        alloc.deallocate(again, 128);
+        alloc.deallocate(second, 100);
+    }
+    SECTION( "alignment" ) {
+        omega::pool_allocator<line> alloc;
+        line* lines[10];
+        for (auto& p : lines)
+        {
+            p = alloc.allocate(1);
+            REQUIRE( reinterpret_cast<uintptr_t>(p) % alignof(line) == 0 );
+        }
+        for (auto p : lines)
+        {
+            alloc.deallocate(p, 1);
+        }
+    }
+    SECTION( "large blocks are mapped" ) {
+        omega::pool_allocator<char, 4096> alloc;
+        REQUIRE( (!alloc.mapped(4096) && alloc.mapped(4097)) );
+        const auto before = alloc.statistics();
+        const auto p = alloc.allocate(1 << 20);
+        p[(1 << 20) - 1] = 1;
+#if defined(__linux__)
+        REQUIRE( alloc.statistics().mapped_bytes == before.mapped_bytes + (1 << 20) );
+#endif
+        alloc.deallocate(p, 1 << 20);
+        REQUIRE( alloc.statistics().mapped_bytes == before.mapped_bytes );
+    }
+    SECTION( "vectors" ) {
+        const auto before = omega::pool_allocator<int>::statistics();
+        {
+            omega::vector<std::string, omega::pool_allocator<std::string>> words;
+            for (int i = 0; i < 10000; ++i)
+            {
+                words.push_back(std::to_string(i));
+            }
+            words.push_back(words[0]);
+
+            omega::vector<std::string, omega::pool_allocator<std::string>> other;
+            other = std::move(words);
+            REQUIRE( (words.empty() && other[9999] == "9999" && other.back() == "0") );
+        }
+        const auto after = omega::pool_allocator<int>::statistics();
+        REQUIRE( (after.block_bytes == before.block_bytes && after.mapped_bytes == before.mapped_bytes) );
+    }
+    SECTION( "threads share the pool" ) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([t] {
+                for (int round = 0; round < 200; ++round)
+                {
+                    omega::vector<int, omega::pool_allocator<int>> values;
+                    for (int i = 0; i < 100 + t; ++i)
+                    {
+                        values.push_back(i);
+                    }
+                    if (values[99] != 99)
+                    {
+                        throw std::logic_error("pool handed out a block twice");
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
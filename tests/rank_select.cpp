@@ -0,0 +1,93 @@
+#include "catch.hpp"
+#include <random>
+#include <stdexcept>
+#include "../rank_select.hpp"
+
+namespace
+{
+    size_t naive_rank(const omega::bit_vector<>& bits, size_t pos)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < pos; ++i)
+        {
+            result += bits[i];
+        }
+        return result;
+    }
+
+    omega::bit_vector<> random_bits(size_t count, unsigned seed)
+    {
+        std::mt19937 generator{ seed };
+        omega::bit_vector<> bits;
+        for (size_t i = 0; i < count; ++i)
+        {
+            bits.push_back(generator() % 3 == 0);
+        }
+        return bits;
+    }
+}
+
+template class omega::rank_select<>;
+
+TEST_CASE( "rank_select on an empty bit vector", "[rank_select]" ) {
+    omega::bit_vector<> bits;
+    omega::rank_select<> index(bits);
+
+    REQUIRE( index.rank1(0) == 0 );
+    REQUIRE( index.count() == 0 );
+    REQUIRE_THROWS_AS( index.select1(0), std::out_of_range );
+}
+
+TEST_CASE( "rank_select matches a naive scan", "[rank_select]" ) {
+    const auto bits = random_bits(140000, 42);
+    omega::rank_select<> index(bits);
+
+    SECTION( "rank" ) {
+        size_t ones = 0;
+        for (size_t i = 0; i <= bits.size(); ++i)
+        {
+            if (index.rank1(i) != ones)
+            {
+                FAIL( "rank1 mismatch at " << i );
+            }
+            if (i < bits.size())
+            {
+                ones += bits[i];
+            }
+        }
+        REQUIRE( index.count() == ones );
+        REQUIRE( index.rank0(bits.size()) == bits.size() - ones );
+    }
+    SECTION( "select is the inverse of rank" ) {
+        size_t ones = 0;
+        size_t zeros = 0;
+        for (size_t i = 0; i < bits.size(); ++i)
+        {
+            if (bits[i] ? index.select1(ones++) != i : index.select0(zeros++) != i)
+            {
+                FAIL( "select mismatch at " << i );
+            }
+        }
+        REQUIRE_THROWS_AS( index.select1(ones), std::out_of_range );
+        REQUIRE_THROWS_AS( index.select0(zeros), std::out_of_range );
+    }
+    SECTION( "overhead is about 3%" ) {
+        REQUIRE( index.size_in_bytes() * 8 < bits.size() * 4 / 100 );
+    }
+}
+
+TEST_CASE( "rank_select update after appends", "[rank_select]" ) {
+    auto bits = random_bits(70000, 7);
+    omega::rank_select<> index(bits);
+
+    for (size_t i = 0; i < 66000; ++i)
+    {
+        bits.push_back(i % 5 == 0);
+    }
+    index.update();
+
+    REQUIRE( index.size() == bits.size() );
+    REQUIRE( index.rank1(bits.size()) == naive_rank(bits, bits.size()) );
+    REQUIRE( index.rank1(100000) == naive_rank(bits, 100000) );
+    REQUIRE( index.select1(index.count() - 1) == bits.size() - 5 );
+}
@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../rcu_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::rcu_vector<int>;
+template class omega::rcu_vector<std::string>;
+
+TEST_CASE( "rcu_vector snapshots", "[rcu_vector]" ) {
+    omega::rcu_vector<std::string> table{ 4 };
+    auto reader = table.make_reader();
+
+    SECTION( "a new table is empty" ) {
+        const auto view = reader.read();
+        REQUIRE( view.empty() );
+        REQUIRE_THROWS_AS( view.at(0), std::out_of_range );
+    }
+    SECTION( "a pinned snapshot outlives later updates" ) {
+        table.assign({ "a", "b" });
+        {
+            const auto view = reader.read();
+            table.update([](omega::vector<std::string>& values) {
+                values.push_back("c");
+                values[0] = "x";
+            });
+            REQUIRE( table.retired_count() == 1 );
+            REQUIRE( std::vector<std::string>(view.begin(), view.end()) == (std::vector<std::string>{ "a", "b" }) );
+        }
+        table.reclaim();
+        REQUIRE( table.retired_count() == 0 );
+
+        const auto view = reader.read();
+        REQUIRE( std::vector<std::string>(view.begin(), view.end()) == (std::vector<std::string>{ "x", "b", "c" }) );
+    }
+    SECTION( "buffers nobody pinned are freed on publish" ) {
+        for (int i = 0; i < 10; ++i)
+        {
+            table.assign({ std::to_string(i) });
+        }
+        REQUIRE( table.retired_count() == 0 );
+        REQUIRE( reader.read()[0] == "9" );
+    }
+    SECTION( "reader slots are limited and reused" ) {
+        std::vector<omega::rcu_vector<std::string>::reader> readers;
+        for (int i = 0; i < 3; ++i)
+        {
+            readers.push_back(table.make_reader());
+        }
+        REQUIRE_THROWS_AS( table.make_reader(), std::length_error );
+        readers.pop_back();
+        REQUIRE_NOTHROW( table.make_reader() );
+    }
+    SECTION( "custom allocator" ) {
+        omega::rcu_vector<int, allocator<int>> numbers{ 1 };
+        numbers.assign({ 1, 2, 3 });
+        REQUIRE( numbers.make_reader().read().size() == 3 );
+    }
+}
+
+TEST_CASE( "rcu_vector readers during updates", "[rcu_vector]" ) {
+    const int readers = 4;
+    const int updates = 2000;
+    omega::rcu_vector<int> table{ readers };
+    table.assign({ 0, 0, 0, 0 });
+    std::atomic<bool> done{ false };
+    std::atomic<int> torn{ 0 };
+
+    // every published buffer holds four copies of its version
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&table, &done, &torn] {
+            auto reader = table.make_reader();
+            while (!done.load())
+            {
+                const auto view = reader.read();
+                for (const auto value : view)
+                {
+                    torn += value != view[0];
+                }
+            }
+        });
+    }
+
+    for (int version = 1; version <= updates; ++version)
+    {
+        table.update([version](omega::vector<int>& values) {
+            for (auto& value : values)
+            {
+                value = version;
+            }
+        });
+    }
+    done = true;
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    table.reclaim();
+    REQUIRE( torn == 0 );
+    REQUIRE( table.retired_count() == 0 );
+    REQUIRE( table.make_reader().read()[3] == updates );
+}
@@ -0,0 +1,178 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../ring_buffer.hpp"
+#include "allocator.hpp"
+
+template class omega::ring_buffer<int>;
+template class omega::ring_buffer<std::string>;
+
+namespace
+{
+    template<typename Ring>
+    std::vector<typename Ring::value_type> contents(const Ring& ring)
+    {
+        return std::vector<typename Ring::value_type>(ring.begin(), ring.end());
+    }
+}
+
+TEST_CASE( "ring_buffer as a FIFO", "[ring_buffer]" ) {
+    omega::ring_buffer<std::string> ring(4);
+
+    SECTION( "capacity is rounded up to a power of two" ) {
+        omega::ring_buffer<int> other(5);
+        REQUIRE( other.capacity() == 8 );
+        REQUIRE( ring.capacity() == 4 );
+    }
+    SECTION( "push_back and pop_front" ) {
+        ring.push_back("a");
+        ring.emplace_back("b");
+        ring.pop_front();
+        REQUIRE( (ring.size() == 1 && ring.front() == "b" && ring.back() == "b") );
+    }
+    SECTION( "indices wrap around the buffer" ) {
+        for (int i = 0; i < 3; ++i)
+        {
+            ring.push_back(std::to_string(i));
+        }
+        ring.pop_front(2);
+        for (int i = 3; i < 6; ++i)
+        {
+            ring.push_back(std::to_string(i));
+        }
+        REQUIRE( ring.capacity() == 4 );
+        REQUIRE( contents(ring) == (std::vector<std::string>{ "2", "3", "4", "5" }) );
+        REQUIRE( (ring[0] == "2" && ring.at(3) == "5") );
+        REQUIRE_THROWS_AS( ring.at(4), std::out_of_range );
+    }
+    SECTION( "growth keeps FIFO order" ) {
+        for (int i = 0; i < 3; ++i)
+        {
+            ring.push_back(std::to_string(i));
+        }
+        ring.pop_front();
+        for (int i = 3; i < 8; ++i)
+        {
+            ring.push_back(std::to_string(i));
+        }
+        REQUIRE( ring.capacity() == 8 );
+        REQUIRE( contents(ring) == (std::vector<std::string>{ "1", "2", "3", "4", "5", "6", "7" }) );
+    }
+    SECTION( "pop_back" ) {
+        ring.push_back("a");
+        ring.push_back("b");
+        ring.pop_back();
+        REQUIRE( (ring.size() == 1 && ring.back() == "a") );
+    }
+}
+
+TEST_CASE( "ring_buffer fixed capacity", "[ring_buffer]" ) {
+    omega::ring_buffer<int> ring(2, omega::ring_growth::fixed);
+    ring.push_back(1);
+    ring.push_back(2);
+
+    REQUIRE( ring.full() );
+    REQUIRE_THROWS_AS( ring.push_back(3), std::length_error );
+    const std::vector<int> more { 3 };
+    REQUIRE_THROWS_AS( ring.push_back(more.begin(), more.end()), std::length_error );
+    REQUIRE( contents(ring) == (std::vector<int>{ 1, 2 }) );
+
+    ring.pop_front();
+    ring.push_back(3);
+    REQUIRE( contents(ring) == (std::vector<int>{ 2, 3 }) );
+}
+
+TEST_CASE( "ring_buffer bulk operations", "[ring_buffer]" ) {
+    omega::ring_buffer<int> ring(8);
+    const std::vector<int> values { 1, 2, 3, 4, 5, 6 };
+    ring.push_back(values.begin(), values.end());
+    ring.pop_front(4);
+    ring.push_back(values.begin(), values.end());
+
+    SECTION( "range wraps around the end" ) {
+        REQUIRE( ring.capacity() == 8 );
+        REQUIRE( contents(ring) == (std::vector<int>{ 5, 6, 1, 2, 3, 4, 5, 6 }) );
+    }
+    SECTION( "as_spans splits at the wrap point" ) {
+        const auto spans = ring.as_spans();
+        REQUIRE( (spans.first.size() == 4 && spans.second.size() == 4) );
+        REQUIRE( (spans.first[0] == 5 && spans.second[0] == 3) );
+    }
+    SECTION( "range from input iterators grows" ) {
+        std::list<int> more { 7, 8, 9 };
+        ring.push_back(more.begin(), more.end());
+        REQUIRE( ring.size() == 11 );
+        REQUIRE( ring.capacity() == 16 );
+        REQUIRE( ring.back() == 9 );
+        const auto spans = ring.as_spans();
+        REQUIRE( (spans.first.size() == 11 && spans.second.empty()) );
+    }
+    SECTION( "pop_front everything resets the head" ) {
+        ring.pop_front(ring.size());
+        REQUIRE( ring.empty() );
+        ring.push_back(1);
+        REQUIRE( ring.as_spans().first.data() == &ring.front() );
+    }
+}
+
+TEST_CASE( "ring_buffer iterators", "[ring_buffer]" ) {
+    omega::ring_buffer<int> ring(4);
+    for (int value : { 4, 1, 3, 2 })
+    {
+        ring.push_back(value);
+    }
+    ring.pop_front();
+    ring.push_back(0);
+
+    SECTION( "random access across the wrap" ) {
+        auto first = ring.begin();
+        REQUIRE( ring.end() - first == 4 );
+        REQUIRE( first[3] == 0 );
+        REQUIRE( *(first + 3) == 0 );
+    }
+    SECTION( "sort" ) {
+        std::sort(ring.begin(), ring.end());
+        REQUIRE( contents(ring) == (std::vector<int>{ 0, 1, 2, 3 }) );
+    }
+    SECTION( "reverse iteration" ) {
+        std::vector<int> reversed(ring.rbegin(), ring.rend());
+        REQUIRE( reversed == (std::vector<int>{ 0, 2, 3, 1 }) );
+    }
+}
+
+TEST_CASE( "ring_buffer copy, move and allocators", "[ring_buffer]" ) {
+    omega::ring_buffer<std::string, propagate_not_equal_allocator<std::string>> ring(2);
+    ring.push_back("a");
+    ring.push_back("b");
+    ring.pop_front();
+    ring.push_back("c");
+
+    SECTION( "copy construction" ) {
+        auto copy = ring;
+        REQUIRE( contents(copy) == (std::vector<std::string>{ "b", "c" }) );
+    }
+    SECTION( "copy assignment" ) {
+        decltype(ring) copy;
+        copy = ring;
+        REQUIRE( contents(copy) == (std::vector<std::string>{ "b", "c" }) );
+    }
+    SECTION( "move assignment" ) {
+        decltype(ring) other;
+        other = std::move(ring);
+        REQUIRE( (contents(other) == (std::vector<std::string>{ "b", "c" }) && ring.empty()) );
+    }
+    SECTION( "swap" ) {
+        decltype(ring) other;
+        other.swap(ring);
+        REQUIRE( (other.size() == 2 && ring.capacity() == 0) );
+    }
+    SECTION( "shrink_to_fit" ) {
+        ring.reserve(16);
+        REQUIRE( ring.capacity() == 16 );
+        ring.shrink_to_fit();
+        REQUIRE( (ring.capacity() == 2 && ring.front() == "b") );
+    }
+}
@@ -0,0 +1,184 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../serialize.hpp"
+#include "allocator.hpp"
+
+namespace
+{
+    struct point
+    {
+        int32_t x;
+        int32_t y;
+    };
+
+    // Counts the buffers it hands out, to tell a single read from growth
+    template<typename T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        static size_t allocations;
+
+        counting_allocator() noexcept = default;
+        template<typename U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        T* allocate(size_t count)
+        {
+            ++allocations;
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t) noexcept
+        {
+            ::operator delete(p);
+        }
+    };
+
+    template<typename T>
+    size_t counting_allocator<T>::allocations = 0;
+
+    template<typename T, typename U>
+    bool operator == (const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return true; }
+
+    template<typename T, typename U>
+    bool operator != (const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return false; }
+
+    // Temporary file that is deleted on close
+    int temp_file()
+    {
+        char path[] = "/tmp/omega_serialize_XXXXXX";
+        const auto fd = mkstemp(path);
+        unlink(path);
+        return fd;
+    }
+}
+
+TEST_CASE( "serialize trivially copyable vectors", "[serialize]" ) {
+    const auto fd = temp_file();
+    REQUIRE( fd >= 0 );
+
+    SECTION( "round trip through a file" ) {
+        omega::vector<point> points;
+        for (int32_t i = 0; i < 100000; ++i)
+        {
+            points.push_back(point{ i, -i });
+        }
+        const omega::vector<point> empty;
+        omega::serialize(points, fd);
+        omega::serialize(empty, fd);
+        REQUIRE( lseek(fd, 0, SEEK_CUR) == static_cast<off_t>(2 * sizeof(omega::serialized_header) + points.size() * sizeof(point)) );
+
+        lseek(fd, 0, SEEK_SET);
+        const auto loaded = omega::deserialize<point, allocator<point>>(fd);
+        REQUIRE( (loaded.size() == points.size() && loaded.capacity() == points.size()) );
+        REQUIRE( (loaded[99999].x == 99999 && loaded[99999].y == -99999) );
+        REQUIRE( omega::deserialize<point>(fd).empty() );
+        REQUIRE_THROWS_AS( omega::deserialize<point>(fd), std::system_error );
+    }
+    SECTION( "another element size or byte order is rejected" ) {
+        const omega::vector<uint32_t> values{ 1, 2, 3 };
+        omega::serialize(values, fd);
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<uint64_t>(fd), std::system_error );
+
+        omega::serialized_header header;
+        REQUIRE( pread(fd, &header, sizeof(header), 0) == sizeof(header) );
+        header.byte_order = 0x0201;
+        REQUIRE( pwrite(fd, &header, sizeof(header), 0) == sizeof(header) );
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<uint32_t>(fd), std::system_error );
+    }
+    SECTION( "a truncated payload is rejected" ) {
+        const omega::vector<uint64_t> values{ 1, 2, 3, 4 };
+        omega::serialize(values, fd);
+        REQUIRE( ftruncate(fd, static_cast<off_t>(sizeof(omega::serialized_header) + 3 * sizeof(uint64_t))) == 0 );
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<uint64_t>(fd), std::system_error );
+    }
+    SECTION( "payloads over a chunk are read at once from a file and in growing pieces from a pipe" ) {
+        using counted = counting_allocator<uint64_t>;
+        omega::vector<uint64_t> values;
+        for (uint64_t i = 0; i < 300000; ++i)
+        {
+            values.push_back(i * 3);
+        }
+        omega::serialize(values, fd);
+        lseek(fd, 0, SEEK_SET);
+        counted::allocations = 0;
+        const auto from_file = omega::deserialize<uint64_t, counted>(fd);
+        REQUIRE( (counted::allocations == 1 && from_file.capacity() == values.size()) );
+        REQUIRE( std::equal(values.begin(), values.end(), from_file.begin()) );
+
+        int fds[2];
+        REQUIRE( pipe(fds) == 0 );
+        std::thread writer{ [&values, &fds] {
+            omega::serialize(values, fds[1]);
+            close(fds[1]);
+        } };
+        counted::allocations = 0;
+        const auto from_pipe = omega::deserialize<uint64_t, counted>(fds[0]);
+        writer.join();
+        close(fds[0]);
+        REQUIRE( (counted::allocations > 1 && from_pipe.capacity() == values.size()) );
+        REQUIRE( std::equal(values.begin(), values.end(), from_pipe.begin()) );
+    }
+    SECTION( "a forged count fails as truncated instead of allocating" ) {
+        const omega::vector<uint64_t> values{ 1, 2, 3 };
+        omega::serialize(values, fd);
+        omega::serialized_header header;
+        REQUIRE( pread(fd, &header, sizeof(header), 0) == sizeof(header) );
+        header.count = uint64_t{ 1 } << 58;
+        header.payload_bytes = header.count * sizeof(uint64_t);
+        REQUIRE( pwrite(fd, &header, sizeof(header), 0) == sizeof(header) );
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<uint64_t>(fd), std::system_error );
+    }
+
+    close(fd);
+}
+
+TEST_CASE( "serialize through the hook", "[serialize]" ) {
+    SECTION( "strings through a pipe" ) {
+        int fds[2];
+        REQUIRE( pipe(fds) == 0 );
+        omega::vector<std::string> words;
+        for (int i = 0; i < 20000; ++i)
+        {
+            words.push_back(std::string(static_cast<size_t>(i % 50), 'a' + i % 26));
+        }
+
+        // the payload is bigger than the pipe buffer
+        std::thread writer{ [&words, &fds] {
+            omega::serialize(words, fds[1]);
+            close(fds[1]);
+        } };
+        const auto loaded = omega::deserialize<std::string>(fds[0]);
+        writer.join();
+        close(fds[0]);
+        REQUIRE( loaded == words );
+    }
+    SECTION( "a forged count is rejected" ) {
+        const auto fd = temp_file();
+        const omega::vector<std::string> words{ "one", "two" };
+        omega::serialize(words, fd);
+        omega::serialized_header header;
+        REQUIRE( pread(fd, &header, sizeof(header), 0) == sizeof(header) );
+        header.count = 3;
+        REQUIRE( pwrite(fd, &header, sizeof(header), 0) == sizeof(header) );
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<std::string>(fd), std::system_error );
+        header.payload_bytes = uint64_t{ 1 } << 60;
+        REQUIRE( pwrite(fd, &header, sizeof(header), 0) == sizeof(header) );
+        lseek(fd, 0, SEEK_SET);
+        REQUIRE_THROWS_AS( omega::deserialize<std::string>(fd), std::system_error );
+        close(fd);
+    }
+}
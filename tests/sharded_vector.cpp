@@ -0,0 +1,162 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../sharded_vector.hpp"
+#include "allocator.hpp"
+
+template class omega::sharded_vector<int>;
+template class omega::sharded_vector<std::string>;
+
+namespace
+{
+    std::atomic<int> copies_left{ -1 };
+
+    // Has no move constructor, so merge copies it; throws once copies_left runs out
+    struct fragile
+    {
+        explicit fragile(int v) : value{ v } {}
+
+        fragile(const fragile& rhs) : value{ rhs.value }
+        {
+            if (copies_left.fetch_sub(1) == 0)
+            {
+                throw std::runtime_error("copy failed");
+            }
+        }
+
+        int value;
+    };
+}
+
+TEST_CASE( "sharded_vector on one thread", "[sharded_vector]" ) {
+    omega::sharded_vector<std::string> values{ 3 };
+
+    SECTION( "merge concatenates in shard order" ) {
+        auto first = values.make_writer();
+        auto second = values.make_writer();
+        second.push_back("c");
+        first.push_back("a");
+        first.emplace_back(2, 'b');
+        second.push_back(std::string{ "d" });
+        REQUIRE( (first.size() == 2 && second.size() == 2) );
+        REQUIRE( values.size() == 4 );
+
+        const auto merged = values.merge();
+        REQUIRE( merged.size() == 4 );
+        REQUIRE( (merged[0] == "a" && merged[1] == "bb" && merged[2] == "c" && merged[3] == "d") );
+        REQUIRE( values.empty() );
+        REQUIRE( first.size() == 0 );
+    }
+    SECTION( "shards are limited and reused" ) {
+        {
+            auto a = values.make_writer();
+            auto b = values.make_writer();
+            auto c = values.make_writer();
+            REQUIRE_THROWS_AS( values.make_writer(), std::length_error );
+            a.push_back("kept");
+        }
+        auto again = values.make_writer();
+        again.push_back("more");
+        const auto merged = values.merge();
+        REQUIRE( (merged.size() == 2 && merged[0] == "kept" && merged[1] == "more") );
+    }
+    SECTION( "merge of nothing" ) {
+        REQUIRE( values.merge().empty() );
+    }
+    SECTION( "clear" ) {
+        auto writer = values.make_writer();
+        writer.push_back("x");
+        values.clear();
+        REQUIRE( values.empty() );
+    }
+    SECTION( "custom allocator" ) {
+        omega::sharded_vector<int, allocator<int>> numbers{ 2 };
+        auto writer = numbers.make_writer();
+        for (int i = 0; i < 10000; ++i)
+        {
+            writer.push_back(i);
+        }
+        const auto merged = numbers.merge(4);
+        REQUIRE( (merged.size() == 10000 && merged[9999] == 9999) );
+    }
+}
+
+TEST_CASE( "sharded_vector merges on several threads", "[sharded_vector]" ) {
+    const int shards = 5;
+    const int per_shard = 7000;
+    omega::sharded_vector<std::string> values{ shards };
+    std::vector<omega::sharded_vector<std::string>::writer> writers;
+    for (int s = 0; s < shards; ++s)
+    {
+        writers.push_back(values.make_writer());
+        for (int i = 0; i < per_shard; ++i)
+        {
+            writers.back().push_back(std::to_string(s * per_shard + i));
+        }
+    }
+
+    const auto merged = values.merge(4);
+    REQUIRE( merged.size() == static_cast<size_t>(shards * per_shard) );
+    bool ordered = true;
+    for (int i = 0; i < shards * per_shard; ++i)
+    {
+        ordered = ordered && merged[i] == std::to_string(i);
+    }
+    REQUIRE( ordered );
+    REQUIRE( values.empty() );
+}
+
+TEST_CASE( "sharded_vector merge unwinds a failed copy", "[sharded_vector]" ) {
+    omega::sharded_vector<fragile> values{ 2 };
+    auto first = values.make_writer();
+    auto second = values.make_writer();
+    for (int i = 0; i < 10000; ++i)
+    {
+        first.emplace_back(i);
+        second.emplace_back(-i);
+    }
+
+    copies_left = 15000;
+    REQUIRE_THROWS_AS( values.merge(4), std::runtime_error );
+    copies_left = -1;
+    REQUIRE( values.size() == 20000 );
+
+    const auto merged = values.merge(4);
+    REQUIRE( (merged.size() == 20000 && merged[9999].value == 9999 && merged[19999].value == -9999) );
+}
+
+TEST_CASE( "sharded_vector with many writers", "[sharded_vector]" ) {
+    const int threads = 8;
+    const int per_thread = 20000;
+    omega::sharded_vector<int> values{ threads };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&values, t] {
+            auto writer = values.make_writer();
+            for (int i = 0; i < per_thread; ++i)
+            {
+                writer.push_back(t * per_thread + i);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    const auto merged = values.merge();
+    std::vector<int> sorted(merged.begin(), merged.end());
+    std::sort(sorted.begin(), sorted.end());
+    bool complete = sorted.size() == static_cast<size_t>(threads * per_thread);
+    for (size_t i = 0; complete && i < sorted.size(); ++i)
+    {
+        complete = sorted[i] == static_cast<int>(i);
+    }
+    REQUIRE( complete );
+}
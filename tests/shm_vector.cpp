@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../shm_vector.hpp"
+
+namespace
+{
+    struct record
+    {
+        uint64_t key;
+        uint64_t square;
+    };
+
+    std::string shm_name(const char* name)
+    {
+        return "/omega_" + std::string{ name } + "_" + std::to_string(getpid());
+    }
+
+    // Runs in a forked child: follows the writer until count records are
+    // published and checks each one. Returns the exit status.
+    int follow(const std::string& name, uint64_t count)
+    {
+        try
+        {
+            const omega::shm_vector<record> records(name);
+            if (records.writer() || records.max_size() < count)
+            {
+                return 2;
+            }
+
+            uint64_t seen = 0;
+            while (seen < count)
+            {
+                const auto size = records.size();
+                for (; seen < size; ++seen)
+                {
+                    if (records[seen].key != seen || records[seen].square != seen * seen)
+                    {
+                        return 3;
+                    }
+                }
+                if (seen < count)
+                {
+                    usleep(100);
+                }
+            }
+            return 0;
+        }
+        catch (...)
+        {
+            return 4;
+        }
+    }
+}
+
+template class omega::shm_vector<record>;
+
+TEST_CASE( "shm_vector", "[shm_vector]" ) {
+    const auto name = shm_name("shm_vector");
+    omega::shm_vector<record>::unlink(name);
+
+    SECTION( "readers in other processes follow the writer" ) {
+        const uint64_t count = 200000;
+        omega::shm_vector<record> records(name, count);
+        REQUIRE( (records.writer() && records.empty() && records.max_size() == count) );
+
+        pid_t readers[2];
+        for (auto& reader : readers)
+        {
+            reader = fork();
+            if (reader == 0)
+            {
+                _exit(follow(name, count));
+            }
+            REQUIRE( reader > 0 );
+        }
+
+        for (uint64_t i = 0; i < count / 2; ++i)
+        {
+            records.push_back(record{ i, i * i });
+        }
+        record batch[1000];
+        for (uint64_t i = count / 2; i < count; i += 1000)
+        {
+            for (uint64_t j = 0; j < 1000; ++j)
+            {
+                batch[j] = record{ i + j, (i + j) * (i + j) };
+            }
+            records.append(batch, batch + 1000);
+        }
+
+        for (auto reader : readers)
+        {
+            int status = 0;
+            REQUIRE( waitpid(reader, &status, 0) == reader );
+            REQUIRE( (WIFEXITED(status) && WEXITSTATUS(status) == 0) );
+        }
+        REQUIRE( (records.size() == count && records.at(count - 1).key == count - 1) );
+        REQUIRE_THROWS_AS( records.push_back(record{ 0, 0 }), std::length_error );
+    }
+
+    SECTION( "a reader sees published elements and cannot append" ) {
+        omega::shm_vector<record> writer(name, 100);
+        writer.emplace_back(record{ 7, 49 });
+
+        omega::shm_vector<record> reader(name);
+        REQUIRE( (!reader.writer() && reader.size() == 1 && reader[0].key == 7 && reader.max_size() == 100) );
+        writer.push_back(record{ 8, 64 });
+        REQUIRE( (reader.size() == 2 && reader.end() - reader.begin() == 2 && (*reader.rbegin()).square == 64) );
+        REQUIRE_THROWS_AS( reader.push_back(record{ 0, 0 }), std::system_error );
+        REQUIRE_THROWS_AS( reader.at(2), std::out_of_range );
+    }
+
+    SECTION( "the writer owns the name" ) {
+        {
+            omega::shm_vector<record> writer(name, 10);
+            REQUIRE_THROWS_AS( (omega::shm_vector<record>(name, 10)), std::system_error );
+
+            omega::shm_vector<record> moved(std::move(writer));
+            moved.push_back(record{ 1, 1 });
+            REQUIRE( (moved.size() == 1 && writer.size() == 0 && !writer.writer()) );
+        }
+        REQUIRE_THROWS_AS( omega::shm_vector<record>{ name }, std::system_error );
+    }
+
+    SECTION( "an object whose header is not published yet is rejected" ) {
+        // what a reader sees between the writer's ftruncate and its store of the magic
+        const auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        REQUIRE( fd >= 0 );
+        REQUIRE( ftruncate(fd, omega::shm_vector<record>::DATA_OFFSET) == 0 );
+        close(fd);
+        REQUIRE_THROWS_AS( omega::shm_vector<record>{ name }, std::system_error );
+        omega::shm_vector<record>::unlink(name);
+    }
+
+    SECTION( "other element types are rejected" ) {
+        omega::shm_vector<record> writer(name, 10);
+        REQUIRE_THROWS_AS( omega::shm_vector<uint32_t>{ name }, std::system_error );
+    }
+}
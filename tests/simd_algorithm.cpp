@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include "../simd_algorithm.hpp"
+
+namespace
+{
+    const omega::simd::isa levels[] = { omega::simd::isa::scalar, omega::simd::isa::sse2
+                                        , omega::simd::isa::avx2, omega::simd::isa::avx512 };
+
+    template<typename T>
+    omega::vector<T> pattern(int count)
+    {
+        omega::vector<T> values;
+        for (int i = 0; i < count; ++i)
+        {
+            values.push_back(static_cast<T>((i * 37) % 101));
+        }
+        return values;
+    }
+
+    // Every kernel against std algorithms on every length up to a few
+    // vectors, so all tail and block paths run
+    template<typename T>
+    void check_kernels()
+    {
+        for (int count = 1; count < 300; count += count < 70 ? 1 : 23)
+        {
+            const auto values = pattern<T>(count);
+            const auto first = values.data();
+            const auto last = first + count;
+            for (const auto level : levels)
+            {
+                for (const T needle : { T(0), T(50), T(100), T(200) })
+                {
+                    REQUIRE( omega::simd::find(first, last, needle, level) == std::find(first, last, needle) );
+                    REQUIRE( omega::simd::count(first, last, needle, level)
+                             == static_cast<size_t>(std::count(first, last, needle)) );
+                    REQUIRE( omega::simd::contains(first, last, needle, level) == (std::find(first, last, needle) != last) );
+                }
+                REQUIRE( omega::simd::min(first, last, level) == *std::min_element(first, last) );
+                REQUIRE( omega::simd::max(first, last, level) == *std::max_element(first, last) );
+                const auto both = omega::simd::minmax(first, last, level);
+                REQUIRE( (both.first == *std::min_element(first, last) && both.second == *std::max_element(first, last)) );
+                REQUIRE( omega::simd::sum(first, last, level) == std::accumulate(first, last, T(0)) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "simd kernels match the std algorithms", "[simd_algorithm]" ) {
+    check_kernels<int>();
+    check_kernels<unsigned>();
+    check_kernels<int64_t>();
+    check_kernels<uint64_t>();
+    check_kernels<float>();
+    check_kernels<double>();
+}
+
+TEST_CASE( "simd algorithms on omega::vector", "[simd_algorithm]" ) {
+    SECTION( "vector overloads" ) {
+        omega::vector<double> values{ 3.5, -1.0, 8.0, 2.0, -1.0 };
+        REQUIRE( omega::simd::find(values, 8.0) == values.cbegin() + 2 );
+        REQUIRE( omega::simd::find(values, 7.0) == values.cend() );
+        REQUIRE( omega::simd::count(values, -1.0) == 2 );
+        REQUIRE( omega::simd::contains(values, 2.0) );
+        REQUIRE( omega::simd::min(values) == -1.0 );
+        REQUIRE( omega::simd::max(values) == 8.0 );
+        REQUIRE( omega::simd::minmax(values) == std::make_pair(-1.0, 8.0) );
+        REQUIRE( omega::simd::sum(values) == 11.5 );
+    }
+    SECTION( "integer sums wrap" ) {
+        omega::vector<int> values;
+        values.resize(100, 0x7fffffff);
+        REQUIRE( omega::simd::sum(values) == static_cast<int>(100u * 0x7fffffffu) );
+    }
+    SECTION( "other types use the scalar loops" ) {
+        omega::vector<std::string> words{ "b", "a", "c", "a" };
+        REQUIRE( omega::simd::count(words, std::string{ "a" }) == 2 );
+        REQUIRE( omega::simd::min(words) == "a" );
+        REQUIRE( omega::simd::sum(words) == "baca" );
+        omega::vector<short> shorts{ 4, -2, 9 };
+        REQUIRE( omega::simd::minmax(shorts) == std::make_pair<short, short>(-2, 9) );
+    }
+    SECTION( "first match in a long run" ) {
+        omega::vector<float> values;
+        values.resize(100000, 1.0f);
+        values[77777] = 2.0f;
+        values[88888] = 2.0f;
+        REQUIRE( omega::simd::find(values, 2.0f) - values.cbegin() == 77777 );
+        REQUIRE( omega::simd::count(values, 1.0f) == 99998 );
+    }
+}
@@ -0,0 +1,159 @@
+#include "catch.hpp"
+#include <string>
+#include <tuple>
+#include <stdexcept>
+#include "../soa_vector.hpp"
+#include "allocator.hpp"
+
+namespace
+{
+    struct throwing_on_copy
+    {
+        throwing_on_copy() = default;
+
+        throwing_on_copy(const throwing_on_copy&)
+        {
+            throw std::runtime_error("copy");
+        }
+
+        throwing_on_copy(throwing_on_copy&&) noexcept = default;
+    };
+}
+
+template class omega::basic_soa_vector<std::allocator<std::tuple<int, std::string>>, int, std::string>;
+
+TEST_CASE( "soa_vector rows", "[soa_vector]" ) {
+    omega::soa_vector<int, float, std::string> v;
+    v.emplace_back(1, 1.5f, "one");
+    v.push_back(std::make_tuple(2, 2.5f, std::string("two")));
+    v.emplace_back(3, 3.5f, "three");
+
+    SECTION( "size and capacity" ) {
+        REQUIRE( v.size() == 3 );
+        REQUIRE( v.capacity() >= 3 );
+        REQUIRE_FALSE( v.empty() );
+    }
+    SECTION( "proxy reference reads fields" ) {
+        REQUIRE( std::get<0>(v[1]) == 2 );
+        REQUIRE( std::get<1>(v.front()) == 1.5f );
+        REQUIRE( std::get<2>(v.back()) == "three" );
+    }
+    SECTION( "proxy reference writes through" ) {
+        std::get<0>(v[0]) = 10;
+        v[2] = std::make_tuple(30, 30.5f, std::string("thirty"));
+        REQUIRE( v.column<0>()[0] == 10 );
+        REQUIRE( (v.column<0>()[2] == 30 && v.column<2>()[2] == "thirty") );
+    }
+    SECTION( "at - index out of range" ) {
+        REQUIRE_THROWS_AS( v.at(3), std::out_of_range );
+        const auto& cv = v;
+        REQUIRE_THROWS_AS( cv.at(3), std::out_of_range );
+    }
+    SECTION( "pop_back and resize" ) {
+        v.pop_back();
+        REQUIRE( v.size() == 2 );
+        v.resize(5);
+        REQUIRE( (v.size() == 5 && v.column<1>().size() == 5 && v.column<2>()[4].empty()) );
+        v.resize(1);
+        REQUIRE( (v.size() == 1 && std::get<2>(v[0]) == "one") );
+    }
+    SECTION( "clear and shrink_to_fit" ) {
+        v.clear();
+        v.shrink_to_fit();
+        REQUIRE( (v.empty() && v.capacity() == 0) );
+    }
+    SECTION( "swap" ) {
+        omega::soa_vector<int, float, std::string> other;
+        other.swap(v);
+        REQUIRE( (v.empty() && other.size() == 3) );
+    }
+}
+
+TEST_CASE( "soa_vector columns", "[soa_vector]" ) {
+    omega::soa_vector<int, double> v;
+    for (int i = 0; i < 100; ++i)
+    {
+        v.emplace_back(i, i * 0.5);
+    }
+
+    SECTION( "column is a contiguous span" ) {
+        auto ints = v.column<0>();
+        REQUIRE( ints.size() == 100 );
+        REQUIRE( &ints[99] - &ints[0] == 99 );
+
+        long sum = 0;
+        for (auto value : ints)
+        {
+            sum += value;
+        }
+        REQUIRE( sum == 4950 );
+    }
+    SECTION( "arguments may refer to elements that growth moves" ) {
+        omega::soa_vector<int, std::string> words;
+        words.emplace_back(7, "a string too long for the small buffer");
+        while (words.size() != words.capacity())
+        {
+            words.emplace_back(1, "x");
+        }
+        words.emplace_back(words.column<0>()[0], words.column<1>()[0]);
+        words.push_back(words[0]);
+        REQUIRE( std::get<0>(words.back()) == 7 );
+        REQUIRE( std::get<1>(words[words.size() - 2]) == "a string too long for the small buffer" );
+    }
+    SECTION( "columns grow together" ) {
+        v.reserve(1000);
+        REQUIRE( v.capacity() == 1000 );
+    }
+    SECTION( "mutating a column" ) {
+        for (auto& value : v.column<1>())
+        {
+            value *= 2;
+        }
+        REQUIRE( std::get<1>(v[10]) == 10.0 );
+    }
+}
+
+TEST_CASE( "soa_vector AoS conversion", "[soa_vector]" ) {
+    omega::vector<std::tuple<int, float>> rows { std::make_tuple(1, 1.0f), std::make_tuple(2, 2.0f) };
+
+    SECTION( "from omega::vector of tuples" ) {
+        omega::soa_vector<int, float> v(rows);
+        REQUIRE( v.size() == 2 );
+        REQUIRE( (v.column<0>()[1] == 2 && v.column<1>()[0] == 1.0f) );
+    }
+    SECTION( "round trip" ) {
+        omega::soa_vector<int, float> v(rows);
+        auto back = v.to_aos();
+        REQUIRE( back.size() == 2 );
+        REQUIRE( (back[0] == rows[0] && back[1] == rows[1]) );
+    }
+    SECTION( "with a custom allocator" ) {
+        omega::basic_soa_vector<allocator<std::tuple<int, float>>, int, float> v(rows);
+        auto back = v.to_aos(allocator<std::tuple<int, float>>{});
+        REQUIRE( (back.size() == 2 && back[1] == rows[1]) );
+    }
+}
+
+TEST_CASE( "soa_vector keeps columns consistent when a field throws", "[soa_vector]" ) {
+    const throwing_on_copy bad{};
+
+    SECTION( "while growing" ) {
+        omega::soa_vector<int, throwing_on_copy> v;
+        v.emplace_back(1, throwing_on_copy{});
+
+        REQUIRE_THROWS_AS( v.emplace_back(2, bad), std::runtime_error );
+        REQUIRE( v.size() == 1 );
+        REQUIRE( v.column<0>().size() == v.column<1>().size() );
+    }
+    SECTION( "after the earlier columns are built in reserved capacity" ) {
+        omega::soa_vector<int, std::string, throwing_on_copy> v;
+        v.reserve(4);
+        v.emplace_back(1, "one", throwing_on_copy{});
+        const auto capacity = v.capacity();
+
+        REQUIRE_THROWS_AS( v.emplace_back(2, "two", bad), std::runtime_error );
+        REQUIRE( (v.size() == 1 && v.capacity() == capacity) );
+        REQUIRE( (v.column<0>().size() == 1 && v.column<1>().size() == 1 && v.column<2>().size() == 1) );
+        REQUIRE( (v.column<0>()[0] == 1 && v.column<1>()[0] == "one") );
+    }
+}
@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../thread_cache_allocator.hpp"
+#include "../vector.hpp"
+
+template class omega::vector<int, omega::thread_cache_allocator<int>>;
+template class omega::vector<std::string, omega::thread_cache_allocator<std::string>>;
+
+static_assert(std::allocator_traits<omega::thread_cache_allocator<int>>::is_always_equal::value, "stateless");
+
+TEST_CASE( "thread_cache_allocator", "[thread_cache_allocator]" ) {
+    using int_vector = omega::vector<int, omega::thread_cache_allocator<int>>;
+    omega::thread_cache::flush();
+    const auto baseline = omega::size_class_pool::instance().statistics().block_bytes;
+
+    SECTION( "a freed block is reused by the same thread" ) {
+        omega::thread_cache_allocator<uint64_t> alloc;
+        const auto first = alloc.allocate(100);
+        alloc.deallocate(first, 100);
+        REQUIRE( omega::thread_cache::cached_bytes() >= 1024 );
+        const auto again = alloc.allocate(120);
+        REQUIRE( again == first );
+        alloc.deallocate(again, 120);
+    }
+    SECTION( "the cache is bounded" ) {
+        omega::thread_cache_allocator<char> alloc;
+        std::vector<char*> blocks;
+        for (int i = 0; i < 10000; ++i)
+        {
+            blocks.push_back(alloc.allocate(64));
+        }
+        for (auto p : blocks)
+        {
+            alloc.deallocate(p, 64);
+        }
+        REQUIRE( omega::thread_cache::cached_bytes() <= omega::thread_cache::CLASS_BYTES + 64 );
+
+        const auto big = alloc.allocate(1 << 20);
+        alloc.deallocate(big, 1 << 20);
+        REQUIRE( omega::thread_cache::cached_bytes() <= omega::thread_cache::CLASS_BYTES + 64 );
+    }
+    SECTION( "vectors" ) {
+        omega::vector<std::string, omega::thread_cache_allocator<std::string>> words;
+        for (int i = 0; i < 10000; ++i)
+        {
+            words.push_back(std::to_string(i));
+        }
+        words.push_back(words[0]);
+        auto other = std::move(words);
+        REQUIRE( (other[9999] == "9999" && other.back() == "0") );
+    }
+    SECTION( "blocks freed by other threads" ) {
+        std::mutex lock;
+        std::condition_variable ready;
+        std::deque<int_vector> queue;
+        bool done = false;
+
+        // consumer frees every buffer the producers allocated
+        std::thread consumer{ [&] {
+            size_t seen = 0;
+            for (;;)
+            {
+                std::unique_lock<std::mutex> guard{ lock };
+                ready.wait(guard, [&] { return done || !queue.empty(); });
+                if (queue.empty())
+                {
+                    break;
+                }
+                auto values = std::move(queue.front());
+                queue.pop_front();
+                guard.unlock();
+                if (values[values.size() - 1] != static_cast<int>(values.size()) - 1)
+                {
+                    throw std::logic_error("buffer was reused while in use");
+                }
+                ++seen;
+            }
+            REQUIRE( seen == 4 * 2000 );
+        } };
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t)
+        {
+            producers.emplace_back([&, t] {
+                for (int round = 0; round < 2000; ++round)
+                {
+                    int_vector values;
+                    for (int i = 0; i < 10 + (round + t) % 300; ++i)
+                    {
+                        values.push_back(i);
+                    }
+                    std::lock_guard<std::mutex> guard{ lock };
+                    queue.push_back(std::move(values));
+                    ready.notify_one();
+                }
+            });
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            done = true;
+        }
+        ready.notify_one();
+        consumer.join();
+    }
+
+    // exiting threads gave their caches back
+    omega::thread_cache::flush();
+    REQUIRE( omega::size_class_pool::instance().statistics().block_bytes == baseline );
+}
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../virtual_vector.hpp"
+
+template class omega::virtual_vector<int>;
+template class omega::virtual_vector<std::string>;
+
+TEST_CASE( "virtual_vector growth", "[virtual_vector]" ) {
+    omega::virtual_vector<std::string> words;
+    const auto data = words.data();
+    REQUIRE( (data != nullptr && words.capacity() == 0) );
+    REQUIRE( words.max_size() == omega::virtual_vector<std::string>::DEFAULT_RESERVE / sizeof(std::string) );
+
+    SECTION( "growth never moves elements" ) {
+        words.push_back("first");
+        const auto first = &words[0];
+        auto iter = words.begin();
+        for (int i = 0; i < 100000; ++i)
+        {
+            words.push_back(words[i % words.size()]);
+        }
+        REQUIRE( (words.data() == data && &words[0] == first && *iter == "first") );
+        REQUIRE( words.capacity() >= words.size() );
+        words.emplace_back(3, 'x');
+        REQUIRE( (words.back() == "xxx" && words.size() == 100002) );
+    }
+    SECTION( "insert and erase in place" ) {
+        words.assign({ "a", "d" });
+        REQUIRE( *words.insert(words.begin() + 1, "b") == "b" );
+        words.emplace(words.begin() + 2, 1, 'c');
+        words.insert(words.end(), 2, "e");
+        const std::vector<std::string> more{ "f", "g" };
+        words.insert(words.end(), more.begin(), more.end());
+        REQUIRE( words.size() == 8 );
+        REQUIRE( (words[2] == "c" && words[3] == "d" && words[5] == "e" && words[7] == "g") );
+        REQUIRE( *words.erase(words.begin()) == "b" );
+        words.erase(words.begin() + 3, words.end() - 2);
+        const std::vector<std::string> expected{ "b", "c", "d", "f", "g" };
+        REQUIRE( std::vector<std::string>(words.begin(), words.end()) == expected );
+        REQUIRE( words.data() == data );
+    }
+    SECTION( "shrink_to_fit decommits" ) {
+        words.resize(50000, "word");
+        const auto committed = words.capacity();
+        words.resize(10);
+        words.shrink_to_fit();
+        REQUIRE( words.capacity() < committed );
+        REQUIRE( (words.size() == 10 && words[9] == "word" && words.data() == data) );
+        words.resize(60000, "again");
+        REQUIRE( (words[59999] == "again" && words.data() == data) );
+        words.clear();
+        words.shrink_to_fit();
+        REQUIRE( words.capacity() == 0 );
+        REQUIRE_THROWS_AS( words.at(0), std::out_of_range );
+    }
+}
+
+TEST_CASE( "virtual_vector of elements that do not divide a page", "[virtual_vector]" ) {
+    struct triple
+    {
+        uint64_t a, b, c;
+    };
+    static_assert(sizeof(triple) == 24, "the page size is not a multiple of the element size");
+
+    omega::virtual_vector<triple> triples;
+    const auto data = triples.data();
+    bool within = true;
+    for (uint64_t i = 0; i < 100000; ++i)
+    {
+        triples.push_back({ i, i + 1, i + 2 });
+        within = within && triples.capacity() >= triples.size();
+    }
+    REQUIRE( within );
+    triples.resize(1001);
+    triples.shrink_to_fit();
+    for (uint64_t i = 1001; i < 50000; ++i)
+    {
+        triples.emplace_back(triple{ i, i + 1, i + 2 });
+    }
+    bool intact = true;
+    for (uint64_t i = 0; i < triples.size(); ++i)
+    {
+        intact = intact && triples[i].a == i && triples[i].c == i + 2;
+    }
+    REQUIRE( (intact && triples.size() == 50000 && triples.data() == data) );
+}
+
+TEST_CASE( "virtual_vector reservation", "[virtual_vector]" ) {
+    SECTION( "a push past max_size throws" ) {
+        omega::virtual_vector<uint64_t> values(1000);
+        REQUIRE( values.max_size() >= 1000 );
+        values.resize(values.max_size(), 1);
+        REQUIRE_THROWS_AS( values.push_back(2), std::length_error );
+        REQUIRE_THROWS_AS( values.reserve(values.max_size() + 1), std::length_error );
+        REQUIRE( (values.size() == values.max_size() && values.back() == 1) );
+    }
+    SECTION( "copy and move" ) {
+        omega::virtual_vector<int> numbers({ 1, 2, 3 }, 4096);
+        auto copy = numbers;
+        REQUIRE( (copy.size() == 3 && copy.max_size() == numbers.max_size() && copy.data() != numbers.data()) );
+        const auto data = numbers.data();
+        auto moved = std::move(numbers);
+        REQUIRE( (moved.data() == data && moved[2] == 3 && numbers.empty()) );
+        numbers.push_back(4);
+        REQUIRE( numbers[0] == 4 );
+        copy = moved;
+        moved = std::move(numbers);
+        REQUIRE( (copy[1] == 2 && moved.size() == 1) );
+    }
+}
@@ -0,0 +1,267 @@
+#ifndef OMEGA_THREAD_CACHE_ALLOCATOR_HPP
+#define OMEGA_THREAD_CACHE_ALLOCATOR_HPP
+
+#include "pool_allocator.hpp"
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace omega
+{
+    // Per-thread free lists in front of size_class_pool. A freed block goes
+    // to the cache of the thread that frees it, whichever thread allocated
+    // it, and the next allocation of that class on the thread takes it back
+    // without a lock. An empty list refills BATCH blocks from the pool under
+    // one lock; a list holding CLASS_BYTES (or two blocks, if more) gives
+    // half of them back, so a thread caches a bounded number of bytes and
+    // blocks freed by a consumer thread flow back to producers through the
+    // pool. A thread's cache goes back to the pool when the thread exits.
+    class thread_cache
+    {
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        struct bin
+        {
+            free_block* first = nullptr;
+            size_t count = 0;
+        };
+
+        enum state : unsigned char
+        {
+            unborn,
+            alive,
+            dead
+        };
+
+    public:
+        static constexpr size_t CLASS_BYTES = size_t{ 1 } << 16;
+        static constexpr size_t BATCH = 32;
+
+        thread_cache(const thread_cache&) = delete;
+        thread_cache& operator = (const thread_cache&) = delete;
+
+        ~thread_cache()
+        {
+            for (unsigned index = 0; index < size_class_pool::CLASSES; ++index)
+            {
+                release(index, m_bins[index].count);
+            }
+            thread_state() = dead;
+        }
+
+        static void* allocate(unsigned index)
+        {
+            const auto cache = local();
+            if (!cache)
+            {
+                return size_class_pool::instance().allocate(index);
+            }
+
+            auto& b = cache->m_bins[index];
+            if (!b.first)
+            {
+                cache->fill(index);
+            }
+
+            const auto block = b.first;
+            b.first = block->next;
+            --b.count;
+            return block;
+        }
+
+        static void deallocate(void* p, unsigned index) noexcept
+        {
+            const auto cache = local();
+            if (!cache)
+            {
+                size_class_pool::instance().deallocate(p, index);
+                return;
+            }
+
+            auto& b = cache->m_bins[index];
+            const auto block = static_cast<free_block*>(p);
+            block->next = b.first;
+            b.first = block;
+            if (++b.count > limit(index))
+            {
+                cache->release(index, b.count / 2);
+            }
+        }
+
+        // Bytes cached by the calling thread
+        static size_t cached_bytes() noexcept
+        {
+            const auto cache = local();
+            size_t bytes = 0;
+            for (unsigned index = 0; cache && index < size_class_pool::CLASSES; ++index)
+            {
+                bytes += cache->m_bins[index].count * size_class_pool::block_size(index);
+            }
+            return bytes;
+        }
+
+        // Gives the calling thread's cache back to the pool
+        static void flush() noexcept
+        {
+            const auto cache = local();
+            for (unsigned index = 0; cache && index < size_class_pool::CLASSES; ++index)
+            {
+                cache->release(index, cache->m_bins[index].count);
+            }
+        }
+
+        // Most blocks of a class a thread keeps
+        static size_t limit(unsigned index) noexcept
+        {
+            const auto blocks = CLASS_BYTES / size_class_pool::block_size(index);
+            return blocks > 2 ? blocks : 2;
+        }
+
+    private:
+        thread_cache() noexcept
+        {
+            thread_state() = alive;
+        }
+
+        static state& thread_state() noexcept
+        {
+            static thread_local state current = unborn;
+            return current;
+        }
+
+        // Null once the thread's cache is destroyed, for blocks freed by
+        // destructors of other thread_local or static objects
+        static thread_cache* local() noexcept
+        {
+            if (thread_state() == dead)
+            {
+                return nullptr;
+            }
+
+            static thread_local thread_cache cache;
+            return &cache;
+        }
+
+        void fill(unsigned index)
+        {
+            const auto half = limit(index) / 2;
+            void* blocks[BATCH];
+            const auto count = size_class_pool::instance().allocate_batch(index, blocks, half < BATCH ? half : BATCH);
+            auto& b = m_bins[index];
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto block = static_cast<free_block*>(blocks[i]);
+                block->next = b.first;
+                b.first = block;
+            }
+            b.count += count;
+        }
+
+        // Gives count blocks of a class back to the pool, BATCH per lock
+        void release(unsigned index, size_t count) noexcept
+        {
+            auto& b = m_bins[index];
+            void* blocks[BATCH];
+            while (count)
+            {
+                size_t taken = 0;
+                for (; taken < BATCH && taken < count; ++taken)
+                {
+                    blocks[taken] = b.first;
+                    b.first = b.first->next;
+                }
+                size_class_pool::instance().deallocate_batch(index, blocks, taken);
+                b.count -= taken;
+                count -= taken;
+            }
+        }
+
+        bin m_bins[size_class_pool::CLASSES];
+    };
+
+    // Stateless allocator like pool_allocator, with thread_cache in front of
+    // the pool, for vectors that are freed and rebuilt at a high rate. A
+    // buffer may be freed by any thread. Buffers above Threshold bytes are
+    // mapped on their own.
+    template<typename T, size_t Threshold = size_t{ 1 } << 15>
+    class thread_cache_allocator
+    {
+        using large_allocator = pool_allocator<T, Threshold>;
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t THRESHOLD = Threshold;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = thread_cache_allocator<U, Threshold>;
+        };
+
+        thread_cache_allocator() noexcept = default;
+
+        template<typename U>
+        thread_cache_allocator(const thread_cache_allocator<U, Threshold>&) noexcept
+        {
+        }
+
+        T* allocate(size_type count)
+        {
+            if (count > std::numeric_limits<size_type>::max() / 2 / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (large_allocator::mapped(bytes))
+            {
+                return large_allocator{}.allocate(count);
+            }
+
+            return static_cast<T*>(thread_cache::allocate(size_class_pool::class_of(bytes, alignof(T))));
+        }
+
+        void deallocate(T* p, size_type count) noexcept
+        {
+            if (!p)
+            {
+                return;
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (large_allocator::mapped(bytes))
+            {
+                large_allocator{}.deallocate(p, count);
+                return;
+            }
+
+            thread_cache::deallocate(p, size_class_pool::class_of(bytes, alignof(T)));
+        }
+    };
+
+    template<typename T, size_t Threshold>
+    constexpr size_t thread_cache_allocator<T, Threshold>::THRESHOLD;
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator == (const thread_cache_allocator<T, Threshold>&, const thread_cache_allocator<U, Threshold>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Threshold>
+    bool operator != (const thread_cache_allocator<T, Threshold>&, const thread_cache_allocator<U, Threshold>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //OMEGA_THREAD_CACHE_ALLOCATOR_HPP
@@ -1,14 +1,25 @@
 #ifndef OMEGA_VECTOR_HPP
 #define OMEGA_VECTOR_HPP
 
+#include "vector_helpers/allocator_alignment.hpp"
+#include "vector_helpers/allocator_expand.hpp"
+#include "vector_helpers/allocator_reallocate.hpp"
+#include "vector_helpers/compare.hpp"
+#include "vector_helpers/hash_bytes.hpp"
+#include "vector_helpers/parallel_construct.hpp"
 #include "vector_helpers/random_access_iterator.hpp"
+#include "vector_helpers/to_address.hpp"
 #include "vector_helpers/vector_helper.hpp"
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <initializer_list>
 #include <stdexcept>
 
 namespace omega
 {
+    struct vector_access;
+
     template<typename T, typename Allocator = std::allocator<T>>
     class vector
     {
@@ -22,8 +33,8 @@ namespace omega
         using const_reference = const value_type&;
         using pointer = typename alloc_traits::pointer;
         using const_pointer = typename alloc_traits::const_pointer;
-        using const_iterator = random_access_iterator<T>;
-        using iterator = random_access_iterator<T, false>;
+        using const_iterator = random_access_iterator<T, true, pointer>;
+        using iterator = random_access_iterator<T, false, pointer>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>; 
         using reverse_iterator = std::reverse_iterator<iterator>; 
 
@@ -222,13 +233,13 @@ namespace omega
 
         void pop_back()
         {
-            alloc_traits::destroy(m_allocator, &m_data[m_size - 1]);
+            alloc_traits::destroy(m_allocator, to_address(m_data + (m_size - 1)));
             --m_size;
         }
 
         void reserve(size_type new_capacity)
         {
-            if (new_capacity <= m_capacity)
+            if (new_capacity <= m_capacity || expand(new_capacity) || reallocate(new_capacity))
             {
                 return;
             }
@@ -250,7 +261,7 @@ namespace omega
             {
                 for (size_type i = 0; i < m_size - count; ++i)
                 {
-                    alloc_traits::destroy(m_allocator, &m_data[count + i]);
+                    alloc_traits::destroy(m_allocator, to_address(m_data + (count + i)));
                 } 
                 m_size = count;
                 return;
@@ -265,7 +276,7 @@ namespace omega
             {
                 for (size_type i = 0; i < m_size - count; ++i)
                 {
-                    alloc_traits::destroy(m_allocator, &m_data[count + i]);
+                    alloc_traits::destroy(m_allocator, to_address(m_data + (count + i)));
                 } 
                 m_size = count;
                 return;
@@ -287,6 +298,88 @@ namespace omega
             swap_data(*this, temp);
         }
 
+        // Parallel versions of the constructors, assign and resize; see
+        // parallel_policy. An exception from any thread destroys everything
+        // built so far and the vector keeps its old buffer. Like the serial
+        // resize, a growing resize moves the old elements out when T's move
+        // constructor is noexcept, so if a fill copy throws they are left
+        // moved-from.
+        template<typename ForwardIt, typename = typename std::iterator_traits<ForwardIt>::iterator_category>
+        vector(const parallel_policy& policy, ForwardIt first, ForwardIt last
+               , const allocator_type& alloc = allocator_type{})
+            : vector{ alloc }
+        {
+            assign(policy, first, last);
+        }
+
+        vector(const parallel_policy& policy, const vector& rhs)
+            : m_allocator{ alloc_traits::select_on_container_copy_construction(rhs.m_allocator) }
+        {
+            assign(policy, rhs.cbegin(), rhs.cend());
+        }
+
+        template<typename ForwardIt, typename = typename std::iterator_traits<ForwardIt>::iterator_category>
+        void assign(const parallel_policy& policy, ForwardIt first, ForwardIt last)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            build_parallel(policy, count, count
+                           , [first](size_type begin, size_type end, parallel_output<T, allocator_type>& output) {
+                auto it = std::next(first, static_cast<difference_type>(begin));
+                for (; begin < end; ++begin, ++it)
+                {
+                    output.construct(*it);
+                }
+            });
+        }
+
+        void assign(const parallel_policy& policy, size_type count, const_reference value)
+        {
+            build_parallel(policy, count, count
+                           , [&value](size_type begin, size_type end, parallel_output<T, allocator_type>& output) {
+                for (; begin < end; ++begin)
+                {
+                    output.construct(value);
+                }
+            });
+        }
+
+        void resize(const parallel_policy& policy, size_type count)
+        {
+            if (count <= m_size)
+            {
+                resize(count);
+                return;
+            }
+
+            resize(policy, count, value_type{});
+        }
+
+        void resize(const parallel_policy& policy, size_type count, const_reference value)
+        {
+            if (count <= m_size)
+            {
+                resize(count, value);
+                return;
+            }
+
+            // value may be one of the elements that other threads move
+            const value_type fill = value;
+            const auto data = m_data;
+            const auto size = m_size;
+            build_parallel(policy, count > m_capacity ? count : m_capacity, count
+                           , [&fill, data, size](size_type begin, size_type end
+                                                 , parallel_output<T, allocator_type>& output) {
+                for (; begin < end && begin < size; ++begin)
+                {
+                    output.construct(std::move_if_noexcept<T>(data[begin]));
+                }
+                for (; begin < end; ++begin)
+                {
+                    output.construct(fill);
+                }
+            });
+        }
+
         void shrink_to_fit()
         {
             if (m_capacity == m_size)
@@ -335,14 +428,16 @@ namespace omega
             return m_data[index];
         }
 
+        // Aligned to allocator_alignment<Allocator>, which the compiler is
+        // told so that loops over the buffer can use aligned loads
         pointer data () noexcept
         {
-            return m_data;
+            return assume_aligned<allocator_alignment<allocator_type>::value>(m_data);
         } 
 
         const_pointer data() const noexcept
         {
-            return m_data;
+            return assume_aligned<allocator_alignment<allocator_type>::value>(m_data);
         }
 
         reference front()
@@ -459,7 +554,7 @@ namespace omega
                 const auto end = m_data + m_size;
                 while(pointer < end)
                 {
-                    alloc_traits::destroy(m_allocator, pointer);
+                    alloc_traits::destroy(m_allocator, to_address(pointer));
                     ++pointer;
                     --m_size;
                 }
@@ -477,7 +572,7 @@ namespace omega
             iterator result{ nullptr };
             for (size_type i = 0; i < m_size; ++i)
             {
-                auto current = iterator { &m_data[i] };
+                auto current = iterator{ m_data + i };
                 if (current < first || current >= last)
                 {
                     const auto pointer = temp.construct(std::move_if_noexcept<T>(m_data[i]));
@@ -511,7 +606,7 @@ namespace omega
         {
             for (size_type i = 0; i < m_size; ++i)
             {
-                alloc_traits::destroy(m_allocator, &m_data[i]);
+                alloc_traits::destroy(m_allocator, to_address(m_data + i));
             }
 
             m_size = 0;
@@ -523,6 +618,8 @@ namespace omega
         }
 
     private:
+        friend struct vector_access;
+
         void move_assign(vector&& rhs) noexcept
         {
             // Constant-time move assignment when source object's memory can be
@@ -563,26 +660,42 @@ namespace omega
         {
             for (size_type i = 0; i < m_size; ++i)
             {
-                alloc_traits::destroy(m_allocator, &m_data[i]);
+                alloc_traits::destroy(m_allocator, to_address(m_data + i));
             }
 
             m_size = 0;
 
-            alloc_traits::deallocate(m_allocator, m_data, ITEM_SIZE * m_capacity);
+            alloc_traits::deallocate(m_allocator, m_data, m_capacity);
             m_capacity = 0;
         }
 
         template <typename... Args>
         pointer push(vector& vec, Args&&... args)
         {
-            alloc_traits::construct(vec.m_allocator, &vec[vec.m_size], std::forward<Args>(args)...); 
+            alloc_traits::construct(vec.m_allocator, to_address(vec.m_data + vec.m_size), std::forward<Args>(args)...);
             ++vec.m_size;
-            return &vec[vec.m_size - 1];
+            return vec.m_data + (vec.m_size - 1);
         }
 
         template <typename... Args>
         void push_back_internal(Args&&... args)
         {
+            if (m_size == m_capacity)
+            {
+                // growing in place leaves args valid even if they refer
+                // into the buffer
+                expand(m_capacity * 2 + 1);
+            }
+
+            if (m_size == m_capacity && allocator_reallocate<allocator_type>::value && m_data)
+            {
+                // args may refer to an element that reallocate moves
+                value_type value( std::forward<Args>(args)... );
+                reserve(m_capacity * 2 + 1);
+                push(*this, std::move(value));
+                return;
+            }
+
             if (m_size == m_capacity)
             {
                 vector_helper<T, allocator_type> temp{ m_allocator };
@@ -606,7 +719,7 @@ namespace omega
             const auto new_capacity = new_size <= m_capacity ? m_capacity : new_size;
             vector_helper<T, allocator_type> temp{ m_allocator };
             temp.allocate(new_capacity);
-            const auto copy_index = pos - iterator{ &m_data[0] };
+            const auto copy_index = pos - cbegin();
 
             for (std::ptrdiff_t i = 0; i < copy_index; ++i)
             {
@@ -636,7 +749,7 @@ namespace omega
             const auto new_capacity = new_size <= m_capacity ? m_capacity : new_size;
             vector_helper<T, allocator_type> temp{ m_allocator };
             temp.allocate(new_capacity);
-            const auto copy_index = pos - iterator{ &m_data[0] };
+            const auto copy_index = pos - cbegin();
 
             for (std::ptrdiff_t i = 0; i < copy_index; ++i)
             {
@@ -664,6 +777,17 @@ namespace omega
         void resize_to_bigger_size(size_type count, const_reference value)
         {
             size_type new_capacity = count > m_capacity ? count : m_capacity;
+            if (allocator_reallocate<allocator_type>::value && m_data)
+            {
+                const value_type fill = value;
+                reserve(new_capacity);
+                for (size_type i = m_size; i < count; ++i)
+                {
+                    push(*this, fill);
+                }
+                return;
+            }
+
             vector_helper<T, allocator_type> temp{ m_allocator };
             temp.allocate(new_capacity);
 
@@ -680,6 +804,49 @@ namespace omega
             swap_data(*this, temp);
         }
 
+        // Grows the buffer where it is through allocator_expand; false when
+        // the allocator cannot
+        bool expand(size_type new_capacity) noexcept
+        {
+            if (!allocator_expand<allocator_type>::value || !m_data
+                || !allocator_expand<allocator_type>::try_expand(m_allocator, m_data, m_capacity, new_capacity))
+            {
+                return false;
+            }
+
+            m_capacity = new_capacity;
+            return true;
+        }
+
+        // Grows the buffer through allocator_reallocate; false when the
+        // allocator cannot, and the caller has to allocate and move
+        bool reallocate(size_type new_capacity)
+        {
+            if (!allocator_reallocate<allocator_type>::value || !m_data)
+            {
+                return false;
+            }
+
+            const auto data = allocator_reallocate<allocator_type>::reallocate(m_allocator, m_data, m_capacity, new_capacity);
+            if (!data)
+            {
+                return false;
+            }
+
+            m_data = data;
+            m_capacity = new_capacity;
+            return true;
+        }
+
+        template<typename Fill>
+        void build_parallel(const parallel_policy& policy, size_type capacity, size_type count, Fill fill)
+        {
+            vector_helper<T, allocator_type> temp{ m_allocator };
+            temp.allocate(capacity);
+            construct_parallel(temp, count, policy.thread_count(), fill);
+            swap_data(*this, temp);
+        }
+
         void swap_data(vector& first, vector_helper<T, allocator_type>& second) noexcept
         {
             std::swap(first.m_data, second.m_data);
@@ -687,12 +854,91 @@ namespace omega
             std::swap(first.m_capacity, second.m_capacity);
         }
 
-        static constexpr size_type ITEM_SIZE = sizeof(T);
         pointer m_data = nullptr;
         size_type m_size = 0;
         size_type m_capacity = 0;
         allocator_type m_allocator = allocator_type{};
     };
+
+    // Integers, enums and pointers compare with memcmp, other types element
+    // by element
+    template<typename T, typename Allocator>
+    bool operator == (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return lhs.size() == rhs.size()
+               && compare::equal(to_address(lhs.data()), to_address(rhs.data()), lhs.size(), is_trivially_comparable<T>{});
+    }
+
+    template<typename T, typename Allocator>
+    bool operator != (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // Lexicographical order; memcmp decides it outright for unsigned bytes
+    // and skips the common prefix of other integers, enums and pointers
+    template<typename T, typename Allocator>
+    bool operator < (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return compare::less(to_address(lhs.data()), lhs.size(), to_address(rhs.data()), rhs.size(), is_bytewise_ordered<T>{});
+    }
+
+    template<typename T, typename Allocator>
+    bool operator > (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template<typename T, typename Allocator>
+    bool operator <= (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template<typename T, typename Allocator>
+    bool operator >= (const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    template<typename T>
+    struct hash;
+
+    // Consistent with ==: the bytes of integers, enums and pointers go
+    // through hash_bytes in one pass, other types mix std::hash<T> of each
+    // element
+    template<typename T, typename Allocator>
+    struct hash<vector<T, Allocator>>
+    {
+        size_t operator()(const vector<T, Allocator>& values) const
+        {
+            return hash_values(values, is_trivially_comparable<T>{});
+        }
+
+    private:
+        static size_t hash_values(const vector<T, Allocator>& values, std::true_type) noexcept
+        {
+            return static_cast<size_t>(hash_bytes::hash(to_address(values.data()), values.size() * sizeof(T)));
+        }
+
+        static size_t hash_values(const vector<T, Allocator>& values, std::false_type)
+        {
+            uint64_t h = hash_bytes::PRIME5 + values.size();
+            for (const auto& value : values)
+            {
+                h = hash_bytes::round(h, std::hash<T>{}(value));
+            }
+            return static_cast<size_t>(hash_bytes::avalanche(h));
+        }
+    };
+}
+
+namespace std
+{
+    template<typename T, typename Allocator>
+    struct hash<omega::vector<T, Allocator>> : omega::hash<omega::vector<T, Allocator>>
+    {
+    };
 }
 
 #endif //OMEGA_VECTOR_HPP
@@ -0,0 +1,48 @@
+#ifndef OMEGA_ALLOCATOR_ALIGNMENT_HPP
+#define OMEGA_ALLOCATOR_ALIGNMENT_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace omega
+{
+    // Alignment an allocator guarantees for its blocks: Allocator::alignment
+    // when it declares one, otherwise alignof(value_type)
+    template<typename Allocator>
+    struct allocator_alignment
+    {
+    private:
+        template<typename A>
+        static std::integral_constant<size_t, A::alignment> declared(int);
+
+        template<typename A>
+        static std::integral_constant<size_t, alignof(typename std::allocator_traits<A>::value_type)> declared(...);
+
+    public:
+        static constexpr size_t value = decltype(declared<Allocator>(0))::value;
+    };
+
+    template<typename Allocator>
+    constexpr size_t allocator_alignment<Allocator>::value;
+
+    // Tells the compiler that p is a multiple of Align so loops over it can
+    // use aligned loads; fancy pointers are returned as they are
+    template<size_t Align, typename T>
+    T* assume_aligned(T* p) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<T*>(__builtin_assume_aligned(p, Align));
+#else
+        return p;
+#endif
+    }
+
+    template<size_t Align, typename Pointer>
+    Pointer assume_aligned(Pointer p) noexcept
+    {
+        return p;
+    }
+}
+
+#endif //OMEGA_ALLOCATOR_ALIGNMENT_HPP
@@ -0,0 +1,53 @@
+#ifndef OMEGA_ALLOCATOR_EXPAND_HPP
+#define OMEGA_ALLOCATOR_EXPAND_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace omega
+{
+    // Grows a block where it is when the allocator has
+    // try_expand(p, old_count, new_count). The hook returns false and leaves
+    // the block alone when it cannot; the block never moves, so it works for
+    // every element type and references into the block stay valid.
+    template<typename Allocator>
+    struct allocator_expand
+    {
+    private:
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using pointer = typename alloc_traits::pointer;
+
+        template<typename A>
+        static auto declared(int) -> decltype(static_cast<bool>(std::declval<A&>().try_expand(std::declval<pointer>()
+                                                                                              , size_t{}, size_t{}))
+                                              , std::true_type{});
+
+        template<typename A>
+        static std::false_type declared(...);
+
+        static bool call(Allocator& alloc, pointer p, size_t old_count, size_t new_count, std::true_type) noexcept
+        {
+            return alloc.try_expand(p, old_count, new_count);
+        }
+
+        static bool call(Allocator&, pointer, size_t, size_t, std::false_type) noexcept
+        {
+            return false;
+        }
+
+    public:
+        static constexpr bool value = decltype(declared<Allocator>(0))::value;
+
+        static bool try_expand(Allocator& alloc, pointer p, size_t old_count, size_t new_count) noexcept
+        {
+            return call(alloc, p, old_count, new_count, std::integral_constant<bool, value>{});
+        }
+    };
+
+    template<typename Allocator>
+    constexpr bool allocator_expand<Allocator>::value;
+}
+
+#endif //OMEGA_ALLOCATOR_EXPAND_HPP
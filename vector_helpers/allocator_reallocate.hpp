@@ -0,0 +1,55 @@
+#ifndef OMEGA_ALLOCATOR_REALLOCATE_HPP
+#define OMEGA_ALLOCATOR_REALLOCATE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace omega
+{
+    // Resizes a block in place of allocate + move + deallocate when the
+    // allocator has reallocate(p, old_count, new_count) and the elements can
+    // be moved with memcpy. The hook returns the block, which may have moved,
+    // or a null pointer when it cannot resize this one; it throws like
+    // allocate when it runs out of memory and then leaves the block as it was.
+    template<typename Allocator>
+    struct allocator_reallocate
+    {
+    private:
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using pointer = typename alloc_traits::pointer;
+        using value_type = typename alloc_traits::value_type;
+
+        template<typename A>
+        static auto declared(int) -> decltype(std::declval<A&>().reallocate(std::declval<pointer>(), size_t{}, size_t{})
+                                              , std::true_type{});
+
+        template<typename A>
+        static std::false_type declared(...);
+
+        static pointer call(Allocator& alloc, pointer p, size_t old_count, size_t new_count, std::true_type)
+        {
+            return alloc.reallocate(p, old_count, new_count);
+        }
+
+        static pointer call(Allocator&, pointer, size_t, size_t, std::false_type) noexcept
+        {
+            return nullptr;
+        }
+
+    public:
+        static constexpr bool value = decltype(declared<Allocator>(0))::value
+                                      && std::is_trivially_copyable<value_type>::value;
+
+        static pointer reallocate(Allocator& alloc, pointer p, size_t old_count, size_t new_count)
+        {
+            return call(alloc, p, old_count, new_count, std::integral_constant<bool, value>{});
+        }
+    };
+
+    template<typename Allocator>
+    constexpr bool allocator_reallocate<Allocator>::value;
+}
+
+#endif //OMEGA_ALLOCATOR_REALLOCATE_HPP
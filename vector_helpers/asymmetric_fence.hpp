@@ -0,0 +1,58 @@
+#ifndef OMEGA_ASYMMETRIC_FENCE_HPP
+#define OMEGA_ASYMMETRIC_FENCE_HPP
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace omega
+{
+    // A pair of fences for a fast side that runs often and a slow side that
+    // runs rarely. On Linux with membarrier the fast side only stops the
+    // compiler, and the slow side makes every thread of the process execute
+    // a full barrier. Elsewhere both sides use a sequentially consistent fence.
+    namespace asymmetric_fence
+    {
+        // Registers the process for expedited membarrier once; false when the
+        // kernel or a sandbox does not allow it
+        inline bool expedited() noexcept
+        {
+#if defined(__linux__) && defined(SYS_membarrier)
+            // MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED
+            static const bool registered = syscall(SYS_membarrier, 1 << 4, 0) == 0;
+            return registered;
+#else
+            return false;
+#endif
+        }
+
+        inline void light() noexcept
+        {
+            if (expedited())
+            {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+            else
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        inline void heavy() noexcept
+        {
+#if defined(__linux__) && defined(SYS_membarrier)
+            // MEMBARRIER_CMD_PRIVATE_EXPEDITED
+            if (expedited() && syscall(SYS_membarrier, 1 << 3, 0) == 0)
+            {
+                return;
+            }
+#endif
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+}
+
+#endif //OMEGA_ASYMMETRIC_FENCE_HPP
@@ -0,0 +1,148 @@
+#ifndef OMEGA_BIT_OPS_HPP
+#define OMEGA_BIT_OPS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace omega
+{
+    namespace bit_ops
+    {
+        inline unsigned popcount(uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+            word = word - ((word >> 1) & 0x5555555555555555ull);
+            word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+            word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        // word must not be zero
+        inline unsigned count_trailing_zeros(uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            unsigned result = 0;
+            while (!(word & 1))
+            {
+                word >>= 1;
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        // Index of the highest set bit, word must not be zero
+        inline unsigned floor_log2(uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return 63 - static_cast<unsigned>(__builtin_clzll(word));
+#else
+            unsigned result = 0;
+            while (word >>= 1)
+            {
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        // Position of the rank-th (0-based) set bit, the word must have more than rank set bits
+        inline unsigned select_in_word(uint64_t word, unsigned rank) noexcept
+        {
+            unsigned offset = 0;
+            for (;;)
+            {
+                const auto byte_count = popcount(word & 0xff);
+                if (rank < byte_count)
+                {
+                    break;
+                }
+                rank -= byte_count;
+                word >>= 8;
+                offset += 8;
+            }
+
+            for (; rank; --rank)
+            {
+                word &= word - 1;
+            }
+            return offset + count_trailing_zeros(word);
+        }
+
+        // Mask with the low `bits` bits set, bits in [0, 64]
+        inline uint64_t low_mask(size_t bits) noexcept
+        {
+            return bits >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << bits) - 1;
+        }
+
+        inline size_t popcount(const uint64_t* words, size_t count) noexcept
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                result += popcount(words[i]);
+            }
+            return result;
+        }
+
+        // dst[i] = dst[i] op src[i] for the whole range, two words per SSE2 lane
+        template<typename ScalarOp, typename VectorOp>
+        inline void combine(uint64_t* dst, const uint64_t* src, size_t count, ScalarOp scalar_op, VectorOp vector_op) noexcept
+        {
+            size_t i = 0;
+#if defined(__SSE2__)
+            for (; i + 2 <= count; i += 2)
+            {
+                const auto lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                const auto rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), vector_op(lhs, rhs));
+            }
+#else
+            (void)vector_op;
+#endif
+            for (; i < count; ++i)
+            {
+                dst[i] = scalar_op(dst[i], src[i]);
+            }
+        }
+
+#if defined(__SSE2__)
+        struct sse2_and { __m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_and_si128(a, b); } };
+        struct sse2_or { __m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_or_si128(a, b); } };
+        struct sse2_xor { __m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_xor_si128(a, b); } };
+#else
+        struct sse2_and {};
+        struct sse2_or {};
+        struct sse2_xor {};
+#endif
+        struct scalar_and { uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a & b; } };
+        struct scalar_or { uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a | b; } };
+        struct scalar_xor { uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a ^ b; } };
+
+        inline void and_words(uint64_t* dst, const uint64_t* src, size_t count) noexcept
+        {
+            combine(dst, src, count, scalar_and{}, sse2_and{});
+        }
+
+        inline void or_words(uint64_t* dst, const uint64_t* src, size_t count) noexcept
+        {
+            combine(dst, src, count, scalar_or{}, sse2_or{});
+        }
+
+        inline void xor_words(uint64_t* dst, const uint64_t* src, size_t count) noexcept
+        {
+            combine(dst, src, count, scalar_xor{}, sse2_xor{});
+        }
+    }
+}
+
+#endif //OMEGA_BIT_OPS_HPP
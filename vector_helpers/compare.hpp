@@ -0,0 +1,70 @@
+#ifndef OMEGA_COMPARE_HPP
+#define OMEGA_COMPARE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace omega
+{
+    // Types whose values are equal exactly when their bytes are: integers,
+    // enums and pointers. Floating point is not (-0.0 == 0.0, NaN != NaN)
+    // and neither are classes, which may have padding.
+    template<typename T>
+    struct is_trivially_comparable
+        : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value
+                                       || std::is_pointer<T>::value>
+    {
+    };
+
+    // Types for which memcmp order is the < order
+    template<typename T>
+    struct is_bytewise_ordered
+        : std::integral_constant<bool, std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == 1>
+    {
+    };
+
+    namespace compare
+    {
+        template<typename T>
+        bool equal(const T* lhs, const T* rhs, size_t count, std::true_type) noexcept
+        {
+            return count == 0 || std::memcmp(lhs, rhs, count * sizeof(T)) == 0;
+        }
+
+        template<typename T>
+        bool equal(const T* lhs, const T* rhs, size_t count, std::false_type)
+        {
+            return std::equal(lhs, lhs + count, rhs);
+        }
+
+        template<typename T>
+        bool less(const T* lhs, size_t lhs_count, const T* rhs, size_t rhs_count, std::true_type) noexcept
+        {
+            const auto count = lhs_count < rhs_count ? lhs_count : rhs_count;
+            const auto order = count ? std::memcmp(lhs, rhs, count) : 0;
+            return order ? order < 0 : lhs_count < rhs_count;
+        }
+
+        // Skips the equal prefix a cache line at a time with memcmp, then
+        // compares the elements from the first block that differs
+        template<typename T>
+        bool less(const T* lhs, size_t lhs_count, const T* rhs, size_t rhs_count, std::false_type)
+        {
+            const auto count = lhs_count < rhs_count ? lhs_count : rhs_count;
+            size_t start = 0;
+            if (is_trivially_comparable<T>::value)
+            {
+                const size_t block = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+                while (start + block <= count && std::memcmp(lhs + start, rhs + start, block * sizeof(T)) == 0)
+                {
+                    start += block;
+                }
+            }
+            return std::lexicographical_compare(lhs + start, lhs + lhs_count, rhs + start, rhs + rhs_count);
+        }
+    }
+}
+
+#endif //OMEGA_COMPARE_HPP
@@ -0,0 +1,90 @@
+#ifndef OMEGA_FD_IO_HPP
+#define OMEGA_FD_IO_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace omega
+{
+    // Blocking reads and writes that retry on EINTR and short transfers, as
+    // pipes and sockets return them
+    namespace fd_io
+    {
+        // Writes every buffer in order; the iovec array is used as scratch
+        inline void write_all(int fd, iovec* buffers, int count)
+        {
+            while (count > 0)
+            {
+                const auto written = ::writev(fd, buffers, count);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "writev");
+                }
+
+                auto left = static_cast<size_t>(written);
+                while (count > 0 && left >= buffers->iov_len)
+                {
+                    left -= buffers->iov_len;
+                    ++buffers;
+                    --count;
+                }
+                if (count > 0)
+                {
+                    buffers->iov_base = static_cast<char*>(buffers->iov_base) + left;
+                    buffers->iov_len -= left;
+                }
+            }
+        }
+
+        // Returns fewer than bytes only at end of file
+        inline size_t read_all(int fd, void* buffer, size_t bytes)
+        {
+            size_t done = 0;
+            while (done < bytes)
+            {
+                const auto got = ::read(fd, static_cast<char*>(buffer) + done, bytes - done);
+                if (got < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "read");
+                }
+                if (got == 0)
+                {
+                    break;
+                }
+                done += static_cast<size_t>(got);
+            }
+
+            return done;
+        }
+
+        // Whether fd is a regular file with at least bytes left past its
+        // offset, so a read of that many bytes cannot come up short
+        inline bool holds(int fd, size_t bytes)
+        {
+            struct stat info;
+            if (::fstat(fd, &info) || !S_ISREG(info.st_mode))
+            {
+                return false;
+            }
+
+            const auto offset = ::lseek(fd, 0, SEEK_CUR);
+            return offset >= 0 && offset <= info.st_size && static_cast<uint64_t>(info.st_size - offset) >= bytes;
+        }
+    }
+}
+
+#endif //OMEGA_FD_IO_HPP
@@ -0,0 +1,179 @@
+#ifndef OMEGA_FLAT_MAP_ITERATOR_HPP
+#define OMEGA_FLAT_MAP_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace omega
+{
+    // Random access iterator over parallel key and value arrays. Dereferencing
+    // yields a pair of references, so the iterator is a proxy iterator.
+    template<typename Key, typename T, bool is_const_iter = true>
+    class flat_map_iterator
+    {
+        typedef typename std::conditional<is_const_iter, const T*
+                            , T*>::type ValuePointerType;
+        typedef typename std::conditional<is_const_iter, const T&
+                            , T&>::type ValueReferenceType;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, ValueReferenceType>;
+
+        // operator -> has to return something that owns the pair of references
+        class pointer
+        {
+        public:
+            explicit pointer(const reference& ref)
+                : m_ref{ ref }
+            {
+            }
+
+            const reference* operator -> () const noexcept
+            {
+                return &m_ref;
+            }
+
+        private:
+            reference m_ref;
+        };
+
+        flat_map_iterator(const Key* keys, ValuePointerType values, difference_type index) noexcept
+            : m_keys{ keys }
+            , m_values{ values }
+            , m_index{ index }
+        {
+        }
+
+        flat_map_iterator(const flat_map_iterator<Key, T, false>& rhs) noexcept
+            : m_keys{ rhs.m_keys }
+            , m_values{ rhs.m_values }
+            , m_index{ rhs.m_index }
+        {
+        }
+
+        flat_map_iterator& operator = (const flat_map_iterator&) = default;
+
+        reference operator * () const
+        {
+            return reference{ m_keys[m_index], m_values[m_index] };
+        }
+
+        pointer operator -> () const
+        {
+            return pointer{ **this };
+        }
+
+        reference operator [] (difference_type n) const
+        {
+            return reference{ m_keys[m_index + n], m_values[m_index + n] };
+        }
+
+        difference_type index() const noexcept
+        {
+            return m_index;
+        }
+
+        flat_map_iterator& operator -- () noexcept
+        {
+            --m_index;
+            return *this;
+        }
+
+        flat_map_iterator operator -- (int) noexcept
+        {
+            auto old{ *this };
+            --(*this);
+            return old;
+        }
+
+        flat_map_iterator& operator ++ () noexcept
+        {
+            ++m_index;
+            return *this;
+        }
+
+        flat_map_iterator operator ++ (int) noexcept
+        {
+            auto old{ *this };
+            ++(*this);
+            return old;
+        }
+
+        flat_map_iterator& operator += (difference_type n) noexcept
+        {
+            m_index += n;
+            return *this;
+        }
+
+        flat_map_iterator& operator -= (difference_type n) noexcept
+        {
+            m_index -= n;
+            return *this;
+        }
+
+    private:
+
+        friend flat_map_iterator<Key, T>;
+
+        friend bool operator == (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend bool operator != (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator < (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index < rhs.m_index;
+        }
+
+        friend bool operator <= (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index <= rhs.m_index;
+        }
+
+        friend bool operator > (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index > rhs.m_index;
+        }
+
+        friend bool operator >= (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index >= rhs.m_index;
+        }
+
+        friend flat_map_iterator operator + (const flat_map_iterator& iter, difference_type n) noexcept
+        {
+            return flat_map_iterator{ iter.m_keys, iter.m_values, iter.m_index + n };
+        }
+
+        friend flat_map_iterator operator + (difference_type n, const flat_map_iterator& iter) noexcept
+        {
+            return flat_map_iterator{ iter.m_keys, iter.m_values, iter.m_index + n };
+        }
+
+        friend flat_map_iterator operator - (const flat_map_iterator& iter, difference_type n) noexcept
+        {
+            return flat_map_iterator{ iter.m_keys, iter.m_values, iter.m_index - n };
+        }
+
+        friend difference_type operator - (const flat_map_iterator& lhs, const flat_map_iterator& rhs) noexcept
+        {
+            return lhs.m_index - rhs.m_index;
+        }
+
+        const Key* m_keys;
+        ValuePointerType m_values;
+        difference_type m_index;
+    };
+}
+
+#endif //OMEGA_FLAT_MAP_ITERATOR_HPP
@@ -0,0 +1,108 @@
+#ifndef OMEGA_HASH_BYTES_HPP
+#define OMEGA_HASH_BYTES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace omega
+{
+    // 64-bit hash of a byte range (the xxHash64 algorithm). Blocks of 32
+    // bytes feed four independent lanes, which keeps the multipliers busy
+    // and lets the compiler use vector registers for them. Words are read
+    // little-endian, so big-endian machines get other values.
+    namespace hash_bytes
+    {
+        constexpr uint64_t PRIME1 = 11400714785074694791ull;
+        constexpr uint64_t PRIME2 = 14029467366897019727ull;
+        constexpr uint64_t PRIME3 = 1609587929392839161ull;
+        constexpr uint64_t PRIME4 = 9650029242287828579ull;
+        constexpr uint64_t PRIME5 = 2870177450012600261ull;
+
+        inline uint64_t rotl(uint64_t value, unsigned bits) noexcept
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        inline uint64_t read64(const unsigned char* bytes) noexcept
+        {
+            uint64_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t read32(const unsigned char* bytes) noexcept
+        {
+            uint32_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t round(uint64_t acc, uint64_t input) noexcept
+        {
+            return rotl(acc + input * PRIME2, 31) * PRIME1;
+        }
+
+        inline uint64_t merge(uint64_t acc, uint64_t lane) noexcept
+        {
+            return (acc ^ round(0, lane)) * PRIME1 + PRIME4;
+        }
+
+        // Spreads every input bit over the whole result
+        inline uint64_t avalanche(uint64_t h) noexcept
+        {
+            h ^= h >> 33;
+            h *= PRIME2;
+            h ^= h >> 29;
+            h *= PRIME3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        inline uint64_t hash(const void* data, size_t size, uint64_t seed = 0) noexcept
+        {
+            auto bytes = static_cast<const unsigned char*>(data);
+            const auto end = bytes + size;
+            uint64_t h;
+            if (size >= 32)
+            {
+                uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+                for (; bytes + 32 <= end; bytes += 32)
+                {
+                    for (unsigned lane = 0; lane < 4; ++lane)
+                    {
+                        lanes[lane] = round(lanes[lane], read64(bytes + 8 * lane));
+                    }
+                }
+                h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+                for (unsigned lane = 0; lane < 4; ++lane)
+                {
+                    h = merge(h, lanes[lane]);
+                }
+            }
+            else
+            {
+                h = seed + PRIME5;
+            }
+
+            h += size;
+            for (; bytes + 8 <= end; bytes += 8)
+            {
+                h = rotl(h ^ round(0, read64(bytes)), 27) * PRIME1 + PRIME4;
+            }
+            if (bytes + 4 <= end)
+            {
+                h = rotl(h ^ (read32(bytes) * PRIME1), 23) * PRIME2 + PRIME3;
+                bytes += 4;
+            }
+            for (; bytes < end; ++bytes)
+            {
+                h = rotl(h ^ (*bytes * PRIME5), 11) * PRIME1;
+            }
+
+            return avalanche(h);
+        }
+    }
+}
+
+#endif //OMEGA_HASH_BYTES_HPP
@@ -0,0 +1,29 @@
+#ifndef OMEGA_INDEX_SEQUENCE_HPP
+#define OMEGA_INDEX_SEQUENCE_HPP
+
+#include <cstddef>
+
+namespace omega
+{
+    // C++11 stand-in for std::index_sequence
+    template<size_t... Is>
+    struct index_sequence
+    {
+    };
+
+    template<size_t N, size_t... Is>
+    struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, Is...>
+    {
+    };
+
+    template<size_t... Is>
+    struct make_index_sequence_impl<0, Is...>
+    {
+        using type = index_sequence<Is...>;
+    };
+
+    template<size_t N>
+    using make_index_sequence = typename make_index_sequence_impl<N>::type;
+}
+
+#endif //OMEGA_INDEX_SEQUENCE_HPP
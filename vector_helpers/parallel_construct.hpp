@@ -0,0 +1,164 @@
+#ifndef OMEGA_PARALLEL_CONSTRUCT_HPP
+#define OMEGA_PARALLEL_CONSTRUCT_HPP
+
+#include "to_address.hpp"
+#include "vector_helper.hpp"
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace omega
+{
+    // Selects the overloads of omega::vector that construct elements on
+    // several threads. Each thread writes its own part of the new buffer
+    // first, so on NUMA machines the pages land next to the thread that
+    // built them.
+    struct parallel_policy
+    {
+        // 0 uses every hardware thread
+        unsigned threads;
+
+        unsigned thread_count() const noexcept
+        {
+            const auto count = threads ? threads : std::thread::hardware_concurrency();
+            return count ? count : 1;
+        }
+    };
+
+    constexpr parallel_policy parallel{ 0 };
+
+    // Constructs consecutive elements of one chunk and counts them, so that
+    // a chunk that fails can be unwound together with the others
+    template<typename T, typename Allocator>
+    class parallel_output
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+    public:
+        using pointer = typename alloc_traits::pointer;
+        using size_type = size_t;
+
+        parallel_output() noexcept = default;
+
+        parallel_output(Allocator& alloc, pointer next) noexcept
+            : m_allocator{ &alloc }
+            , m_next{ next }
+        {
+        }
+
+        template<typename... Args>
+        void construct(Args&&... args)
+        {
+            alloc_traits::construct(*m_allocator, to_address(m_next), std::forward<Args>(args)...);
+            ++m_next;
+            ++m_built;
+        }
+
+        size_type built() const noexcept
+        {
+            return m_built;
+        }
+
+    private:
+        Allocator* m_allocator = nullptr;
+        pointer m_next = nullptr;
+        size_type m_built = 0;
+    };
+
+    // Smallest chunk worth a thread of its own
+    constexpr size_t PARALLEL_GRAIN = 4096;
+
+    // Appends count elements to target, which must have the capacity for
+    // them. [0, count) is split into at most `threads` chunks and
+    // fill(first, last, output) constructs elements first to last - 1 in
+    // order through output.construct(...). The calling thread fills the last
+    // chunk; a chunk whose thread cannot be started runs on the calling
+    // thread too. If any chunk throws, every element built so far is
+    // destroyed and the first exception is rethrown. The allocator must be
+    // safe to call from several threads.
+    template<typename T, typename Allocator, typename Fill>
+    void construct_parallel(vector_helper<T, Allocator>& target, size_t count, unsigned threads, Fill fill)
+    {
+        struct chunk
+        {
+            size_t first = 0;
+            size_t last = 0;
+            parallel_output<T, Allocator> output;
+            std::exception_ptr error;
+        };
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        size_t chunks = count / PARALLEL_GRAIN;
+        chunks = chunks < threads ? chunks : threads;
+        chunks = chunks ? chunks : 1;
+
+        std::unique_ptr<chunk[]> parts{ new chunk[chunks] };
+        for (size_t k = 0; k < chunks; ++k)
+        {
+            parts[k].first = count / chunks * k;
+            parts[k].last = k + 1 == chunks ? count : count / chunks * (k + 1);
+            parts[k].output = parallel_output<T, Allocator>{ target.m_allocator
+                                                             , target.m_data + (target.m_size + parts[k].first) };
+        }
+
+        auto run = [&parts, &fill](size_t k) {
+            try
+            {
+                fill(parts[k].first, parts[k].last, parts[k].output);
+            }
+            catch (...)
+            {
+                parts[k].error = std::current_exception();
+            }
+        };
+
+        {
+            std::unique_ptr<std::thread[]> workers{ new std::thread[chunks - 1] };
+            for (size_t k = 0; k + 1 < chunks; ++k)
+            {
+                try
+                {
+                    workers[k] = std::thread{ run, k };
+                }
+                catch (...)
+                {
+                    run(k);
+                }
+            }
+            run(chunks - 1);
+            for (size_t k = 0; k + 1 < chunks; ++k)
+            {
+                if (workers[k].joinable())
+                {
+                    workers[k].join();
+                }
+            }
+        }
+
+        for (size_t k = 0; k < chunks; ++k)
+        {
+            if (!parts[k].error)
+            {
+                continue;
+            }
+
+            for (size_t part = 0; part < chunks; ++part)
+            {
+                for (size_t i = 0; i < parts[part].output.built(); ++i)
+                {
+                    std::allocator_traits<Allocator>::destroy(target.m_allocator
+                                                              , to_address(target.m_data + (target.m_size + parts[part].first + i)));
+                }
+            }
+            std::rethrow_exception(parts[k].error);
+        }
+
+        target.m_size += count;
+    }
+}
+
+#endif //OMEGA_PARALLEL_CONSTRUCT_HPP
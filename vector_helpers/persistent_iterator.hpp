@@ -0,0 +1,162 @@
+#ifndef OMEGA_PERSISTENT_ITERATOR_HPP
+#define OMEGA_PERSISTENT_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+
+namespace omega
+{
+    // Random access iterator over a persistent_vector. It caches the leaf it
+    // points into, so stepping through a leaf is a pointer increment and the
+    // tree is only searched again when the iterator crosses into another leaf.
+    template<typename Vector>
+    class persistent_iterator
+    {
+        using size_type = typename Vector::size_type;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename Vector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        persistent_iterator(const Vector* owner, size_type index) noexcept
+            : m_owner{ owner }
+            , m_index{ index }
+        {
+            seek();
+        }
+
+        reference operator * () const
+        {
+            return m_leaf[m_index - m_leaf_first];
+        }
+
+        pointer operator -> () const
+        {
+            return &**this;
+        }
+
+        reference operator [] (difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        persistent_iterator& operator -- () noexcept
+        {
+            --m_index;
+            seek();
+            return *this;
+        }
+
+        persistent_iterator operator -- (int) noexcept
+        {
+            auto old{ *this };
+            --(*this);
+            return old;
+        }
+
+        persistent_iterator& operator ++ () noexcept
+        {
+            ++m_index;
+            seek();
+            return *this;
+        }
+
+        persistent_iterator operator ++ (int) noexcept
+        {
+            auto old{ *this };
+            ++(*this);
+            return old;
+        }
+
+        persistent_iterator& operator += (difference_type n) noexcept
+        {
+            m_index += n;
+            seek();
+            return *this;
+        }
+
+        persistent_iterator& operator -= (difference_type n) noexcept
+        {
+            m_index -= n;
+            seek();
+            return *this;
+        }
+
+    private:
+        void seek() noexcept
+        {
+            if (m_index - m_leaf_first < m_leaf_size || m_index >= m_owner->size())
+            {
+                return;
+            }
+
+            const auto chunk = m_owner->chunk_at(m_index);
+            m_leaf = chunk.first.data();
+            m_leaf_size = chunk.first.size();
+            m_leaf_first = chunk.second;
+        }
+
+        friend bool operator == (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend bool operator != (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator < (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return lhs.m_index < rhs.m_index;
+        }
+
+        friend bool operator <= (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return lhs.m_index <= rhs.m_index;
+        }
+
+        friend bool operator > (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return lhs.m_index > rhs.m_index;
+        }
+
+        friend bool operator >= (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return lhs.m_index >= rhs.m_index;
+        }
+
+        friend persistent_iterator operator + (const persistent_iterator& iter, difference_type n) noexcept
+        {
+            auto result{ iter };
+            return result += n;
+        }
+
+        friend persistent_iterator operator + (difference_type n, const persistent_iterator& iter) noexcept
+        {
+            return iter + n;
+        }
+
+        friend persistent_iterator operator - (const persistent_iterator& iter, difference_type n) noexcept
+        {
+            auto result{ iter };
+            return result -= n;
+        }
+
+        friend difference_type operator - (const persistent_iterator& lhs, const persistent_iterator& rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.m_index - rhs.m_index);
+        }
+
+        const Vector* m_owner;
+        size_type m_index;
+        const value_type* m_leaf = nullptr;
+        size_type m_leaf_first = 0;
+        size_type m_leaf_size = 0;
+    };
+}
+
+#endif //OMEGA_PERSISTENT_ITERATOR_HPP
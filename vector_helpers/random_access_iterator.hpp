@@ -3,14 +3,18 @@
 
 #include <utility>
 #include <iterator>
+#include <memory>
 
 namespace omega
 {
-    template<typename T, bool is_const_iter = true>
+    // Pointer is the container's pointer type, which may be a fancy pointer
+    // such as an offset pointer; the const iterator rebinds it to const T
+    template<typename T, bool is_const_iter = true, typename Pointer = T*>
     class random_access_iterator
     {
-        typedef typename std::conditional<is_const_iter, const T*
-                            , T*>::type ValuePointerType;
+        typedef typename std::conditional<is_const_iter
+                            , typename std::pointer_traits<Pointer>::template rebind<const T>
+                            , Pointer>::type ValuePointerType;
         typedef typename std::conditional<is_const_iter, const T&
                             , T&>::type ValueReferenceType;
 
@@ -26,7 +30,7 @@ namespace omega
         {
         }
 
-        random_access_iterator(const random_access_iterator<T, false>& rhs)
+        random_access_iterator(const random_access_iterator<T, false, Pointer>& rhs)
             : m_pointer{ rhs.m_pointer }
         {
         }
@@ -86,7 +90,7 @@ namespace omega
 
     private:
 
-        friend random_access_iterator<T>;
+        friend random_access_iterator<T, true, Pointer>;
 
         friend bool operator == (const random_access_iterator& lhs, const random_access_iterator& rhs) noexcept
         {
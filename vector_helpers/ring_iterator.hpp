@@ -0,0 +1,165 @@
+#ifndef OMEGA_RING_ITERATOR_HPP
+#define OMEGA_RING_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace omega
+{
+    // Random access iterator over a power-of-two ring. The position keeps
+    // counting past the end of the buffer and is wrapped with the mask on
+    // dereference, so iterators compare and subtract like plain indices.
+    template<typename T, bool is_const_iter = true>
+    class ring_iterator
+    {
+        typedef typename std::conditional<is_const_iter, const T*
+                            , T*>::type ValuePointerType;
+        typedef typename std::conditional<is_const_iter, const T&
+                            , T&>::type ValueReferenceType;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValuePointerType;
+        using reference = ValueReferenceType;
+
+        ring_iterator(ValuePointerType data, size_t mask, size_t position) noexcept
+            : m_data{ data }
+            , m_mask{ mask }
+            , m_position{ position }
+        {
+        }
+
+        ring_iterator(const ring_iterator<T, false>& rhs) noexcept
+            : m_data{ rhs.m_data }
+            , m_mask{ rhs.m_mask }
+            , m_position{ rhs.m_position }
+        {
+        }
+
+        ring_iterator& operator = (const ring_iterator&) = default;
+
+        ValueReferenceType operator * () const
+        {
+            return m_data[m_position & m_mask];
+        }
+
+        ValuePointerType operator -> () const
+        {
+            return &m_data[m_position & m_mask];
+        }
+
+        ValueReferenceType operator [] (difference_type n) const
+        {
+            return m_data[(m_position + n) & m_mask];
+        }
+
+        ring_iterator& operator -- () noexcept
+        {
+            --m_position;
+            return *this;
+        }
+
+        ring_iterator operator -- (int) noexcept
+        {
+            auto old{ *this };
+            --(*this);
+            return old;
+        }
+
+        ring_iterator& operator ++ () noexcept
+        {
+            ++m_position;
+            return *this;
+        }
+
+        ring_iterator operator ++ (int) noexcept
+        {
+            auto old{ *this };
+            ++(*this);
+            return old;
+        }
+
+        ring_iterator& operator += (difference_type n) noexcept
+        {
+            m_position += n;
+            return *this;
+        }
+
+        ring_iterator& operator -= (difference_type n) noexcept
+        {
+            m_position -= n;
+            return *this;
+        }
+
+        void swap(ring_iterator& rhs) noexcept
+        {
+            std::swap(m_data, rhs.m_data);
+            std::swap(m_mask, rhs.m_mask);
+            std::swap(m_position, rhs.m_position);
+        }
+
+    private:
+
+        friend ring_iterator<T>;
+
+        friend bool operator == (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return lhs.m_position == rhs.m_position;
+        }
+
+        friend bool operator != (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator < (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return lhs.m_position < rhs.m_position;
+        }
+
+        friend bool operator <= (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return lhs.m_position <= rhs.m_position;
+        }
+
+        friend bool operator > (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return lhs.m_position > rhs.m_position;
+        }
+
+        friend bool operator >= (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return lhs.m_position >= rhs.m_position;
+        }
+
+        friend ring_iterator operator + (const ring_iterator& iter, difference_type n) noexcept
+        {
+            return ring_iterator{ iter.m_data, iter.m_mask, iter.m_position + n };
+        }
+
+        friend ring_iterator operator + (difference_type n, const ring_iterator& iter) noexcept
+        {
+            return ring_iterator{ iter.m_data, iter.m_mask, iter.m_position + n };
+        }
+
+        friend ring_iterator operator - (const ring_iterator& iter, difference_type n) noexcept
+        {
+            return ring_iterator{ iter.m_data, iter.m_mask, iter.m_position - n };
+        }
+
+        friend difference_type operator - (const ring_iterator& lhs, const ring_iterator& rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.m_position - rhs.m_position);
+        }
+
+        ValuePointerType m_data;
+        size_t m_mask;
+        size_t m_position;
+    };
+}
+
+#endif //OMEGA_RING_ITERATOR_HPP
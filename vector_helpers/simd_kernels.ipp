@@ -0,0 +1,179 @@
+// Kernels of simd_algorithm.hpp for one vector width. The header includes
+// this file once per instruction set, inside a #pragma GCC target region,
+// with OMEGA_SIMD_NAMESPACE and OMEGA_SIMD_BYTES set; the bodies have to be
+// compiled under that target for the vectors to use its registers.
+// No include guard on purpose.
+
+namespace OMEGA_SIMD_NAMESPACE
+{
+    constexpr size_t BYTES = OMEGA_SIMD_BYTES;
+
+    // Blocks of four vectors between flushes of the per-lane match counters
+    constexpr size_t COUNT_FLUSH = size_t{ 1 } << 20;
+
+    template<typename T>
+    struct lanes
+    {
+        typedef T vector_type __attribute__((vector_size(BYTES)));
+        typedef uint64_t word_type __attribute__((vector_size(BYTES)));
+
+        static constexpr size_t COUNT = BYTES / sizeof(T);
+
+        static vector_type load(const T* data) noexcept
+        {
+            vector_type result;
+            std::memcpy(&result, data, BYTES);
+            return result;
+        }
+
+        static vector_type splat(T value) noexcept
+        {
+            vector_type result;
+            for (size_t j = 0; j < COUNT; ++j)
+            {
+                result[j] = value;
+            }
+            return result;
+        }
+
+        template<typename Mask>
+        static bool any(const Mask& mask) noexcept
+        {
+            word_type words;
+            std::memcpy(&words, &mask, BYTES);
+            uint64_t result = 0;
+            for (size_t j = 0; j < BYTES / 8; ++j)
+            {
+                result |= words[j];
+            }
+            return result != 0;
+        }
+    };
+
+    template<typename T>
+    size_t find(const T* data, size_t count, T value) noexcept
+    {
+        using v = lanes<T>;
+        const auto needle = v::splat(value);
+        size_t i = 0;
+        for (; i + 4 * v::COUNT <= count; i += 4 * v::COUNT)
+        {
+            const auto hits = (v::load(data + i) == needle) | (v::load(data + i + v::COUNT) == needle)
+                              | (v::load(data + i + 2 * v::COUNT) == needle)
+                              | (v::load(data + i + 3 * v::COUNT) == needle);
+            if (v::any(hits))
+            {
+                break;
+            }
+        }
+        return i + scalar::find(data + i, count - i, value);
+    }
+
+    template<typename T>
+    size_t count(const T* data, size_t count, T value) noexcept
+    {
+        using v = lanes<T>;
+        const auto needle = v::splat(value);
+        size_t total = 0;
+        size_t i = 0;
+        while (i + 4 * v::COUNT <= count)
+        {
+            // match lanes are -1, so subtracting them counts
+            decltype(needle == needle) hits = {};
+            for (size_t blocks = 0; blocks < COUNT_FLUSH && i + 4 * v::COUNT <= count; ++blocks, i += 4 * v::COUNT)
+            {
+                hits -= v::load(data + i) == needle;
+                hits -= v::load(data + i + v::COUNT) == needle;
+                hits -= v::load(data + i + 2 * v::COUNT) == needle;
+                hits -= v::load(data + i + 3 * v::COUNT) == needle;
+            }
+            for (size_t j = 0; j < v::COUNT; ++j)
+            {
+                total += static_cast<size_t>(hits[j]);
+            }
+        }
+        return total + scalar::count(data + i, count - i, value);
+    }
+
+    // count must not be 0
+    template<bool Min, bool Max, typename T>
+    void extremes(const T* data, size_t count, T& low, T& high) noexcept
+    {
+        using v = lanes<T>;
+        if (count < v::COUNT)
+        {
+            scalar::extremes<Min, Max>(data, count, low, high);
+            return;
+        }
+
+        auto lo = v::load(data);
+        auto hi = lo;
+        size_t i = v::COUNT;
+        for (; i + v::COUNT <= count; i += v::COUNT)
+        {
+            const auto values = v::load(data + i);
+            if (Min)
+            {
+                lo = values < lo ? values : lo;
+            }
+            if (Max)
+            {
+                hi = hi < values ? values : hi;
+            }
+        }
+
+        // the last, partial vector overlaps values already seen
+        if (i < count)
+        {
+            const auto values = v::load(data + count - v::COUNT);
+            if (Min)
+            {
+                lo = values < lo ? values : lo;
+            }
+            if (Max)
+            {
+                hi = hi < values ? values : hi;
+            }
+        }
+
+        low = lo[0];
+        high = hi[0];
+        for (size_t j = 1; j < v::COUNT; ++j)
+        {
+            if (Min && lo[j] < low)
+            {
+                low = lo[j];
+            }
+            if (Max && high < hi[j])
+            {
+                high = hi[j];
+            }
+        }
+    }
+
+    // Four accumulators hide the latency of floating point adds
+    template<typename T>
+    T sum(const T* data, size_t count) noexcept
+    {
+        using S = typename sum_type<T>::type;
+        using v = lanes<S>;
+        const auto values = reinterpret_cast<const S*>(data);
+        typename v::vector_type acc[4] = {};
+        size_t i = 0;
+        for (; i + 4 * v::COUNT <= count; i += 4 * v::COUNT)
+        {
+            acc[0] += v::load(values + i);
+            acc[1] += v::load(values + i + v::COUNT);
+            acc[2] += v::load(values + i + 2 * v::COUNT);
+            acc[3] += v::load(values + i + 3 * v::COUNT);
+        }
+
+        const auto all = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        S total = 0;
+        for (size_t j = 0; j < v::COUNT; ++j)
+        {
+            total += all[j];
+        }
+        return static_cast<T>(total + static_cast<S>(scalar::sum(data + i, count - i)));
+    }
+}
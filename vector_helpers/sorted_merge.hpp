@@ -0,0 +1,53 @@
+#ifndef OMEGA_SORTED_MERGE_HPP
+#define OMEGA_SORTED_MERGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+namespace omega
+{
+    // Stable merge of the sorted runs [first, middle) and [middle, last) of
+    // keys without a temporary buffer (the rotation scheme std::inplace_merge
+    // falls back to). rotate(first, middle, last) must rotate every parallel
+    // array the same way, which lets flat_map move keys and values together.
+    template<typename Key, typename Compare, typename Rotate>
+    void merge_sorted_runs(const Key* keys, size_t first, size_t middle, size_t last
+                           , Compare comp, Rotate rotate)
+    {
+        if (first == middle || middle == last)
+        {
+            return;
+        }
+
+        const auto len1 = middle - first;
+        const auto len2 = last - middle;
+        if (len1 + len2 == 2)
+        {
+            if (comp(keys[middle], keys[first]))
+            {
+                rotate(first, middle, last);
+            }
+            return;
+        }
+
+        size_t cut1 = 0;
+        size_t cut2 = 0;
+        if (len1 > len2)
+        {
+            cut1 = first + len1 / 2;
+            cut2 = static_cast<size_t>(std::lower_bound(keys + middle, keys + last, keys[cut1], comp) - keys);
+        }
+        else
+        {
+            cut2 = middle + len2 / 2;
+            cut1 = static_cast<size_t>(std::upper_bound(keys + first, keys + middle, keys[cut2], comp) - keys);
+        }
+
+        rotate(cut1, middle, cut2);
+        const auto new_middle = cut1 + (cut2 - middle);
+        merge_sorted_runs(keys, first, cut1, new_middle, comp, rotate);
+        merge_sorted_runs(keys, new_middle, cut2, last, comp, rotate);
+    }
+}
+
+#endif //OMEGA_SORTED_MERGE_HPP
@@ -0,0 +1,65 @@
+#ifndef OMEGA_SPAN_HPP
+#define OMEGA_SPAN_HPP
+
+#include <cstddef>
+
+namespace omega
+{
+    // Non-owning view of a contiguous range. Iterators are raw pointers so
+    // loops over a span stay friendly to the auto-vectorizer.
+    template<typename T>
+    class span
+    {
+    public:
+        using element_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        span() noexcept = default;
+
+        span(pointer data, size_type size) noexcept
+            : m_data{ data }
+            , m_size{ size }
+        {
+        }
+
+        pointer data() const noexcept
+        {
+            return m_data;
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        reference operator[](size_type index) const
+        {
+            return m_data[index];
+        }
+
+        iterator begin() const noexcept
+        {
+            return m_data;
+        }
+
+        iterator end() const noexcept
+        {
+            return m_data + m_size;
+        }
+
+    private:
+        pointer m_data = nullptr;
+        size_type m_size = 0;
+    };
+}
+
+#endif //OMEGA_SPAN_HPP
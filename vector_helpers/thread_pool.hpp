@@ -0,0 +1,270 @@
+#ifndef OMEGA_THREAD_POOL_HPP
+#define OMEGA_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace omega
+{
+    // Fork-join pool with one task deque per worker. A worker pushes and
+    // pops at the back of its own deque and steals from the front of the
+    // others when it runs dry. A thread waiting for its tasks keeps running
+    // queued tasks instead of blocking, so tasks may fork again.
+    class thread_pool
+    {
+        static constexpr size_t CACHE_LINE = 64;
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+            unsigned char padding[CACHE_LINE];
+        };
+
+    public:
+        // threads counts the caller: a pool of n starts n - 1 workers and
+        // the thread that calls run() does the rest
+        explicit thread_pool(unsigned threads = std::thread::hardware_concurrency())
+            : m_queues( threads > 1 ? threads - 1 : 1 )
+        {
+            for (auto& q : m_queues)
+            {
+                q.reset(new queue);
+            }
+
+            for (unsigned i = 0; i + 1 < threads; ++i)
+            {
+                m_workers.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator = (const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_sleep_mutex };
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (auto& worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        // Pool with every hardware thread, started on first use
+        static thread_pool& shared()
+        {
+            static thread_pool pool;
+            return pool;
+        }
+
+        // Threads that run tasks, the caller included
+        unsigned size() const noexcept
+        {
+            return static_cast<unsigned>(m_workers.size()) + 1;
+        }
+
+        // Calls body(k) for every k in [0, count) and returns when all calls
+        // are done. The caller runs body(0) itself. If calls throw, the first
+        // exception is rethrown once the others have finished.
+        template<typename Body>
+        void run(size_t count, Body&& body)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (count == 1 || m_workers.empty())
+            {
+                for (size_t k = 0; k < count; ++k)
+                {
+                    body(k);
+                }
+                return;
+            }
+
+            struct join
+            {
+                std::atomic<size_t> remaining;
+                std::mutex mutex;
+                std::exception_ptr error;
+
+                void fail() noexcept
+                {
+                    std::lock_guard<std::mutex> lock{ mutex };
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            } done;
+            done.remaining = count - 1;
+
+            auto call = [&done, &body](size_t k) {
+                try
+                {
+                    body(k);
+                }
+                catch (...)
+                {
+                    done.fail();
+                }
+            };
+
+            // tasks that cannot be queued run here after body(0)
+            const auto self = current_queue();
+            size_t queued = 1;
+            try
+            {
+                for (; queued < count; ++queued)
+                {
+                    auto& target = *m_queues[self < m_queues.size() ? self : queued % m_queues.size()];
+                    std::lock_guard<std::mutex> lock{ target.mutex };
+                    const auto k = queued;
+                    target.tasks.emplace_back([&done, &call, k] {
+                        call(k);
+                        done.remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    });
+                    m_pending.fetch_add(1, std::memory_order_release);
+                }
+            }
+            catch (...)
+            {
+            }
+            {
+                std::lock_guard<std::mutex> lock{ m_sleep_mutex };
+            }
+            m_wake.notify_all();
+
+            call(0);
+            for (auto k = queued; k < count; ++k)
+            {
+                call(k);
+                done.remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+
+            while (done.remaining.load(std::memory_order_acquire) != 0)
+            {
+                std::function<void()> task;
+                if (take(self, task))
+                {
+                    task();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (done.error)
+            {
+                std::rethrow_exception(done.error);
+            }
+        }
+
+    private:
+        static constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+
+        // Queue of the calling worker, or NOT_A_WORKER for other threads
+        size_t current_queue() const noexcept
+        {
+            return owner() == this ? index() : NOT_A_WORKER;
+        }
+
+        static const thread_pool*& owner() noexcept
+        {
+            static thread_local const thread_pool* pool = nullptr;
+            return pool;
+        }
+
+        static size_t& index() noexcept
+        {
+            static thread_local size_t queue = NOT_A_WORKER;
+            return queue;
+        }
+
+        // Pops the newest task of the own queue or steals the oldest of another
+        bool take(size_t self, std::function<void()>& task)
+        {
+            if (m_pending.load(std::memory_order_acquire) == 0)
+            {
+                return false;
+            }
+
+            const auto count = m_queues.size();
+            if (self < count)
+            {
+                auto& own = *m_queues[self];
+                std::lock_guard<std::mutex> lock{ own.mutex };
+                if (!own.tasks.empty())
+                {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    m_pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            const auto start = self < count ? self + 1 : 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto& victim = *m_queues[(start + i) % count];
+                std::lock_guard<std::mutex> lock{ victim.mutex };
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    m_pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void work(size_t self)
+        {
+            owner() = this;
+            index() = self;
+            for (;;)
+            {
+                std::function<void()> task;
+                if (take(self, task))
+                {
+                    task();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{ m_sleep_mutex };
+                m_wake.wait(lock, [this] {
+                    return m_stopping || m_pending.load(std::memory_order_acquire) != 0;
+                });
+                if (m_stopping)
+                {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<size_t> m_pending{ 0 };
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+    };
+}
+
+#endif //OMEGA_THREAD_POOL_HPP
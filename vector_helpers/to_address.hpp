@@ -0,0 +1,22 @@
+#ifndef OMEGA_TO_ADDRESS_HPP
+#define OMEGA_TO_ADDRESS_HPP
+
+namespace omega
+{
+    // Raw address behind an allocator's pointer type: the pointer itself, or
+    // operator-> of a fancy pointer such as an offset pointer. For the calls
+    // that need a T*: allocator_traits::construct/destroy, memcmp, hashing.
+    template<typename T>
+    constexpr T* to_address(T* p) noexcept
+    {
+        return p;
+    }
+
+    template<typename Pointer>
+    auto to_address(const Pointer& p) noexcept -> decltype(to_address(p.operator->()))
+    {
+        return to_address(p.operator->());
+    }
+}
+
+#endif //OMEGA_TO_ADDRESS_HPP
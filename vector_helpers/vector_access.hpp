@@ -0,0 +1,29 @@
+#ifndef OMEGA_VECTOR_ACCESS_HPP
+#define OMEGA_VECTOR_ACCESS_HPP
+
+#include "../vector.hpp"
+#include "vector_helper.hpp"
+
+namespace omega
+{
+    // Lets containers built around omega::vector fill a buffer with
+    // vector_helper themselves and hand it over without copying
+    struct vector_access
+    {
+        template<typename T, typename Allocator>
+        static Allocator& allocator(vector<T, Allocator>& target) noexcept
+        {
+            return target.m_allocator;
+        }
+
+        // target takes the helper's buffer; the helper gets the old one and
+        // frees it when it goes away
+        template<typename T, typename Allocator>
+        static void adopt(vector<T, Allocator>& target, vector_helper<T, Allocator>& source) noexcept
+        {
+            target.swap_data(target, source);
+        }
+    };
+}
+
+#endif //OMEGA_VECTOR_ACCESS_HPP
@@ -1,6 +1,7 @@
 #ifndef OMEGA_VECTOR_HELPER_HPP
 #define OMEGA_VECTOR_HELPER_HPP
 
+#include "to_address.hpp"
 #include <utility>
 #include <memory>
 
@@ -29,30 +30,29 @@ namespace omega
         {
             for (size_type i = 0; i < m_size; ++i)
             {
-                alloc_traits::destroy(m_allocator, &m_data[i]);
+                alloc_traits::destroy(m_allocator, to_address(m_data + i));
             }
 
             m_size = 0;
 
-            alloc_traits::deallocate(m_allocator, m_data, ITEM_SIZE * m_capacity);
+            alloc_traits::deallocate(m_allocator, m_data, m_capacity);
             m_capacity = 0;
         }
 
         void allocate(size_type capacity)
         {
-            m_data = alloc_traits::allocate(m_allocator, ITEM_SIZE * capacity); 
+            m_data = alloc_traits::allocate(m_allocator, capacity); 
             m_capacity = capacity;
         }
 
         template <typename... Args>
         pointer construct(Args&&... args)
         {
-            alloc_traits::construct(m_allocator, &m_data[m_size], std::forward<Args>(args)...); 
+            alloc_traits::construct(m_allocator, to_address(m_data + m_size), std::forward<Args>(args)...);
             ++m_size;
-            return &m_data[m_size - 1];
+            return m_data + (m_size - 1);
         }
 
-        static constexpr size_type ITEM_SIZE = sizeof(T);
         pointer m_data = nullptr;
         size_type m_size = 0;
         size_type m_capacity = 0;
@@ -0,0 +1,547 @@
+#ifndef OMEGA_VIRTUAL_VECTOR_HPP
+#define OMEGA_VIRTUAL_VECTOR_HPP
+
+#include "vector_helpers/random_access_iterator.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace omega
+{
+    // Vector over one range of address space reserved up front with
+    // PROT_NONE. Growing commits the next pages with mprotect, so the data
+    // pointer never changes and growth never invalidates a pointer, reference
+    // or iterator. shrink_to_fit gives the pages past the end back with
+    // madvise(MADV_DONTNEED). size() can never exceed max_size(), which is
+    // fixed by the reservation; a push past it throws std::length_error.
+    //
+    // Reserving address space is free on 64-bit systems, so the default
+    // reservation is 64 GB. Needs mmap, mprotect and madvise.
+    template<typename T>
+    class virtual_vector
+    {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using const_iterator = random_access_iterator<T>;
+        using iterator = random_access_iterator<T, false>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+        static constexpr size_t DEFAULT_RESERVE = sizeof(void*) == 8 ? size_t{ 1 } << 36 : size_t{ 1 } << 30;
+
+        virtual_vector()
+            : virtual_vector( DEFAULT_RESERVE / sizeof(T) )
+        {
+        }
+
+        // Reserves address space for max_elements, rounded up to whole pages
+        explicit virtual_vector(size_type max_elements)
+            : m_reserved{ reservation(max_elements) }
+        {
+            map();
+        }
+
+        virtual_vector(std::initializer_list<T> list, size_type max_elements = DEFAULT_RESERVE / sizeof(T))
+            : virtual_vector( list.begin(), list.end(), max_elements )
+        {
+        }
+
+        template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+        virtual_vector(InputIt first, InputIt last, size_type max_elements = DEFAULT_RESERVE / sizeof(T))
+            : virtual_vector( max_elements )
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        virtual_vector(const virtual_vector& rhs)
+            : virtual_vector( rhs.begin(), rhs.end(), rhs.max_size() )
+        {
+        }
+
+        virtual_vector(virtual_vector&& rhs) noexcept
+            : m_data{ rhs.m_data }
+            , m_size{ rhs.m_size }
+            , m_committed{ rhs.m_committed }
+            , m_reserved{ rhs.m_reserved }
+        {
+            rhs.m_data = nullptr;
+            rhs.m_size = 0;
+            rhs.m_committed = 0;
+        }
+
+        virtual_vector& operator = (const virtual_vector& rhs)
+        {
+            if (this != std::addressof(rhs))
+            {
+                virtual_vector copy{ rhs };
+                swap(copy);
+            }
+
+            return *this;
+        }
+
+        virtual_vector& operator = (virtual_vector&& rhs) noexcept
+        {
+            if (this != std::addressof(rhs))
+            {
+                release();
+                swap(rhs);
+            }
+
+            return *this;
+        }
+
+        virtual_vector& operator = (std::initializer_list<T> list)
+        {
+            assign(list);
+            return *this;
+        }
+
+        ~virtual_vector()
+        {
+            release();
+        }
+
+        template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+        void assign(InputIt first, InputIt last)
+        {
+            clear();
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        void assign(size_type count, const_reference value)
+        {
+            clear();
+            resize(count, value);
+        }
+
+        void assign(std::initializer_list<T> list)
+        {
+            assign(list.begin(), list.end());
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(value_type&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        // value may refer to an element: committing pages never moves them
+        template<typename... Args>
+        reference emplace_back(Args&&... args)
+        {
+            if (m_size == capacity())
+            {
+                commit(m_size + 1);
+            }
+
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+            return m_data[m_size++];
+        }
+
+        void pop_back()
+        {
+            m_data[--m_size].~T();
+        }
+
+        // Inserting appends and rotates the new elements into place, so it
+        // needs no buffer beside the reservation
+        iterator insert(const_iterator pos, const_reference value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, value_type&& value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type count, const_reference value)
+        {
+            const auto index = offset(pos);
+            const auto old_size = m_size;
+            resize(m_size + count, value);
+            std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+            return iterator{ m_data + index };
+        }
+
+        template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            const auto index = offset(pos);
+            const auto old_size = m_size;
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    emplace_back(*first);
+                }
+            }
+            catch (...)
+            {
+                destroy_from(old_size);
+                throw;
+            }
+            std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+            return iterator{ m_data + index };
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> list)
+        {
+            return insert(pos, list.begin(), list.end());
+        }
+
+        template<typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            const auto index = offset(pos);
+            emplace_back(std::forward<Args>(args)...);
+            std::rotate(m_data + index, m_data + m_size - 1, m_data + m_size);
+            return iterator{ m_data + index };
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            const auto index = offset(first);
+            const auto count = static_cast<size_type>(last - first);
+            std::move(m_data + index + count, m_data + m_size, m_data + index);
+            destroy_from(m_size - count);
+            return iterator{ m_data + index };
+        }
+
+        void resize(size_type count)
+        {
+            resize_internal(count);
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            resize_internal(count, value);
+        }
+
+        // Commits pages for new_capacity elements; throws std::length_error
+        // past max_size()
+        void reserve(size_type new_capacity)
+        {
+            commit(new_capacity);
+        }
+
+        // Returns the pages past the last element to the reservation
+        void shrink_to_fit() noexcept
+        {
+            const auto keep = round_up(m_size * sizeof(T));
+            if (keep >= m_committed)
+            {
+                return;
+            }
+
+            const auto tail = reinterpret_cast<char*>(m_data) + keep;
+            madvise(tail, m_committed - keep, MADV_DONTNEED);
+            mprotect(tail, m_committed - keep, PROT_NONE);
+            m_committed = keep;
+        }
+
+        // Keeps the committed pages; shrink_to_fit releases them
+        void clear() noexcept
+        {
+            destroy_from(0);
+        }
+
+        reference operator[](size_type index)
+        {
+            return m_data[index];
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return m_data[index];
+        }
+
+        reference at(size_type index)
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return m_data[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("index out of range");
+            }
+
+            return m_data[index];
+        }
+
+        reference front()
+        {
+            return m_data[0];
+        }
+
+        const_reference front() const
+        {
+            return m_data[0];
+        }
+
+        reference back()
+        {
+            return m_data[m_size - 1];
+        }
+
+        const_reference back() const
+        {
+            return m_data[m_size - 1];
+        }
+
+        // Stays the same for the lifetime of the vector; null only after
+        // it has been moved from
+        pointer data() noexcept
+        {
+            return m_data;
+        }
+
+        const_pointer data() const noexcept
+        {
+            return m_data;
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator{ m_data };
+        }
+
+        iterator end() noexcept
+        {
+            return iterator{ m_data + m_size };
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ m_data };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ m_data + m_size };
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        // Elements that fit in the committed pages
+        size_type capacity() const noexcept
+        {
+            return m_committed / sizeof(T);
+        }
+
+        // Elements that fit in the reservation
+        size_type max_size() const noexcept
+        {
+            return m_reserved / sizeof(T);
+        }
+
+        void swap(virtual_vector& rhs) noexcept
+        {
+            std::swap(m_data, rhs.m_data);
+            std::swap(m_size, rhs.m_size);
+            std::swap(m_committed, rhs.m_committed);
+            std::swap(m_reserved, rhs.m_reserved);
+        }
+
+    private:
+        static size_type page_size() noexcept
+        {
+            static const auto page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+            return page;
+        }
+
+        static size_type round_up(size_type bytes) noexcept
+        {
+            return (bytes + page_size() - 1) & ~(page_size() - 1);
+        }
+
+        static size_type reservation(size_type max_elements)
+        {
+            if (max_elements > static_cast<size_type>(-1) / 2 / sizeof(T))
+            {
+                throw std::length_error("virtual_vector reservation too large");
+            }
+
+            return round_up(max_elements * sizeof(T));
+        }
+
+        void map()
+        {
+            auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+            flags |= MAP_NORESERVE;
+#endif
+            const auto memory = mmap(nullptr, m_reserved ? m_reserved : page_size(), PROT_NONE, flags, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+
+            m_data = static_cast<pointer>(memory);
+        }
+
+        // Commits at least count elements, doubling the committed range so
+        // that push_back makes a logarithmic number of system calls
+        void commit(size_type count)
+        {
+            if (count > max_size())
+            {
+                throw std::length_error("virtual_vector reservation exhausted");
+            }
+
+            const auto bytes = count * sizeof(T);
+            if (bytes <= m_committed)
+            {
+                return;
+            }
+
+            if (!m_data)
+            {
+                map();
+            }
+
+            auto target = m_committed * 2 > bytes ? m_committed * 2 : bytes;
+            target = round_up(target) < m_reserved ? round_up(target) : m_reserved;
+            if (mprotect(reinterpret_cast<char*>(m_data) + m_committed, target - m_committed, PROT_READ | PROT_WRITE))
+            {
+                throw std::bad_alloc{};
+            }
+
+            m_committed = target;
+        }
+
+        template<typename... Args>
+        void resize_internal(size_type count, Args&&... args)
+        {
+            if (count <= m_size)
+            {
+                destroy_from(count);
+                return;
+            }
+
+            commit(count);
+            const auto old_size = m_size;
+            try
+            {
+                while (m_size < count)
+                {
+                    emplace_back(args...);
+                }
+            }
+            catch (...)
+            {
+                destroy_from(old_size);
+                throw;
+            }
+        }
+
+        size_type offset(const_iterator pos) const noexcept
+        {
+            return static_cast<size_type>(pos - cbegin());
+        }
+
+        void destroy_from(size_type index) noexcept
+        {
+            while (m_size > index)
+            {
+                m_data[--m_size].~T();
+            }
+        }
+
+        void release() noexcept
+        {
+            destroy_from(0);
+            if (m_data)
+            {
+                munmap(m_data, m_reserved ? m_reserved : page_size());
+                m_data = nullptr;
+            }
+            m_committed = 0;
+        }
+
+        pointer m_data = nullptr;
+        size_type m_size = 0;
+        size_type m_committed = 0;
+        size_type m_reserved = 0;
+    };
+
+    template<typename T>
+    constexpr size_t virtual_vector<T>::DEFAULT_RESERVE;
+}
+
+#endif //OMEGA_VIRTUAL_VECTOR_HPP